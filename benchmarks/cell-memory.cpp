@@ -0,0 +1,123 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define XLNT_BENCHMARK_MALLINFO2
+#endif
+#endif
+
+#include <helpers/path_helper.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Returns the number of bytes currently allocated on the heap or, where
+// that isn't available, the resident set size of this process. Returns 0
+// if neither can be determined on this platform.
+std::size_t used_memory()
+{
+#if defined(XLNT_BENCHMARK_MALLINFO2)
+    return mallinfo2().uordblks;
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            return std::stoul(line.substr(6)) * 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+std::size_t count_cells(const xlnt::workbook &wb)
+{
+    std::size_t cells = 0;
+
+    for (auto ws : wb)
+    {
+        for (auto row : ws.rows(true))
+        {
+            for (auto cell : row)
+            {
+                (void)cell;
+                ++cells;
+            }
+        }
+    }
+
+    return cells;
+}
+
+// Loads the given file and reports how much memory the loaded
+// workbook occupies per populated cell. The file is read into memory first
+// so that only the workbook itself is measured.
+void run_memory_test(const xlnt::path &file)
+{
+    std::cout << file.string() << "\n\n";
+
+    std::ifstream stream(file.string(), std::ios::binary);
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    const auto before = used_memory();
+
+    xlnt::workbook wb;
+    wb.load(data);
+
+    const auto after = used_memory();
+    const auto cells = count_cells(wb);
+
+    std::cout << cells << " cells\n";
+
+    if (before == 0 || after == 0)
+    {
+        std::cout << "memory use is not available on this platform\n";
+        return;
+    }
+
+    const auto used = after > before ? after - before : 0;
+    std::cout << used / 1024 << " KiB for the loaded workbook\n";
+    std::cout << (cells > 0 ? static_cast<double>(used) / static_cast<double>(cells) : 0.0) << " bytes per cell\n";
+}
+
+} // namespace
+
+int main()
+{
+    run_memory_test(path_helper::benchmark_file("large.xlsx"));
+
+    return 0;
+}
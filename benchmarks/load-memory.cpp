@@ -0,0 +1,136 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <helpers/path_helper.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Returns the value in bytes of the given field of /proc/self/status, or 0
+// where that isn't available.
+std::size_t process_status(const std::string &field)
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, field.size(), field) == 0 && line[field.size()] == ':')
+        {
+            return std::stoul(line.substr(field.size() + 1)) * 1024;
+        }
+    }
+#else
+    (void)field;
+#endif
+    return 0;
+}
+
+// Resets the peak resident set size of this process so that only what follows is
+// measured. Returns false if the platform can't do this.
+bool reset_peak_memory()
+{
+#if defined(__linux__)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.flush();
+
+    return static_cast<bool>(clear_refs);
+#else
+    return false;
+#endif
+}
+
+// Returns the peak resident set size of this process in bytes.
+std::size_t peak_memory()
+{
+#if defined(__linux__)
+    return process_status("VmHWM");
+#elif defined(__APPLE__)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss); // bytes on macOS
+#elif defined(__unix__)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
+
+// Loads the given file and reports the highest resident set size reached during
+// workbook::load next to the resident set size of the loaded workbook, i.e. how
+// much more than the result loading needs at its peak.
+void run_peak_memory_test(const xlnt::path &file)
+{
+    std::cout << file.string() << "\n\n";
+
+    const auto reset = reset_peak_memory();
+    const auto before = process_status("VmRSS");
+
+    xlnt::workbook wb;
+    wb.load(file);
+
+    const auto after = process_status("VmRSS");
+    const auto peak = peak_memory();
+
+    if (before == 0 || peak == 0)
+    {
+        std::cout << "memory use is not available on this platform\n";
+        return;
+    }
+
+    if (!reset)
+    {
+        std::cout << "(the peak includes everything before the load)\n";
+    }
+
+    const auto loaded = after > before ? after - before : 0;
+    const auto peak_during_load = peak > before ? peak - before : 0;
+
+    std::cout << loaded / 1024 << " KiB resident for the loaded workbook\n";
+    std::cout << peak_during_load / 1024 << " KiB resident at the peak of the load\n";
+    std::cout << (loaded > 0 ? static_cast<double>(peak_during_load) / static_cast<double>(loaded) : 0.0)
+              << "x the loaded workbook\n";
+}
+
+} // namespace
+
+int main()
+{
+    run_peak_memory_test(path_helper::benchmark_file("large.xlsx"));
+
+    return 0;
+}
@@ -4,6 +4,8 @@
 // - outputs up to 15 significant figures (excel only serialises numbers up to 15sf)
 
 #include "benchmark/benchmark.h"
+#include <xlnt/utils/numeric.hpp>
+#include <cmath>
 #include <locale>
 #include <random>
 #include <sstream>
@@ -176,6 +178,42 @@ BENCHMARK_F(RandFloats, string_from_double_snprintf_fixed)
     }
 }
 
+// what xlsx_producer.cpp uses now, formats the 15 digits without snprintf
+BENCHMARK_F(RandFloats, string_from_double_number_serialiser)
+(benchmark::State &state)
+{
+    xlnt::detail::number_serialiser ser;
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(
+            ser.serialise(get_rand()));
+    }
+}
+
+BENCHMARK_F(RandFloats, string_from_double_number_serialiser_buffer)
+(benchmark::State &state)
+{
+    xlnt::detail::number_serialiser ser;
+    while (state.KeepRunning())
+    {
+        char buf[32];
+        benchmark::DoNotOptimize(
+            ser.serialise(get_rand(), buf));
+    }
+}
+
+BENCHMARK_F(RandFloats, string_from_integer_number_serialiser_buffer)
+(benchmark::State &state)
+{
+    xlnt::detail::number_serialiser ser;
+    while (state.KeepRunning())
+    {
+        char buf[32];
+        benchmark::DoNotOptimize(
+            ser.serialise(std::floor(get_rand() * 1000), buf));
+    }
+}
+
 // locale names are different between OS's, and std::from_chars is only complete in MSVC
 #ifdef _MSC_VER
 
@@ -4,6 +4,7 @@
 // - handles atleast 15 significant figures (excel only serialises numbers up to 15sf)
 
 #include <benchmark/benchmark.h>
+#include <xlnt/utils/numeric.hpp>
 #include <locale>
 #include <random>
 #include <sstream>
@@ -180,6 +181,20 @@ BENCHMARK_F(RandFloatStrs, double_from_string_strtod_fixed_const_ref)
     }
 }
 
+// what xlsx_consumer.cpp uses now
+// parses the digits itself (Clinger/Eisel-Lemire), strtod is only the fallback for unusual inputs
+BENCHMARK_F(RandFloatStrs, double_from_string_number_serialiser)
+(benchmark::State &state)
+{
+    xlnt::detail::number_serialiser serialiser;
+    while (state.KeepRunning())
+    {
+        const std::string &input = get_rand();
+        benchmark::DoNotOptimize(
+            serialiser.deserialise(input.data(), input.size()));
+    }
+}
+
 // locale names are different between OS's, and std::from_chars is only complete in MSVC
 #ifdef _MSC_VER
 
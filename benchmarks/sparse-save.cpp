@@ -0,0 +1,75 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+using milliseconds_d = std::chrono::duration<double, std::milli>;
+
+// Create a worksheet where a diagonal band of string cells spans a wide
+// and tall dimension, so the populated cells are a tiny fraction of the
+// dimension area. Saving such a sheet should scale with the number of
+// cells rather than with the area.
+void run_sparse_save_test(xlnt::column_t::index_t columns, xlnt::row_t rows, std::size_t cells, int runs = 3)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (std::size_t i = 0; i < cells; ++i)
+    {
+        auto column = static_cast<xlnt::column_t::index_t>(1 + i * (columns - 1) / (cells - 1));
+        auto row = static_cast<xlnt::row_t>(1 + i * (rows - 1) / (cells - 1));
+        ws.cell(xlnt::cell_reference(column, row)).value("string " + std::to_string(i % 100));
+    }
+
+    std::cout << cells << " cells in " << ws.calculate_dimension().to_string() << '\n';
+
+    for (int i = 0; i < runs; ++i)
+    {
+        std::vector<std::uint8_t> data;
+
+        auto start = std::chrono::steady_clock::now();
+        wb.save(data);
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << milliseconds_d(end - start).count() << " ms\n";
+    }
+
+    std::cout << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    run_sparse_save_test(1000, 10000, 1000);
+    run_sparse_save_test(16384, 100000, 10000);
+
+    return 0;
+}
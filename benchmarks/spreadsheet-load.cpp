@@ -5,11 +5,12 @@
 namespace {
 using milliseconds_d = std::chrono::duration<double, std::milli>;
 
-void run_load_test(const xlnt::path &file, int runs = 10)
+void run_load_test(const xlnt::path &file, xlnt::cell_allocation allocation, int runs = 10)
 {
-    std::cout << file.string() << "\n\n";
+    std::cout << file.string()
+              << (allocation == xlnt::cell_allocation::arena ? " (arena)" : " (heap)") << "\n\n";
 
-    xlnt::workbook wb;
+    xlnt::workbook wb(allocation);
     std::vector<std::chrono::steady_clock::duration> test_timings;
 
     for (int i = 0; i < runs; ++i)
@@ -50,8 +51,10 @@ void run_save_test(const xlnt::path &file, int runs = 10)
 
 int main()
 {
-    run_load_test(path_helper::benchmark_file("large.xlsx"));
-    run_load_test(path_helper::benchmark_file("very_large.xlsx"));
+    run_load_test(path_helper::benchmark_file("large.xlsx"), xlnt::cell_allocation::heap);
+    run_load_test(path_helper::benchmark_file("large.xlsx"), xlnt::cell_allocation::arena);
+    run_load_test(path_helper::benchmark_file("very_large.xlsx"), xlnt::cell_allocation::heap);
+    run_load_test(path_helper::benchmark_file("very_large.xlsx"), xlnt::cell_allocation::arena);
 
     run_save_test(path_helper::benchmark_file("large.xlsx"));
     run_save_test(path_helper::benchmark_file("very_large.xlsx"));
@@ -0,0 +1,46 @@
+#include <xlnt/xlnt.hpp>
+#include <chrono>
+#include <helpers/path_helper.hpp>
+
+namespace {
+using milliseconds_d = std::chrono::duration<double, std::milli>;
+using seconds_d = std::chrono::duration<double>;
+
+void run_streaming_test(const xlnt::path &file, int runs = 10)
+{
+    std::cout << file.string() << "\n\n";
+
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(file);
+        std::size_t cells = 0;
+
+        for (const auto &title : reader.sheet_titles())
+        {
+            reader.begin_worksheet(title);
+
+            while (reader.has_cell())
+            {
+                reader.read_cell();
+                ++cells;
+            }
+
+            reader.end_worksheet();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        auto elapsed = end - start;
+
+        std::cout << milliseconds_d(elapsed).count() << " ms, "
+                  << static_cast<std::size_t>(cells / seconds_d(elapsed).count()) << " cells/s\n";
+    }
+}
+} // namespace
+
+int main()
+{
+    run_streaming_test(path_helper::benchmark_file("large.xlsx"));
+}
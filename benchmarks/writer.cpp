@@ -23,6 +23,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <vector>
 
 #include <helpers/timing.hpp>
 #include <xlnt/xlnt.hpp>
@@ -56,6 +57,35 @@ void writer(int cols, int rows)
     wb.save(filename);
 }
 
+// Same as writer but fills each row with a single call to
+// worksheet::append_row instead of one cell at a time.
+void append_writer(int cols, int rows)
+{
+    xlnt::workbook wb;
+    auto ws = wb.create_sheet();
+    std::vector<double> values(static_cast<std::size_t>(cols));
+
+    for (int i = 0; i < cols; i++)
+    {
+        values[static_cast<std::size_t>(i)] = i;
+    }
+
+    for (int index = 0; index < rows; index++)
+    {
+        if (rows >= 10 && (index + 1) % (rows / 10) == 0)
+        {
+            std::string progress = std::string((index + 1) / (1 + rows / 10), '.');
+            std::cout << "\r" << progress;
+        }
+
+        ws.append_row(values);
+    }
+    std::cout << '\n';
+
+    auto filename = "benchmark.xlsx";
+    wb.save(filename);
+}
+
 // Create a timeit call to a function and pass in keyword arguments.
 // The function is called twice, once using the standard workbook, then with the optimised one.
 // Time from the best of three is taken.
@@ -86,5 +116,11 @@ int main()
     timer(&writer, 10, 1000);
     timer(&writer, 1, 10000);
 
+    timer(&append_writer, 10000, 1);
+    timer(&append_writer, 1000, 10);
+    timer(&append_writer, 100, 100);
+    timer(&append_writer, 10, 1000);
+    timer(&append_writer, 1, 10000);
+
     return 0;
 }
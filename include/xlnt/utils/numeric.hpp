@@ -30,6 +30,7 @@
 #include <cstddef>
 #include <limits>
 #include <sstream>
+#include <string>
 #include <type_traits>
 
 #undef min
@@ -106,6 +107,22 @@ bool float_equals(const LNumber &lhs, const RNumber &rhs,
     return ((lhs + scaled_fuzz) >= rhs) && ((rhs + scaled_fuzz) >= lhs);
 }
 
+/// <summary>
+/// Locale independent conversion of the decimal number in [first, last) in the form
+/// [+-]digits[.digits][(e|E)[+-]digits], as written by Excel. Returns a pointer past
+/// the last character consumed, or first if no number could be read (result is then unchanged).
+/// Values with at most 19 significant digits are converted without calling strtod.
+/// </summary>
+XLNT_API const char *parse_number(const char *first, const char *last, double &result);
+
+/// <summary>
+/// Locale independent equivalent of printf("%.15g"), which is how Excel writes numbers.
+/// Writes at most 32 characters (no terminator) starting at first and returns a pointer
+/// past the last character written. Integers and values needing the usual 15 digits
+/// are formatted without calling printf.
+/// </summary>
+XLNT_API char *format_number(double value, char *first);
+
 class number_serialiser
 {
     static constexpr int Excel_Digit_Precision = 15; //sf
@@ -141,13 +158,15 @@ public:
     // This matches the output format of excel irrespective of current locale
     std::string serialise(double d) const
     {
-        char buf[30];
-        int len = snprintf(buf, sizeof(buf), "%.15g", d);
-        if (should_convert_comma)
-        {
-            convert_comma_to_pt(buf, len);
-        }
-        return std::string(buf, static_cast<size_t>(len));
+        char buf[32];
+        return std::string(buf, format_number(d, buf));
+    }
+
+    // as above, but writes into a caller supplied buffer of at least 32 characters
+    // and returns a pointer past the last character written
+    char *serialise(double d, char *buf) const
+    {
+        return format_number(d, buf);
     }
 
     // replacement for std::to_string / s*printf("%f", ...)
@@ -167,26 +186,60 @@ public:
     {
         assert(!s.empty());
         assert(len_converted != nullptr);
+        double d = 0.0;
+        if (parse_number(s.data(), s.data() + s.size(), d) == s.data() + s.size())
+        {
+            *len_converted = static_cast<ptrdiff_t>(s.size());
+            return d;
+        }
+        // anything else strtod accepts (whitespace, hex, inf, ...) or a partial conversion
         char *end_of_convert;
         if (!should_convert_comma)
         {
-            double d = strtod(s.c_str(), &end_of_convert);
+            d = strtod(s.c_str(), &end_of_convert);
             *len_converted = end_of_convert - s.c_str();
             return d;
         }
         char buf[30];
         assert(s.size() < sizeof(buf));
         auto copy_end = std::copy(s.begin(), s.end(), buf);
+        *copy_end = '\0';
         convert_pt_to_comma(buf, static_cast<size_t>(copy_end - buf));
-        double d = strtod(buf, &end_of_convert);
+        d = strtod(buf, &end_of_convert);
         *len_converted = end_of_convert - buf;
         return d;
     }
 
     double deserialise(const std::string &s) const
     {
-        ptrdiff_t ignore;
-        return deserialise(s, &ignore);
+        return deserialise(s.data(), s.size());
+    }
+
+    // for characters which aren't null terminated, e.g. a view into an XML buffer
+    double deserialise(const char *s, std::size_t size) const
+    {
+        double d = 0.0;
+        if (parse_number(s, s + size, d) == s + size)
+        {
+            return d;
+        }
+        char buf[64];
+        if (size >= sizeof(buf))
+        {
+            std::string copy(s, size);
+            if (should_convert_comma)
+            {
+                convert_pt_to_comma(&copy[0], size);
+            }
+            return strtod(copy.c_str(), nullptr);
+        }
+        std::copy(s, s + size, buf);
+        buf[size] = '\0';
+        if (should_convert_comma)
+        {
+            convert_pt_to_comma(buf, size);
+        }
+        return strtod(buf, nullptr);
     }
 };
 
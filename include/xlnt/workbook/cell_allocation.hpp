@@ -0,0 +1,51 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Determines how the cells of a workbook's worksheets are allocated.
+/// </summary>
+enum class XLNT_API cell_allocation
+{
+    /// <summary>
+    /// Cells are pooled per worksheet and their text, formulae and other
+    /// out-of-line data are individually heap allocated and freed as soon as
+    /// they are no longer used.
+    /// </summary>
+    heap,
+
+    /// <summary>
+    /// Cells and their out-of-line data are carved out of a per-worksheet
+    /// arena which is released in one go when the worksheet is removed or the
+    /// workbook is cleared. Memory of removed cells is only reused for new
+    /// cells. This suits workbooks that are loaded, read and discarded.
+    /// </summary>
+    arena
+};
+
+} // namespace xlnt
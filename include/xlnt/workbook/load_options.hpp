@@ -0,0 +1,98 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Options which control how workbook::load reads a file.
+/// </summary>
+class XLNT_API load_options
+{
+public:
+    /// <summary>
+    /// The titles of the worksheets to load. Other worksheets are left out of the
+    /// workbook and titles which aren't in the file are ignored. All worksheets
+    /// are loaded if this is empty, the default.
+    /// </summary>
+    std::vector<std::string> sheets;
+
+    /// <summary>
+    /// If true, cell comments aren't read. They're dropped if the workbook is saved.
+    /// </summary>
+    bool skip_comments = false;
+
+    /// <summary>
+    /// If true, drawings and images, including the thumbnail, aren't read.
+    /// The workbook can't be saved, since the package would be incomplete.
+    /// </summary>
+    bool skip_images = false;
+
+    /// <summary>
+    /// If true, binary parts such as printer settings and VBA projects aren't read.
+    /// The workbook can't be saved, since the package would be incomplete.
+    /// </summary>
+    bool skip_binaries = false;
+
+    /// <summary>
+    /// If true, the stylesheet isn't read and cells have no format. The workbook
+    /// can't be saved and formats can't be created.
+    /// </summary>
+    bool skip_styles = false;
+
+    /// <summary>
+    /// If true, only the cached values of formula cells are read, not the formulae.
+    /// </summary>
+    bool values_only = false;
+
+    /// <summary>
+    /// If true, worksheets are read from the package when they're first accessed
+    /// through workbook::sheet_by_title, sheet_by_index, sheet_by_id, active_sheet
+    /// or iteration, rather than by workbook::load. Files and byte vectors are kept
+    /// by the workbook until then, but a stream passed to workbook::load must outlive
+    /// the workbook. This has no effect on encrypted files.
+    /// Reading a worksheet changes the workbook even through its const accessors,
+    /// so a lazily loaded workbook mustn't be used from several threads at once,
+    /// not even for reading, until every worksheet has been accessed.
+    /// </summary>
+    bool lazy = false;
+
+    /// <summary>
+    /// The number of threads used to decompress and parse worksheets. Each
+    /// worksheet is read by a single thread and the result is the same as
+    /// with a serial load. 1, the default, reads everything on the calling
+    /// thread and 0 uses one thread per hardware thread. This has no effect
+    /// on lazy loads.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+};
+
+} // namespace xlnt
@@ -0,0 +1,94 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// The deflate strategies which can be used to compress a part. Anything but
+/// standard trades compression ratio for speed on typical XML.
+/// </summary>
+enum class XLNT_API compression_strategy
+{
+    standard,
+    filtered,
+    huffman_only,
+    run_length,
+    fixed
+};
+
+/// <summary>
+/// How a part of the file is compressed.
+/// </summary>
+struct XLNT_API compression_settings
+{
+    /// <summary>
+    /// The deflate level from 1, the fastest, to 9, the smallest. 0 stores the
+    /// part without compressing it and -1, the default, uses level 6.
+    /// </summary>
+    int level = -1;
+
+    /// <summary>
+    /// The deflate strategy. This has no effect on stored parts.
+    /// </summary>
+    compression_strategy strategy = compression_strategy::standard;
+};
+
+/// <summary>
+/// Options which control how workbook::save writes a file.
+/// </summary>
+class XLNT_API save_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to serialize and compress worksheets. Each
+    /// worksheet is written by a single thread into memory and the parts are
+    /// added to the file in the usual order, so the file is the same whatever
+    /// the number of threads. 1, the default, writes everything on the calling
+    /// thread and 0 uses one thread per hardware thread.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+
+    /// <summary>
+    /// How parts are compressed unless part_compression says otherwise.
+    /// </summary>
+    compression_settings compression;
+
+    /// <summary>
+    /// Compression for particular parts, keyed either by the name of a part in
+    /// the file, e.g. "xl/worksheets/sheet1.xml", or by an extension including
+    /// the dot, e.g. ".png" to store images as they are. A name takes precedence
+    /// over an extension.
+    /// </summary>
+    std::unordered_map<std::string, compression_settings> part_compression;
+};
+
+} // namespace xlnt
@@ -38,6 +38,7 @@ namespace xlnt {
 
 class cell;
 class cell_reference;
+class save_options;
 class worksheet;
 
 namespace detail {
@@ -104,6 +105,31 @@ public:
     /// </summary>
     void open(std::ostream &stream);
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, compressed according to options,
+    /// and saves the bytes into byte vector data. worksheet_threads has no effect
+    /// on streamed worksheets.
+    /// </summary>
+    void open(std::vector<std::uint8_t> &data, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, compressed according to options,
+    /// and saves the data into a file named filename.
+    /// </summary>
+    void open(const std::string &filename, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, compressed according to options,
+    /// and saves the data into a file named filename.
+    /// </summary>
+    void open(const xlnt::path &filename, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, compressed according to options,
+    /// and saves the data into stream.
+    /// </summary>
+    void open(std::ostream &stream, const save_options &options);
+
     std::unique_ptr<xlnt::detail::xlsx_producer> producer_;
     std::unique_ptr<workbook> workbook_;
     std::unique_ptr<std::ostream> stream_;
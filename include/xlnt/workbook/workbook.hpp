@@ -39,6 +39,7 @@
 namespace xlnt {
 
 enum class calendar;
+enum class cell_allocation;
 enum class core_property;
 enum class extended_property;
 enum class relationship_type;
@@ -52,6 +53,8 @@ class color;
 class const_worksheet_iterator;
 class fill;
 class font;
+class load_options;
+class save_options;
 class format;
 class rich_text;
 class manifest;
@@ -131,6 +134,13 @@ public:
     /// </summary>
     workbook();
 
+    /// <summary>
+    /// Constructs a workbook like the default constructor whose worksheets,
+    /// including those created later or loaded, allocate their cells as given
+    /// by allocation.
+    /// </summary>
+    explicit workbook(xlnt::cell_allocation allocation);
+
     /// <summary>
     /// load the xlsx file at path
     /// </summary>
@@ -409,6 +419,12 @@ public:
     /// </summary>
     void base_date(calendar base_date);
 
+    /// <summary>
+    /// Returns how the cells of this workbook's worksheets are allocated. This
+    /// is chosen when the workbook is constructed and kept by clear() and load().
+    /// </summary>
+    xlnt::cell_allocation cell_allocation() const;
+
     /// <summary>
     /// Returns true if this workbook has had its title set.
     /// </summary>
@@ -529,6 +545,57 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, writing it according to options,
+    /// and saves the bytes into byte vector data.
+    /// </summary>
+    void save(std::vector<std::uint8_t> &data, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, writing it according to options,
+    /// and saves the data into a file named filename.
+    /// </summary>
+    void save(const std::string &filename, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, writing it according to options,
+    /// and saves the data into a file named filename.
+    /// </summary>
+    void save(const xlnt::path &filename, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, writing it according to options,
+    /// and saves the data into stream.
+    /// </summary>
+    void save(std::ostream &stream, const save_options &options) const;
+
+    /// <summary>
+    /// Returns the largest size the XLSX file written by save with the given
+    /// options can have, so that a buffer for it can be allocated once. This
+    /// serializes the whole workbook a second time without compressing it,
+    /// which takes about a third of the time of a save, so it only pays off
+    /// where the buffer can be reused or must not grow.
+    /// </summary>
+    std::size_t save_size_bound(const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, writing it according to options,
+    /// and saves the bytes into the buffer of size bytes starting at data.
+    /// Returns the number of bytes written. Throws xlnt::exception if the file
+    /// doesn't fit, which can't happen if size is at least save_size_bound.
+    /// </summary>
+    std::size_t save(std::uint8_t *data, std::size_t size, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file, writing it according to options,
+    /// straight into the memory mapping of a file named filename. The file is
+    /// created with the size given by save_size_bound and truncated once written,
+    /// or deleted if writing fails. Since that includes save_size_bound's pass
+    /// over the workbook, this is slower than saving to a path, not faster; it's
+    /// for callers which need the file's pages mapped rather than written.
+    /// </summary>
+    void save_mapped(const xlnt::path &filename, const save_options &options) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -591,6 +658,30 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    /// <summary>
+    /// Interprets byte vector data as an XLSX file, reading it according to
+    /// options, and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(const std::vector<std::uint8_t> &data, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file, reading it according
+    /// to options, and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(const std::string &filename, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file, reading it according
+    /// to options, and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(const xlnt::path &filename, const load_options &options);
+
+    /// <summary>
+    /// Interprets data in stream as an XLSX file, reading it according to options,
+    /// and sets the content of this workbook to match that file.
+    /// </summary>
+    void load(std::istream &stream, const load_options &options);
+
     // View
 
     /// <summary>
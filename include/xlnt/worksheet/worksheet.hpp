@@ -33,12 +33,15 @@
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/cell/index_types.hpp>
 #include <xlnt/packaging/relationship.hpp>
+#include <xlnt/utils/optional.hpp>
 #include <xlnt/worksheet/page_margins.hpp>
 #include <xlnt/worksheet/page_setup.hpp>
 #include <xlnt/worksheet/sheet_view.hpp>
 
 namespace xlnt {
 
+enum class cell_allocation;
+
 class cell;
 class cell_reference;
 class cell_vector;
@@ -55,6 +58,7 @@ class range_reference;
 class relationship;
 class row_properties;
 class sheet_format_properties;
+class variant;
 class workbook;
 class phonetic_pr;
 
@@ -122,6 +126,23 @@ public:
     /// </summary>
     void garbage_collect();
 
+    /// <summary>
+    /// Enables or disables automatic garbage collection. While enabled, a cell
+    /// is removed as soon as clearing its value, formula or format, unmerging
+    /// it or hiding its phonetics leaves nothing in it worth keeping, just as
+    /// garbage_collect() would remove it. A handle to the removed cell stays
+    /// usable until the next removal or row or column insertion or deletion,
+    /// and writing a value, formula or format through it before then puts the
+    /// cell straight back.
+    /// Enabling it also collects the cells that are already empty.
+    /// </summary>
+    void auto_garbage_collect(bool enabled);
+
+    /// <summary>
+    /// Returns true if empty cells are removed as soon as they are cleared.
+    /// </summary>
+    bool auto_garbage_collect() const;
+
     // identification
 
     /// <summary>
@@ -130,6 +151,12 @@ public:
     /// </summary>
     std::size_t id() const;
 
+    /// <summary>
+    /// Returns how the cells of this worksheet are allocated, which is chosen
+    /// by the workbook it belongs to.
+    /// </summary>
+    xlnt::cell_allocation cell_allocation() const;
+
     /// <summary>
     /// Set the unique numeric identifier. The id defaults to the lowest unused id in the workbook
     /// so this should not be called without a good reason.
@@ -180,6 +207,17 @@ public:
     /// </summary>
     bool has_cell(const cell_reference &reference) const;
 
+    /// <summary>
+    /// Returns the cell at the given reference if it exists. Unlike cell(), a
+    /// missing cell is not created.
+    /// </summary>
+    optional<class cell> find_cell(const cell_reference &reference);
+
+    /// <summary>
+    /// Returns the cell at the given reference if it exists.
+    /// </summary>
+    optional<const class cell> find_cell(const cell_reference &reference) const;
+
     /// <summary>
     /// Returns the cell at the given reference. If the cell doesn't exist, it
     /// will be initialized to null before being returned.
@@ -290,6 +328,65 @@ public:
     /// </summary>
     void delete_columns(column_t column, std::uint32_t amount);
 
+    /// <summary>
+    /// Writes values to consecutive cells of the row returned by next_row(),
+    /// starting at column A, and returns the index of that row.
+    /// </summary>
+    row_t append_row(const std::vector<double> &values);
+
+    /// <summary>
+    /// Writes values as shared strings to consecutive cells of the row returned
+    /// by next_row(), starting at column A, and returns the index of that row.
+    /// </summary>
+    row_t append_row(const std::vector<std::string> &values);
+
+    /// <summary>
+    /// Writes values to consecutive cells of the row returned by next_row(),
+    /// starting at column A, and returns the index of that row. Null variants
+    /// are skipped.
+    /// </summary>
+    row_t append_row(const std::vector<variant> &values);
+
+    /// <summary>
+    /// Writes a block of rows by columns values, stored in row-major order, to
+    /// the cells starting at top_left. Space for the new cells is reserved up
+    /// front and each row is inserted in one operation.
+    /// </summary>
+    void write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns, const double *values);
+
+    /// <summary>
+    /// Writes a block of rows by columns values, stored in row-major order, to
+    /// the cells starting at top_left as shared strings.
+    /// </summary>
+    void write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns, const std::string *values);
+
+    /// <summary>
+    /// Writes a block of rows by columns values, stored in row-major order, to
+    /// the cells starting at top_left. Cells for null variants are left untouched.
+    /// </summary>
+    void write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns, const variant *values);
+
+    /// <summary>
+    /// Copies the values of the cells in rows first_row through last_row of column
+    /// to out, which must have room for last_row - first_row + 1 values. Empty
+    /// cells and cells whose type does not hold a T are written as missing_value.
+    /// If valid is not null, bit i of it (least significant bit first) is set
+    /// when out[i] came from a cell and cleared otherwise. Returns the number of
+    /// values read from cells. T may be double, int, bool or std::string.
+    /// </summary>
+    template <typename T>
+    std::size_t read_column(column_t column, row_t first_row, row_t last_row,
+        T *out, const T &missing_value, std::uint8_t *valid = nullptr) const;
+
+    /// <summary>
+    /// Copies the values of the cells in range to out in row-major order, which
+    /// must have room for range.width() * range.height() values. Missing values
+    /// and the validity bitmap are handled as in read_column.
+    /// </summary>
+    template <typename T>
+    std::size_t read_block(const range_reference &range, T *out, const T &missing_value,
+        std::uint8_t *valid = nullptr) const;
+
     // properties
 
     /// <summary>
@@ -838,4 +935,36 @@ private:
     detail::worksheet_impl *d_;
 };
 
+template <>
+std::size_t worksheet::read_column<double>(column_t column, row_t first_row, row_t last_row,
+    double *out, const double &missing_value, std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_column<int>(column_t column, row_t first_row, row_t last_row,
+    int *out, const int &missing_value, std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_column<bool>(column_t column, row_t first_row, row_t last_row,
+    bool *out, const bool &missing_value, std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_column<std::string>(column_t column, row_t first_row, row_t last_row,
+    std::string *out, const std::string &missing_value, std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_block<double>(const range_reference &range, double *out, const double &missing_value,
+    std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_block<int>(const range_reference &range, int *out, const int &missing_value,
+    std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_block<bool>(const range_reference &range, bool *out, const bool &missing_value,
+    std::uint8_t *valid) const;
+
+template <>
+std::size_t worksheet::read_block<std::string>(const range_reference &range, std::string *out, const std::string &missing_value,
+    std::uint8_t *valid) const;
+
 } // namespace xlnt
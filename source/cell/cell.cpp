@@ -148,6 +148,17 @@ std::pair<bool, xlnt::time> cast_time(const std::string &s)
     return {true, result};
 }
 
+// Lets the worksheet remove d if the change left it empty or put it back if
+// it was removed and isn't empty anymore. Cells that have already been
+// reclaimed have no parent.
+void cell_changed(xlnt::detail::cell_impl *d)
+{
+    if (d->parent_ != nullptr)
+    {
+        d->parent_->cell_changed(d);
+    }
+}
+
 } // namespace
 
 namespace xlnt {
@@ -210,42 +221,49 @@ void cell::value(bool boolean_value)
 {
     d_->type_ = type::boolean;
     d_->value_numeric_ = boolean_value ? 1.0 : 0.0;
+    cell_changed(d_);
 }
 
 void cell::value(int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
+    cell_changed(d_);
 }
 
 void cell::value(unsigned int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
+    cell_changed(d_);
 }
 
 void cell::value(long long int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
+    cell_changed(d_);
 }
 
 void cell::value(unsigned long long int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
+    cell_changed(d_);
 }
 
 void cell::value(float float_value)
 {
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
+    cell_changed(d_);
 }
 
 void cell::value(double float_value)
 {
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
+    cell_changed(d_);
 }
 
 void cell::value(const std::string &s)
@@ -259,6 +277,7 @@ void cell::value(const rich_text &text)
 
     d_->type_ = type::shared_string;
     d_->value_numeric_ = static_cast<double>(workbook().add_shared_string(text));
+    cell_changed(d_);
 }
 
 void cell::value(const char *c)
@@ -270,10 +289,17 @@ void cell::value(const cell c)
 {
     d_->type_ = c.d_->type_;
     d_->value_numeric_ = c.d_->value_numeric_;
-    d_->value_text_ = c.d_->value_text_;
-    d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
     d_->format_ = c.d_->format_;
+
+    if (c.d_->extension_ || d_->extension_)
+    {
+        auto &extension = d_->extension();
+        extension.value_text_ = c.d_->value_text();
+        extension.hyperlink_ = c.d_->hyperlink();
+        extension.formula_ = c.d_->formula();
+    }
+
+    cell_changed(d_);
 }
 
 void cell::value(const date &d)
@@ -322,6 +348,7 @@ column_t::index_t cell::column_index() const
 void cell::merged(bool merged)
 {
     d_->is_merged_ = merged;
+    cell_changed(d_);
 }
 
 bool cell::is_merged() const
@@ -337,6 +364,7 @@ bool cell::phonetics_visible() const
 void cell::show_phonetics(bool phonetics)
 {
     d_->phonetics_visible_ = phonetics;
+    cell_changed(d_);
 }
 
 bool cell::is_date() const
@@ -365,7 +393,12 @@ cell &cell::operator=(const cell &rhs) = default;
 
 hyperlink cell::hyperlink() const
 {
-    return xlnt::hyperlink(&d_->hyperlink_.get());
+    if (!has_hyperlink())
+    {
+        throw invalid_attribute();
+    }
+
+    return xlnt::hyperlink(&d_->extension_->hyperlink_.get());
 }
 
 void cell::hyperlink(const std::string &url, const std::string &display)
@@ -378,7 +411,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
     auto ws = worksheet();
     auto &manifest = ws.workbook().manifest();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
+    d_->extension().hyperlink_ = detail::hyperlink_impl();
 
     // check for existing relationships
     auto relationships = manifest.relationships(ws.path(), relationship_type::hyperlink);
@@ -386,7 +419,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
         [&url](xlnt::relationship rel) { return rel.target().path().string() == url; });
     if (relation != relationships.end())
     {
-        d_->hyperlink_.get().relationship = *relation;
+        d_->extension_->hyperlink_.get().relationship = *relation;
     }
     else
     { // register a new relationship
@@ -396,18 +429,20 @@ void cell::hyperlink(const std::string &url, const std::string &display)
             uri(url),
             target_mode::external);
         // TODO: make manifest::register_relationship return the created relationship instead of rel id
-        d_->hyperlink_.get().relationship = manifest.relationship(ws.path(), rel_id);
+        d_->extension_->hyperlink_.get().relationship = manifest.relationship(ws.path(), rel_id);
     }
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        d_->extension_->hyperlink_.get().display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? url : display);
+        d_->extension_->hyperlink_.get().display.set(display.empty() ? url : display);
         value(hyperlink().display());
     }
+
+    cell_changed(d_);
 }
 
 void cell::hyperlink(xlnt::cell target, const std::string &display)
@@ -415,19 +450,21 @@ void cell::hyperlink(xlnt::cell target, const std::string &display)
     // TODO: should this computed value be a method on a cell?
     const auto cell_address = target.worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
-    d_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
+    d_->extension().hyperlink_ = detail::hyperlink_impl();
+    d_->extension_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(cell_address), target_mode::internal);
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        d_->extension_->hyperlink_.get().display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? cell_address : display);
+        d_->extension_->hyperlink_.get().display.set(display.empty() ? cell_address : display);
         value(hyperlink().display());
     }
+
+    cell_changed(d_);
 }
 
 void cell::hyperlink(xlnt::range target, const std::string &display)
@@ -435,20 +472,22 @@ void cell::hyperlink(xlnt::range target, const std::string &display)
     // TODO: should this computed value be a method on a cell?
     const auto range_address = target.target_worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
-    d_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
+    d_->extension().hyperlink_ = detail::hyperlink_impl();
+    d_->extension_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(range_address), target_mode::internal);
 
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        d_->extension_->hyperlink_.get().display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? range_address : display);
+        d_->extension_->hyperlink_.get().display.set(display.empty() ? range_address : display);
         value(hyperlink().display());
     }
+
+    cell_changed(d_);
 }
 
 void cell::formula(const std::string &formula)
@@ -460,32 +499,34 @@ void cell::formula(const std::string &formula)
 
     if (formula[0] == '=')
     {
-        d_->formula_ = formula.substr(1);
+        d_->extension().formula_ = formula.substr(1);
     }
     else
     {
-        d_->formula_ = formula;
+        d_->extension().formula_ = formula;
     }
 
     worksheet().register_calc_chain_in_manifest();
+    cell_changed(d_);
 }
 
 bool cell::has_formula() const
 {
-    return d_->formula_.is_set();
+    return d_->formula().is_set();
 }
 
 std::string cell::formula() const
 {
-    return d_->formula_.get();
+    return d_->formula().get();
 }
 
 void cell::clear_formula()
 {
     if (has_formula())
     {
-        d_->formula_.clear();
+        d_->extension_->formula_.clear();
         worksheet().garbage_collect_formulae();
+        cell_changed(d_);
     }
 }
 
@@ -505,8 +546,9 @@ void cell::error(const std::string &error)
         throw invalid_data_type();
     }
 
-    d_->value_text_.plain_text(error, false);
+    d_->extension().value_text_.plain_text(error, false);
     d_->type_ = type::error;
+    cell_changed(d_);
 }
 
 cell cell::offset(int column, int row)
@@ -561,6 +603,7 @@ cell::type cell::data_type() const
 void cell::data_type(type t)
 {
     d_->type_ = t;
+    cell_changed(d_);
 }
 
 number_format cell::computed_number_format() const
@@ -596,9 +639,13 @@ protection cell::computed_protection() const
 void cell::clear_value()
 {
     d_->value_numeric_ = 0;
-    d_->value_text_.clear();
+    if (d_->extension_)
+    {
+        d_->extension_->value_text_.clear();
+    }
     d_->type_ = cell::type::empty;
     clear_formula();
+    cell_changed(d_);
 }
 
 template <>
@@ -717,7 +764,7 @@ XLNT_API rich_text cell::value() const
         return workbook().shared_strings(static_cast<std::size_t>(d_->value_numeric_));
     }
 
-    return d_->value_text_;
+    return d_->value_text();
 }
 
 bool cell::has_value() const
@@ -750,7 +797,7 @@ std::string cell::to_string() const
 
 bool cell::has_format() const
 {
-    return d_->format_.is_set();
+    return d_->format_ != nullptr;
 }
 
 void cell::format(const class format new_format)
@@ -762,6 +809,7 @@ void cell::format(const class format new_format)
 
     ++new_format.d_->references;
     d_->format_ = new_format.d_;
+    cell_changed(d_);
 }
 
 calendar cell::base_date() const
@@ -838,10 +886,11 @@ void cell::value(const std::string &value_string, bool infer_type)
 
 void cell::clear_format()
 {
-    if (d_->format_.is_set())
+    if (d_->format_ != nullptr)
     {
         format().d_->references -= format().d_->references > 0 ? 1 : 0;
-        d_->format_.clear();
+        d_->format_ = nullptr;
+        cell_changed(d_);
     }
 }
 
@@ -899,22 +948,22 @@ bool cell::has_style() const
 
 format cell::modifiable_format()
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 const format cell::format() const
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 alignment cell::alignment() const
@@ -949,14 +998,14 @@ protection cell::protection() const
 
 bool cell::has_hyperlink() const
 {
-    return d_->hyperlink_.is_set();
+    return d_->hyperlink().is_set();
 }
 
 // comment
 
 bool cell::has_comment()
 {
-    return d_->comment_.is_set();
+    return d_->comment().is_set();
 }
 
 void cell::clear_comment()
@@ -964,7 +1013,7 @@ void cell::clear_comment()
     if (has_comment())
     {
         d_->parent_->comments_.erase(reference().to_string());
-        d_->comment_.clear();
+        d_->extension_->comment_.clear();
     }
 }
 
@@ -975,7 +1024,7 @@ class comment cell::comment()
         throw xlnt::exception("cell has no comment");
     }
 
-    return *d_->comment_.get();
+    return *d_->comment().get();
 }
 
 void cell::comment(const std::string &text, const std::string &author)
@@ -992,12 +1041,12 @@ void cell::comment(const class comment &new_comment)
 {
     if (has_comment())
     {
-        *d_->comment_.get() = new_comment;
+        *d_->comment().get() = new_comment;
     }
     else
     {
         d_->parent_->comments_[reference().to_string()] = new_comment;
-        d_->comment_.set(&d_->parent_->comments_[reference().to_string()]);
+        d_->extension().comment_.set(&d_->parent_->comments_[reference().to_string()]);
     }
 
     // offset comment 5 pixels down and 5 pixels right of the top right corner of the cell
@@ -1005,7 +1054,7 @@ void cell::comment(const class comment &new_comment)
     cell_position.first += static_cast<int>(width()) + 5;
     cell_position.second += 5;
 
-    d_->comment_.get()->position(cell_position.first, cell_position.second);
+    d_->comment().get()->position(cell_position.first, cell_position.second);
 
     worksheet().register_comments_in_manifest();
 }
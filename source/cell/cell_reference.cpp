@@ -29,6 +29,7 @@
 #include <xlnt/worksheet/range_reference.hpp>
 
 #include <detail/constants.hpp>
+#include <detail/reference_format.hpp>
 
 namespace xlnt {
 
@@ -82,23 +83,8 @@ range_reference cell_reference::operator,(const xlnt::cell_reference &other) con
 
 std::string cell_reference::to_string() const
 {
-    std::string string_representation;
-
-    if (absolute_column_)
-    {
-        string_representation.append("$");
-    }
-
-    string_representation.append(column_.column_string());
-
-    if (absolute_row_)
-    {
-        string_representation.append("$");
-    }
-
-    string_representation.append(std::to_string(row_));
-
-    return string_representation;
+    char buffer[detail::max_reference_size];
+    return std::string(buffer, detail::format_reference(*this, buffer));
 }
 
 range_reference cell_reference::to_range() const
@@ -345,6 +345,8 @@ void xlsx_consumer::read(std::istream &source, const std::string &password)
     const auto decrypted = decrypt_xlsx(data, password);
     vector_istreambuf decrypted_buffer(decrypted);
     std::istream decrypted_stream(&decrypted_buffer);
+    // the decrypted package only exists until this returns, so nothing can be deferred
+    options_.lazy = false;
     read(decrypted_stream);
 }
 
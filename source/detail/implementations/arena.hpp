@@ -0,0 +1,107 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A monotonic allocator. Memory is handed out from large chunks by bumping
+/// a pointer and is only returned, all at once, by release() or when the
+/// arena is destroyed. Objects placed in it must be destroyed by their owner.
+/// </summary>
+class arena
+{
+public:
+    arena() = default;
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    /// <summary>
+    /// Returns size bytes of uninitialized memory aligned to alignment, which
+    /// must be a power of two no greater than that of std::max_align_t.
+    /// </summary>
+    void *allocate(std::size_t size, std::size_t alignment)
+    {
+        auto offset = (used_ + alignment - 1) & ~(alignment - 1);
+
+        if (chunks_.empty() || offset + size > chunk_size_)
+        {
+            add_chunk(size);
+            offset = 0;
+        }
+
+        used_ = offset + size;
+
+        return chunks_.back().get() + offset;
+    }
+
+    /// <summary>
+    /// Frees every chunk of the arena.
+    /// </summary>
+    void release()
+    {
+        chunks_.clear();
+        chunk_size_ = 0;
+        used_ = 0;
+        reserved_ = 0;
+    }
+
+    /// <summary>
+    /// Returns the number of bytes held by the arena's chunks.
+    /// </summary>
+    std::size_t reserved() const
+    {
+        return reserved_;
+    }
+
+private:
+    static const std::size_t first_chunk_size = 16 * 1024;
+    static const std::size_t max_chunk_size = 1024 * 1024;
+
+    void add_chunk(std::size_t minimum)
+    {
+        auto size = chunks_.empty() ? first_chunk_size : chunk_size_ * 2;
+        size = size < max_chunk_size ? size : max_chunk_size;
+        size = std::max(size, minimum);
+
+        chunks_.emplace_back(new char[size]);
+        chunk_size_ = size;
+        used_ = 0;
+        reserved_ += size;
+    }
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    std::size_t chunk_size_ = 0;
+    std::size_t used_ = 0;
+    std::size_t reserved_ = 0;
+};
+
+} // namespace detail
+} // namespace xlnt
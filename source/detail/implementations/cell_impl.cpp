@@ -25,19 +25,134 @@
 #include <xlnt/worksheet/worksheet.hpp>
 
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
+
+namespace {
+
+// Copies are always heap allocated since the copied cell may belong to
+// another worksheet than the original.
+xlnt::detail::cell_extension *copy_extension(const xlnt::detail::cell_extension *extension)
+{
+    if (extension == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto copy = new xlnt::detail::cell_extension(*extension);
+    copy->in_arena_ = false;
+
+    return copy;
+}
+
+} // namespace
 
 namespace xlnt {
 namespace detail {
 
+void cell_extension_deleter::operator()(cell_extension *extension) const
+{
+    if (extension->in_arena_)
+    {
+        extension->~cell_extension();
+    }
+    else
+    {
+        delete extension;
+    }
+}
+
 cell_impl::cell_impl()
-    : type_(cell_type::empty),
-      parent_(nullptr),
+    : parent_(nullptr),
+      value_numeric_(0),
+      format_(nullptr),
       column_(1),
       row_(1),
+      type_(cell_type::empty),
       is_merged_(false),
-      phonetics_visible_(false),
-      value_numeric_(0)
+      phonetics_visible_(false)
+{
+}
+
+cell_impl::cell_impl(const cell_impl &other)
+    : parent_(other.parent_),
+      value_numeric_(other.value_numeric_),
+      format_(other.format_),
+      extension_(copy_extension(other.extension_.get())),
+      column_(other.column_),
+      row_(other.row_),
+      type_(other.type_),
+      is_merged_(other.is_merged_),
+      phonetics_visible_(other.phonetics_visible_)
+{
+}
+
+cell_impl &cell_impl::operator=(const cell_impl &other)
+{
+    if (this != &other)
+    {
+        parent_ = other.parent_;
+        value_numeric_ = other.value_numeric_;
+        format_ = other.format_;
+        extension_.reset(copy_extension(other.extension_.get()));
+        column_ = other.column_;
+        row_ = other.row_;
+        type_ = other.type_;
+        is_merged_ = other.is_merged_;
+        phonetics_visible_ = other.phonetics_visible_;
+    }
+
+    return *this;
+}
+
+cell_extension &cell_impl::extension()
+{
+    if (!extension_)
+    {
+        extension_.reset(parent_ != nullptr ? parent_->cells_.create_extension() : new cell_extension());
+    }
+
+    return *extension_;
+}
+
+void cell_impl::clear()
+{
+    value_numeric_ = 0;
+    format_ = nullptr;
+    type_ = cell_type::empty;
+    is_merged_ = false;
+    phonetics_visible_ = false;
+
+    if (extension_)
+    {
+        extension_->value_text_.clear();
+        extension_->formula_.clear();
+        extension_->hyperlink_.clear();
+        extension_->comment_.clear();
+    }
+}
+
+const rich_text &cell_impl::value_text() const
+{
+    static const rich_text empty;
+    return extension_ ? extension_->value_text_ : empty;
+}
+
+const optional<std::string> &cell_impl::formula() const
+{
+    static const optional<std::string> empty;
+    return extension_ ? extension_->formula_ : empty;
+}
+
+const optional<hyperlink_impl> &cell_impl::hyperlink() const
+{
+    static const optional<hyperlink_impl> empty;
+    return extension_ ? extension_->hyperlink_ : empty;
+}
+
+const optional<xlnt::comment *> &cell_impl::comment() const
 {
+    static const optional<xlnt::comment *> empty;
+    return extension_ ? extension_->comment_ : empty;
 }
 
 } // namespace detail
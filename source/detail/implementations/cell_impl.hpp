@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 #include <xlnt/cell/cell_type.hpp>
@@ -40,35 +41,81 @@ namespace detail {
 
 struct worksheet_impl;
 
+/// <summary>
+/// The parts of a cell that most cells never use. These are only allocated
+/// once one of them is written so that number and shared string cells,
+/// which make up the bulk of a typical sheet, stay small.
+/// </summary>
+struct cell_extension
+{
+    rich_text value_text_;
+
+    optional<std::string> formula_;
+    optional<hyperlink_impl> hyperlink_;
+    optional<comment *> comment_;
+
+    // true when this lives in a worksheet's arena rather than on the heap
+    bool in_arena_ = false;
+};
+
+/// <summary>
+/// Destroys a cell_extension, freeing its memory unless it belongs to an arena.
+/// </summary>
+struct cell_extension_deleter
+{
+    void operator()(cell_extension *extension) const;
+};
+
 struct cell_impl
 {
     cell_impl();
-    cell_impl(const cell_impl &other) = default;
+    cell_impl(const cell_impl &other);
     cell_impl(cell_impl &&other) = default;
-    cell_impl &operator=(const cell_impl &other) = default;
+    cell_impl &operator=(const cell_impl &other);
     cell_impl &operator=(cell_impl &&other) = default;
 
-    cell_type type_;
+    /// <summary>
+    /// Returns the out-of-line fields of this cell, allocating them first if
+    /// needed from the parent worksheet's cell store.
+    /// </summary>
+    cell_extension &extension();
+
+    /// <summary>
+    /// Empties the cell, keeping its parent, position and extension (if any)
+    /// so that the next string or formula written to it doesn't allocate another.
+    /// </summary>
+    void clear();
+
+    /// <summary>
+    /// Read-only views of the out-of-line fields. These never allocate and
+    /// return empty values if the cell has no extension.
+    /// </summary>
+    const rich_text &value_text() const;
+    const optional<std::string> &formula() const;
+    const optional<hyperlink_impl> &hyperlink() const;
+    const optional<xlnt::comment *> &comment() const;
 
     worksheet_impl *parent_;
 
+    double value_numeric_;
+
+    // nullptr when the cell has no format
+    format_impl *format_;
+
+    std::unique_ptr<cell_extension, cell_extension_deleter> extension_;
+
     column_t column_;
     row_t row_;
 
+    cell_type type_;
+
     bool is_merged_;
     bool phonetics_visible_;
 
-    rich_text value_text_;
-    double value_numeric_;
-
-    optional<std::string> formula_;
-    optional<hyperlink_impl> hyperlink_;
-    optional<format_impl *> format_;
-    optional<comment *> comment_;
-
     bool is_garbage_collectible() const
     {
-        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || formula_.is_set() || format_.is_set() || hyperlink_.is_set());
+        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || format_ != nullptr
+            || (extension_ && (extension_->formula_.is_set() || extension_->hyperlink_.is_set())));
     }
 };
 
@@ -80,12 +127,12 @@ inline bool operator==(const cell_impl &lhs, const cell_impl &rhs)
         && lhs.row_ == rhs.row_
         && lhs.is_merged_ == rhs.is_merged_
         && lhs.phonetics_visible_ == rhs.phonetics_visible_
-        && lhs.value_text_ == rhs.value_text_
+        && lhs.value_text() == rhs.value_text()
         && float_equals(lhs.value_numeric_, rhs.value_numeric_)
-        && lhs.formula_ == rhs.formula_
-        && lhs.hyperlink_ == rhs.hyperlink_
-        && (lhs.format_.is_set() == rhs.format_.is_set() && (!lhs.format_.is_set() || *lhs.format_.get() == *rhs.format_.get()))
-        && (lhs.comment_.is_set() == rhs.comment_.is_set() && (!lhs.comment_.is_set() || *lhs.comment_.get() == *rhs.comment_.get()));
+        && lhs.formula() == rhs.formula()
+        && lhs.hyperlink() == rhs.hyperlink()
+        && ((lhs.format_ == nullptr) == (rhs.format_ == nullptr) && (lhs.format_ == nullptr || *lhs.format_ == *rhs.format_))
+        && (lhs.comment().is_set() == rhs.comment().is_set() && (!lhs.comment().is_set() || *lhs.comment().get() == *rhs.comment().get()));
 }
 
 } // namespace detail
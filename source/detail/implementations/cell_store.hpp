@@ -0,0 +1,993 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/workbook/cell_allocation.hpp>
+#include <detail/implementations/arena.hpp>
+#include <detail/implementations/cell_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The populated cells of a single worksheet row, kept sorted by column.
+/// </summary>
+struct cell_row
+{
+    explicit cell_row(row_t index)
+        : index_(index)
+    {
+    }
+
+    /// <summary>
+    /// Returns the position of the cell in the given column or size() if there is none.
+    /// Rows without gaps are indexed directly, others are binary searched.
+    /// </summary>
+    std::size_t find(column_t::index_t column) const
+    {
+        if (columns_.empty() || column < columns_.front() || column > columns_.back())
+        {
+            return columns_.size();
+        }
+
+        if (columns_.back() - columns_.front() + 1 == columns_.size())
+        {
+            return column - columns_.front();
+        }
+
+        auto match = std::lower_bound(columns_.begin(), columns_.end(), column);
+        return *match == column ? static_cast<std::size_t>(match - columns_.begin()) : columns_.size();
+    }
+
+    /// <summary>
+    /// Returns the position of the first cell at or after the given column.
+    /// </summary>
+    std::size_t lower_bound(column_t::index_t column) const
+    {
+        if (columns_.empty() || column > columns_.back())
+        {
+            return columns_.size();
+        }
+
+        return static_cast<std::size_t>(std::lower_bound(columns_.begin(), columns_.end(), column) - columns_.begin());
+    }
+
+    std::size_t size() const
+    {
+        return columns_.size();
+    }
+
+    row_t index_;
+    std::vector<column_t::index_t> columns_;
+    std::vector<cell_impl *> cells_;
+};
+
+/// <summary>
+/// Row-major storage for the cells of a worksheet. Rows are kept sorted and
+/// never empty, so walking the store visits cells in sheet order. The
+/// cell_impls themselves live in fixed blocks which are never moved, so
+/// pointers held by xlnt::cell stay valid while other cells are added.
+/// </summary>
+class cell_store
+{
+public:
+    template <bool is_const>
+    class basic_iterator
+    {
+    public:
+        using rows_type = typename std::conditional<is_const, const std::vector<cell_row>, std::vector<cell_row>>::type;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cell_impl;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<is_const, const cell_impl *, cell_impl *>::type;
+        using reference = typename std::conditional<is_const, const cell_impl &, cell_impl &>::type;
+
+        basic_iterator(rows_type *rows, std::size_t row, std::size_t column)
+            : rows_(rows),
+              row_(row),
+              column_(column)
+        {
+        }
+
+        reference operator*() const
+        {
+            return *(*rows_)[row_].cells_[column_];
+        }
+
+        pointer operator->() const
+        {
+            return (*rows_)[row_].cells_[column_];
+        }
+
+        basic_iterator &operator++()
+        {
+            if (++column_ == (*rows_)[row_].size())
+            {
+                ++row_;
+                column_ = 0;
+            }
+
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+
+            return old;
+        }
+
+        bool operator==(const basic_iterator &other) const
+        {
+            return row_ == other.row_ && column_ == other.column_;
+        }
+
+        bool operator!=(const basic_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        rows_type *rows_;
+        std::size_t row_;
+        std::size_t column_;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    cell_store() = default;
+
+    cell_store(const cell_store &other)
+    {
+        *this = other;
+    }
+
+    ~cell_store()
+    {
+        destroy_blocks();
+    }
+
+    cell_store &operator=(const cell_store &other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        allocation(other.allocation());
+        reserve(other.size_);
+        rows_.reserve(other.rows_.size());
+
+        for (const auto &other_row : other.rows_)
+        {
+            rows_.emplace_back(other_row.index_);
+            auto &row = rows_.back();
+            row.columns_ = other_row.columns_;
+            row.cells_.reserve(other_row.size());
+
+            for (auto other_cell : other_row.cells_)
+            {
+                auto cell = allocate();
+                *cell = *other_cell;
+                row.cells_.push_back(cell);
+            }
+        }
+
+        size_ = other.size_;
+        min_column_ = other.min_column_;
+        max_column_ = other.max_column_;
+        column_bounds_valid_ = other.column_bounds_valid_;
+
+        return *this;
+    }
+
+    bool operator==(const cell_store &other) const
+    {
+        if (size_ != other.size_ || rows_.size() != other.rows_.size())
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < rows_.size(); ++i)
+        {
+            const auto &row = rows_[i];
+            const auto &other_row = other.rows_[i];
+
+            if (row.index_ != other_row.index_ || row.columns_ != other_row.columns_)
+            {
+                return false;
+            }
+
+            for (std::size_t j = 0; j < row.size(); ++j)
+            {
+                if (!(*row.cells_[j] == *other_row.cells_[j]))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    iterator begin()
+    {
+        return iterator(&rows_, 0, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(&rows_, rows_.size(), 0);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(&rows_, 0, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(&rows_, rows_.size(), 0);
+    }
+
+    /// <summary>
+    /// The non-empty rows of the store in ascending order.
+    /// </summary>
+    const std::vector<cell_row> &rows() const
+    {
+        return rows_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// <summary>
+    /// Returns the lowest column containing a cell. The store must not be empty.
+    /// </summary>
+    column_t::index_t min_column() const
+    {
+        update_column_bounds();
+        return min_column_;
+    }
+
+    /// <summary>
+    /// Returns the highest column containing a cell. The store must not be empty.
+    /// </summary>
+    column_t::index_t max_column() const
+    {
+        update_column_bounds();
+        return max_column_;
+    }
+
+    /// <summary>
+    /// Returns the row with the given index or nullptr if it has no cells.
+    /// </summary>
+    const cell_row *find_row(row_t row) const
+    {
+        auto position = row_position(row);
+        return position < rows_.size() && rows_[position].index_ == row ? &rows_[position] : nullptr;
+    }
+
+    /// <summary>
+    /// Returns an iterator to the first row with cells at or after the given index.
+    /// </summary>
+    std::vector<cell_row>::const_iterator row_lower_bound(row_t row) const
+    {
+        return rows_.begin() + static_cast<std::ptrdiff_t>(row_position(row));
+    }
+
+    cell_impl *find(column_t::index_t column, row_t row)
+    {
+        return const_cast<cell_impl *>(static_cast<const cell_store *>(this)->find(column, row));
+    }
+
+    const cell_impl *find(column_t::index_t column, row_t row) const
+    {
+        auto match = find_row(row);
+
+        if (match == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto position = match->find(column);
+        return position < match->size() ? match->cells_[position] : nullptr;
+    }
+
+    /// <summary>
+    /// Returns the cell at the given position, creating a default one first if
+    /// needed. The second member of the result is true if a cell was created.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(column_t::index_t column, row_t row)
+    {
+        auto row_index = row_position(row);
+
+        if (row_index == rows_.size() || rows_[row_index].index_ != row)
+        {
+            insert_row(row_index, row);
+        }
+
+        auto &target = rows_[row_index];
+        auto position = target.lower_bound(column);
+
+        if (position < target.size() && target.columns_[position] == column)
+        {
+            return {target.cells_[position], false};
+        }
+
+        auto cell = create(column, row);
+
+        target.columns_.insert(target.columns_.begin() + static_cast<std::ptrdiff_t>(position), column);
+        target.cells_.insert(target.cells_.begin() + static_cast<std::ptrdiff_t>(position), cell);
+        cells_added(1, column, column);
+
+        return {cell, true};
+    }
+
+    /// <summary>
+    /// Stores in cells the count cells of row starting at first_column,
+    /// creating any that don't exist. If none of them exist yet, they are
+    /// inserted into the row in a single operation.
+    /// </summary>
+    void emplace_range(column_t::index_t first_column, row_t row, std::size_t count, cell_impl **cells)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto row_index = row_position(row);
+
+        if (row_index == rows_.size() || rows_[row_index].index_ != row)
+        {
+            insert_row(row_index, row);
+        }
+
+        auto &target = rows_[row_index];
+        auto position = target.lower_bound(first_column);
+        auto last_column = static_cast<column_t::index_t>(first_column + count - 1);
+
+        if (position < target.size() && target.columns_[position] <= last_column)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                cells[i] = emplace(static_cast<column_t::index_t>(first_column + i), row).first;
+            }
+
+            return;
+        }
+
+        auto offset = static_cast<std::ptrdiff_t>(position);
+        target.columns_.insert(target.columns_.begin() + offset, count, column_t::index_t(0));
+        target.cells_.insert(target.cells_.begin() + offset, count, nullptr);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto column = static_cast<column_t::index_t>(first_column + i);
+            auto cell = create(column, row);
+
+            target.columns_[position + i] = column;
+            target.cells_[position + i] = cell;
+            cells[i] = cell;
+        }
+
+        cells_added(count, first_column, last_column);
+    }
+
+    /// <summary>
+    /// Removes the cell at the given position if there is one.
+    /// </summary>
+    void erase(column_t::index_t column, row_t row)
+    {
+        reclaim_detached();
+
+        auto row_index = row_position(row);
+
+        if (row_index == rows_.size() || rows_[row_index].index_ != row)
+        {
+            return;
+        }
+
+        auto position = rows_[row_index].find(column);
+
+        if (position < rows_[row_index].size())
+        {
+            release(unlink(row_index, position));
+        }
+    }
+
+    /// <summary>
+    /// Removes cell from the store like erase() but leaves its slot alone, so
+    /// handles to it stay usable. Emplacing its position or reattach() brings
+    /// the same slot back. Otherwise the next removal or shift reclaims the
+    /// slot, or puts the cell back if something was written to it anyway.
+    /// </summary>
+    void detach(cell_impl *cell)
+    {
+        auto row_index = row_position(cell->row_);
+
+        if (row_index == rows_.size() || rows_[row_index].index_ != cell->row_)
+        {
+            return;
+        }
+
+        auto position = rows_[row_index].find(cell->column_.index);
+
+        if (position < rows_[row_index].size() && rows_[row_index].cells_[position] == cell)
+        {
+            unlink(row_index, position);
+            detached_[position_key(cell->column_.index, cell->row_)] = cell;
+        }
+    }
+
+    /// <summary>
+    /// Puts cell back in the store if it was detached and is still waiting to
+    /// be reclaimed. Does nothing otherwise.
+    /// </summary>
+    void reattach(cell_impl *cell)
+    {
+        if (detached_.empty())
+        {
+            return;
+        }
+
+        auto match = detached_.find(position_key(cell->column_.index, cell->row_));
+
+        if (match != detached_.end() && match->second == cell)
+        {
+            detached_.erase(match);
+            attach(cell);
+        }
+    }
+
+    /// <summary>
+    /// Releases the slots of detached cells which are still empty and puts
+    /// the others back in the store.
+    /// </summary>
+    void reclaim_detached()
+    {
+        if (detached_.empty())
+        {
+            return;
+        }
+
+        auto detached = std::move(detached_);
+        detached_.clear();
+
+        for (const auto &entry : detached)
+        {
+            auto cell = entry.second;
+
+            if (cell->is_garbage_collectible())
+            {
+                release(cell);
+                continue;
+            }
+
+            attach(cell);
+        }
+    }
+
+    /// <summary>
+    /// Removes every cell in the given row.
+    /// </summary>
+    void erase_row(row_t row)
+    {
+        reclaim_detached();
+
+        auto row_index = row_position(row);
+
+        if (row_index == rows_.size() || rows_[row_index].index_ != row)
+        {
+            return;
+        }
+
+        for (auto cell : rows_[row_index].cells_)
+        {
+            release(cell);
+        }
+
+        auto &target = rows_[row_index];
+
+        if (target.columns_.front() == min_column_ || target.columns_.back() == max_column_)
+        {
+            column_bounds_valid_ = false;
+        }
+
+        size_ -= target.size();
+        rows_.erase(rows_.begin() + static_cast<std::ptrdiff_t>(row_index));
+    }
+
+    /// <summary>
+    /// Removes every cell for which predicate returns true in a single pass.
+    /// </summary>
+    template <typename Predicate>
+    void erase_if(Predicate predicate)
+    {
+        reclaim_detached();
+
+        auto row_out = rows_.begin();
+
+        for (auto &row : rows_)
+        {
+            std::size_t kept = 0;
+
+            for (std::size_t i = 0; i < row.size(); ++i)
+            {
+                if (predicate(static_cast<const cell_impl &>(*row.cells_[i])))
+                {
+                    release(row.cells_[i]);
+                    --size_;
+                    continue;
+                }
+
+                row.columns_[kept] = row.columns_[i];
+                row.cells_[kept] = row.cells_[i];
+                ++kept;
+            }
+
+            row.columns_.resize(kept);
+            row.cells_.resize(kept);
+
+            if (kept > 0)
+            {
+                if (&*row_out != &row)
+                {
+                    *row_out = std::move(row);
+                }
+
+                ++row_out;
+            }
+        }
+
+        rows_.erase(row_out, rows_.end());
+        column_bounds_valid_ = false;
+    }
+
+    /// <summary>
+    /// Moves every cell in first_row and below down by amount rows. If up is
+    /// true, the amount rows above first_row are removed instead and the cells
+    /// below them move up. Cells above the edit are not touched and moved cells
+    /// keep their address.
+    /// </summary>
+    void shift_rows(row_t first_row, std::uint32_t amount, bool up)
+    {
+        reclaim_detached();
+
+        auto first = row_position(first_row);
+
+        if (up)
+        {
+            auto removed = row_position(first_row - amount);
+
+            for (auto row = removed; row < first; ++row)
+            {
+                for (auto cell : rows_[row].cells_)
+                {
+                    release(cell);
+                }
+
+                size_ -= rows_[row].size();
+                column_bounds_valid_ = false;
+            }
+
+            rows_.erase(rows_.begin() + static_cast<std::ptrdiff_t>(removed),
+                rows_.begin() + static_cast<std::ptrdiff_t>(first));
+            first = removed;
+        }
+
+        for (auto row = rows_.begin() + static_cast<std::ptrdiff_t>(first); row != rows_.end(); ++row)
+        {
+            row->index_ = up ? row->index_ - amount : row->index_ + amount;
+
+            for (auto cell : row->cells_)
+            {
+                cell->row_ = row->index_;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Moves every cell in first_column and to the right of it right by amount
+    /// columns. If left is true, the amount columns before first_column are
+    /// removed instead and the cells after them move left.
+    /// </summary>
+    void shift_columns(column_t::index_t first_column, std::uint32_t amount, bool left)
+    {
+        reclaim_detached();
+
+        for (auto &row : rows_)
+        {
+            auto first = row.lower_bound(first_column);
+
+            if (left)
+            {
+                auto removed = row.lower_bound(first_column - amount);
+
+                for (auto i = removed; i < first; ++i)
+                {
+                    release(row.cells_[i]);
+                }
+
+                row.columns_.erase(row.columns_.begin() + static_cast<std::ptrdiff_t>(removed),
+                    row.columns_.begin() + static_cast<std::ptrdiff_t>(first));
+                row.cells_.erase(row.cells_.begin() + static_cast<std::ptrdiff_t>(removed),
+                    row.cells_.begin() + static_cast<std::ptrdiff_t>(first));
+                size_ -= first - removed;
+                first = removed;
+            }
+
+            for (auto i = first; i < row.size(); ++i)
+            {
+                row.columns_[i] = left ? row.columns_[i] - amount : row.columns_[i] + amount;
+                row.cells_[i]->column_ = row.columns_[i];
+            }
+        }
+
+        rows_.erase(std::remove_if(rows_.begin(), rows_.end(), [](const cell_row &row) { return row.columns_.empty(); }),
+            rows_.end());
+        column_bounds_valid_ = false;
+    }
+
+    void clear()
+    {
+        rows_.clear();
+        destroy_blocks();
+        free_.clear();
+        detached_.clear();
+        block_used_ = 0;
+        size_ = 0;
+        clear_row_reservation();
+        column_bounds_valid_ = false;
+    }
+
+    /// <summary>
+    /// Returns how the cells of this store are allocated.
+    /// </summary>
+    cell_allocation allocation() const
+    {
+        return arena_ ? cell_allocation::arena : cell_allocation::heap;
+    }
+
+    /// <summary>
+    /// Removes every cell and allocates new ones as given by allocation.
+    /// </summary>
+    void allocation(cell_allocation allocation)
+    {
+        clear();
+        arena_.reset(allocation == cell_allocation::arena ? new arena() : nullptr);
+    }
+
+    /// <summary>
+    /// Creates the out-of-line fields for a cell of this store, in the arena
+    /// if there is one. They are destroyed by the cell's extension_.
+    /// </summary>
+    cell_extension *create_extension()
+    {
+        if (!arena_)
+        {
+            return new cell_extension();
+        }
+
+        auto extension = new (arena_->allocate(sizeof(cell_extension), alignof(cell_extension))) cell_extension();
+        extension->in_arena_ = true;
+
+        return extension;
+    }
+
+    /// <summary>
+    /// Makes room for at least n cells without further block allocations.
+    /// </summary>
+    void reserve(std::size_t n)
+    {
+        auto available = free_.size() + (blocks_.empty() ? 0 : blocks_.back().size_ - block_used_);
+
+        if (n > size_ + available)
+        {
+            add_block(n - size_ - free_.size());
+        }
+    }
+
+    /// <summary>
+    /// Makes room for the given number of rows. The next that many rows to be
+    /// created get room for row_size cells each, unless clear_row_reservation()
+    /// is called first.
+    /// </summary>
+    void reserve_rows(std::size_t rows, std::size_t row_size)
+    {
+        rows_.reserve(rows);
+        reserved_rows_ = rows;
+        row_size_hint_ = row_size;
+    }
+
+    /// <summary>
+    /// Creates rows without reserved room from now on.
+    /// </summary>
+    void clear_row_reservation()
+    {
+        reserved_rows_ = 0;
+        row_size_hint_ = 0;
+    }
+
+private:
+    // the cells of a block are constructed when it is added and destroyed
+    // with the store, its memory comes from the arena if there is one
+    struct block
+    {
+        cell_impl *cells_;
+        std::size_t size_;
+    };
+
+    static const std::size_t first_block_size = 64;
+    static const std::size_t max_block_size = 4096;
+
+    std::size_t row_position(row_t row) const
+    {
+        // cells are usually appended in row order
+        if (rows_.empty() || rows_.back().index_ < row)
+        {
+            return rows_.size();
+        }
+
+        if (rows_.back().index_ == row)
+        {
+            return rows_.size() - 1;
+        }
+
+        return static_cast<std::size_t>(std::lower_bound(rows_.begin(), rows_.end(), row,
+                                            [](const cell_row &r, row_t index) { return r.index_ < index; })
+            - rows_.begin());
+    }
+
+    void insert_row(std::size_t row_index, row_t row)
+    {
+        auto &inserted = *rows_.emplace(rows_.begin() + static_cast<std::ptrdiff_t>(row_index), row);
+
+        if (reserved_rows_ != 0 && row_size_hint_ != 0)
+        {
+            --reserved_rows_;
+            inserted.columns_.reserve(row_size_hint_);
+            inserted.cells_.reserve(row_size_hint_);
+        }
+    }
+
+    static std::uint64_t position_key(column_t::index_t column, row_t row)
+    {
+        return (static_cast<std::uint64_t>(row) << 32) | column;
+    }
+
+    // returns the slot for a new cell at the given position, which is the
+    // detached one if the cell was removed while handles could still use it
+    cell_impl *create(column_t::index_t column, row_t row)
+    {
+        if (!detached_.empty())
+        {
+            auto match = detached_.find(position_key(column, row));
+
+            if (match != detached_.end())
+            {
+                auto cell = match->second;
+                detached_.erase(match);
+
+                return cell;
+            }
+        }
+
+        auto cell = allocate();
+        cell->column_ = column;
+        cell->row_ = row;
+
+        return cell;
+    }
+
+    // puts a detached cell back at its position, which must be free
+    void attach(cell_impl *cell)
+    {
+        auto column = cell->column_.index;
+        auto row_index = row_position(cell->row_);
+
+        if (row_index == rows_.size() || rows_[row_index].index_ != cell->row_)
+        {
+            insert_row(row_index, cell->row_);
+        }
+
+        auto &target = rows_[row_index];
+        auto position = static_cast<std::ptrdiff_t>(target.lower_bound(column));
+        target.columns_.insert(target.columns_.begin() + position, column);
+        target.cells_.insert(target.cells_.begin() + position, cell);
+        cells_added(1, column, column);
+    }
+
+    // removes a cell from the rows without releasing it
+    cell_impl *unlink(std::size_t row_index, std::size_t position)
+    {
+        auto &target = rows_[row_index];
+        auto cell = target.cells_[position];
+        auto column = target.columns_[position];
+
+        target.columns_.erase(target.columns_.begin() + static_cast<std::ptrdiff_t>(position));
+        target.cells_.erase(target.cells_.begin() + static_cast<std::ptrdiff_t>(position));
+        --size_;
+
+        if (column == min_column_ || column == max_column_)
+        {
+            column_bounds_valid_ = false;
+        }
+
+        if (target.columns_.empty())
+        {
+            rows_.erase(rows_.begin() + static_cast<std::ptrdiff_t>(row_index));
+        }
+
+        return cell;
+    }
+
+    void cells_added(std::size_t count, column_t::index_t first_column, column_t::index_t last_column)
+    {
+        if (size_ == 0)
+        {
+            min_column_ = first_column;
+            max_column_ = last_column;
+            column_bounds_valid_ = true;
+        }
+        else if (column_bounds_valid_)
+        {
+            min_column_ = std::min(min_column_, first_column);
+            max_column_ = std::max(max_column_, last_column);
+        }
+
+        size_ += count;
+    }
+
+    // the column bounds are extended as cells are added but only recomputed
+    // on demand after a removal which may have shrunk them
+    void update_column_bounds() const
+    {
+        if (column_bounds_valid_ || rows_.empty())
+        {
+            return;
+        }
+
+        min_column_ = rows_.front().columns_.front();
+        max_column_ = rows_.front().columns_.back();
+
+        for (const auto &row : rows_)
+        {
+            min_column_ = std::min(min_column_, row.columns_.front());
+            max_column_ = std::max(max_column_, row.columns_.back());
+        }
+
+        column_bounds_valid_ = true;
+    }
+
+    void add_block(std::size_t size)
+    {
+        blocks_.reserve(blocks_.size() + 1);
+
+        auto bytes = size * sizeof(cell_impl);
+        auto memory = arena_ ? arena_->allocate(bytes, alignof(cell_impl)) : ::operator new(bytes);
+        auto cells = static_cast<cell_impl *>(memory);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            new (cells + i) cell_impl();
+        }
+
+        blocks_.push_back(block{cells, size});
+        block_used_ = 0;
+    }
+
+    void destroy_blocks()
+    {
+        for (auto &b : blocks_)
+        {
+            for (std::size_t i = 0; i < b.size_; ++i)
+            {
+                b.cells_[i].~cell_impl();
+            }
+
+            if (!arena_)
+            {
+                ::operator delete(b.cells_);
+            }
+        }
+
+        blocks_.clear();
+
+        if (arena_)
+        {
+            arena_->release();
+        }
+    }
+
+    cell_impl *allocate()
+    {
+        if (!free_.empty())
+        {
+            auto cell = free_.back();
+            free_.pop_back();
+            cell->clear();
+
+            return cell;
+        }
+
+        if (blocks_.empty() || block_used_ == blocks_.back().size_)
+        {
+            auto size = blocks_.empty() ? first_block_size : blocks_.back().size_ * 2;
+            add_block(size < max_block_size ? size : max_block_size);
+        }
+
+        return &blocks_.back().cells_[block_used_++];
+    }
+
+    // the slot is emptied when it is reused, keeping its extension since
+    // arena memory is only returned with the whole store, but handles which
+    // outlived the cell must see that it no longer belongs to a worksheet
+    void release(cell_impl *cell)
+    {
+        cell->parent_ = nullptr;
+        free_.push_back(cell);
+    }
+
+    std::vector<cell_row> rows_;
+    std::vector<block> blocks_;
+    std::vector<cell_impl *> free_;
+    // cells removed by detach() by position, see reclaim_detached
+    std::unordered_map<std::uint64_t, cell_impl *> detached_;
+    // null unless cells are allocated from an arena
+    std::unique_ptr<arena> arena_;
+    std::size_t block_used_ = 0;
+    std::size_t size_ = 0;
+    // the number of rows still to be created with room for row_size_hint_
+    // cells, see reserve_rows
+    std::size_t reserved_rows_ = 0;
+    std::size_t row_size_hint_ = 0;
+    mutable column_t::index_t min_column_ = 0;
+    mutable column_t::index_t max_column_ = 0;
+    mutable bool column_bounds_valid_ = false;
+};
+
+} // namespace detail
+} // namespace xlnt
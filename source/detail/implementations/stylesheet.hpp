@@ -59,6 +59,11 @@ struct stylesheet
 
     class xlnt::format format(std::size_t index)
     {
+        if (index >= format_impls.size())
+        {
+            throw invalid_parameter();
+        }
+
         auto iter = format_impls.begin();
         std::advance(iter, static_cast<std::list<format_impl>::difference_type>(index));
 
@@ -22,7 +22,9 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <istream>
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -34,6 +36,7 @@
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/calculation_properties.hpp>
+#include <xlnt/workbook/cell_allocation.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
 #include <xlnt/worksheet/range.hpp>
@@ -43,11 +46,12 @@
 namespace xlnt {
 namespace detail {
 
+class xlsx_consumer;
 struct worksheet_impl;
 
 struct workbook_impl
 {
-    workbook_impl() : base_date_(calendar::windows_1900)
+    workbook_impl() : base_date_(calendar::windows_1900), cell_allocation_(cell_allocation::heap)
     {
     }
 
@@ -64,7 +68,9 @@ struct workbook_impl
           custom_properties_(other.custom_properties_),
           view_(other.view_),
           code_name_(other.code_name_),
-          file_version_(other.file_version_)
+          file_version_(other.file_version_),
+          cell_allocation_(other.cell_allocation_),
+          skipped_parts_(other.skipped_parts_)
     {
     }
 
@@ -83,6 +89,8 @@ struct workbook_impl
         view_ = other.view_;
         code_name_ = other.code_name_;
         file_version_ = other.file_version_;
+        cell_allocation_ = other.cell_allocation_;
+        skipped_parts_ = other.skipped_parts_;
 
         core_properties_ = other.core_properties_;
         extended_properties_ = other.extended_properties_;
@@ -168,6 +176,21 @@ struct workbook_impl
     optional<std::string> abs_path_;
     optional<std::size_t> arch_id_flags_;
     optional<ext_list> extensions_;
+
+    cell_allocation cell_allocation_;
+
+    /// <summary>
+    /// Set when a load skipped parts of the package which saving would need.
+    /// </summary>
+    bool skipped_parts_ = false;
+
+    /// <summary>
+    /// The package and the consumer which reads worksheets a lazy load left unread
+    /// when they're first accessed. The package is empty if the caller owns the stream.
+    /// Neither is copied with the rest of the workbook.
+    /// </summary>
+    std::unique_ptr<std::istream> deferred_source_;
+    std::shared_ptr<xlsx_consumer> deferred_consumer_;
 };
 
 } // namespace detail
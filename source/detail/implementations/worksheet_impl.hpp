@@ -23,8 +23,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <xlnt/drawing/spreadsheet_drawing.hpp>
@@ -41,6 +43,7 @@
 #include <xlnt/worksheet/print_options.hpp>
 #include <xlnt/worksheet/sheet_pr.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_store.hpp>
 
 namespace xlnt {
 
@@ -71,7 +74,9 @@ struct worksheet_impl
         format_properties_ = other.format_properties_;
         column_properties_ = other.column_properties_;
         row_properties_ = other.row_properties_;
-        cell_map_ = other.cell_map_;
+        row_properties_bounds_ = other.row_properties_bounds_;
+        row_properties_bounds_valid_ = other.row_properties_bounds_valid_;
+        cells_ = other.cells_;
         page_setup_ = other.page_setup_;
         auto_filter_ = other.auto_filter_;
         page_margins_ = other.page_margins_;
@@ -88,10 +93,76 @@ struct worksheet_impl
         extension_list_ = other.extension_list_;
         sheet_properties_ = other.sheet_properties_;
         print_options_ = other.print_options_;
+        auto_garbage_collect_ = other.auto_garbage_collect_;
 
-        for (auto &cell : cell_map_)
+        for (auto &cell : cells_)
         {
-            cell.second.parent_ = this;
+            cell.parent_ = this;
+        }
+    }
+
+    /// <summary>
+    /// Returns the lowest and highest row with properties. row_properties_
+    /// must not be empty.
+    /// </summary>
+    const std::pair<row_t, row_t> &row_properties_bounds() const
+    {
+        if (!row_properties_bounds_valid_)
+        {
+            row_properties_bounds_.first = row_properties_bounds_.second = row_properties_.begin()->first;
+
+            for (const auto &props : row_properties_)
+            {
+                row_properties_bounds_.first = std::min(row_properties_bounds_.first, props.first);
+                row_properties_bounds_.second = std::max(row_properties_bounds_.second, props.first);
+            }
+
+            row_properties_bounds_valid_ = true;
+        }
+
+        return row_properties_bounds_;
+    }
+
+    /// <summary>
+    /// Must be called after properties for row have been added to row_properties_.
+    /// </summary>
+    void row_properties_added(row_t row)
+    {
+        if (row_properties_.size() == 1)
+        {
+            row_properties_bounds_ = {row, row};
+            row_properties_bounds_valid_ = true;
+        }
+        else if (row_properties_bounds_valid_)
+        {
+            row_properties_bounds_.first = std::min(row_properties_bounds_.first, row);
+            row_properties_bounds_.second = std::max(row_properties_bounds_.second, row);
+        }
+    }
+
+    /// <summary>
+    /// Must be called after properties have been removed from row_properties_.
+    /// </summary>
+    void row_properties_removed()
+    {
+        row_properties_bounds_valid_ = false;
+    }
+
+    /// <summary>
+    /// Must be called after every change to cell. Removes the cell if automatic
+    /// garbage collection is enabled and it is collectible. The caller still
+    /// holds a handle to it, so its slot is only detached, and a later change
+    /// which leaves something in it puts it back.
+    /// </summary>
+    void cell_changed(cell_impl *cell)
+    {
+        if (!cell->is_garbage_collectible())
+        {
+            cells_.reattach(cell);
+        }
+        else if (auto_garbage_collect_)
+        {
+            cells_.detach(cell);
         }
     }
 
@@ -104,7 +175,7 @@ struct worksheet_impl
             && format_properties_ == rhs.format_properties_
             && column_properties_ == rhs.column_properties_
             && row_properties_ == rhs.row_properties_
-            && cell_map_ == rhs.cell_map_
+            && cells_ == rhs.cells_
             && page_setup_ == rhs.page_setup_
             && auto_filter_ == rhs.auto_filter_
             && page_margins_ == rhs.page_margins_
@@ -131,8 +202,10 @@ struct worksheet_impl
 
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
+    mutable std::pair<row_t, row_t> row_properties_bounds_;
+    mutable bool row_properties_bounds_valid_ = false;
 
-    std::unordered_map<cell_reference, cell_impl> cell_map_;
+    cell_store cells_;
 
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
@@ -154,6 +227,7 @@ struct worksheet_impl
 
     std::unordered_map<std::string, comment> comments_;
     optional<print_options> print_options_;
+    bool auto_garbage_collect_ = false;
     optional<sheet_pr> sheet_properties_;
 
     optional<ext_list> extension_list_;
@@ -0,0 +1,155 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <vector>
+
+#include <xlnt/cell/cell_reference.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <detail/reference_format.hpp>
+
+namespace {
+
+// A to XFD, the columns a worksheet can have in Excel
+const std::size_t table_columns = 16384;
+
+struct column_letters
+{
+    char letters[3];
+    unsigned char size;
+};
+
+/// <summary>
+/// Writes the letters of the column with the given index to first and returns
+/// the end of what was written.
+/// </summary>
+char *compute_column(std::size_t index, char *first)
+{
+    char reversed[xlnt::detail::max_column_letters];
+    auto size = std::size_t(0);
+
+    for (auto remaining = index; remaining > 0; remaining = (remaining - 1) / 26)
+    {
+        reversed[size++] = static_cast<char>('A' + (remaining - 1) % 26);
+    }
+
+    while (size > 0)
+    {
+        *first++ = reversed[--size];
+    }
+
+    return first;
+}
+
+/// <summary>
+/// Returns the letters of the first table_columns columns, indexed by column index.
+/// </summary>
+const column_letters *column_letter_table()
+{
+    static const auto table = []() {
+        auto result = std::vector<column_letters>(table_columns + 1, column_letters());
+
+        for (std::size_t index = 1; index <= table_columns; ++index)
+        {
+            char letters[xlnt::detail::max_column_letters];
+            const auto size = static_cast<std::size_t>(compute_column(index, letters) - letters);
+
+            for (std::size_t i = 0; i < size && i < 3; ++i)
+            {
+                result[index].letters[i] = letters[i];
+            }
+
+            result[index].size = static_cast<unsigned char>(size);
+        }
+
+        return result;
+    }();
+
+    return table.data();
+}
+
+char *format_row(xlnt::row_t row, char *first)
+{
+    char digits[10];
+    auto digit = digits + sizeof(digits);
+
+    do
+    {
+        *--digit = static_cast<char>('0' + row % 10);
+        row /= 10;
+    } while (row != 0);
+
+    while (digit != digits + sizeof(digits))
+    {
+        *first++ = *digit++;
+    }
+
+    return first;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+char *format_column(column_t column, char *first)
+{
+    if (column.index == 0)
+    {
+        throw invalid_column_index();
+    }
+
+    if (column.index > table_columns)
+    {
+        return compute_column(column.index, first);
+    }
+
+    const auto &entry = column_letter_table()[column.index];
+
+    for (std::size_t i = 0; i < entry.size; ++i)
+    {
+        *first++ = entry.letters[i];
+    }
+
+    return first;
+}
+
+char *format_reference(const cell_reference &reference, char *first)
+{
+    if (reference.column_absolute())
+    {
+        *first++ = '$';
+    }
+
+    first = format_column(reference.column(), first);
+
+    if (reference.row_absolute())
+    {
+        *first++ = '$';
+    }
+
+    return format_row(reference.row(), first);
+}
+
+} // namespace detail
+} // namespace xlnt
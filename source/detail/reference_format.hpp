@@ -0,0 +1,65 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+class cell_reference;
+
+namespace detail {
+
+/// <summary>
+/// The most characters format_column writes. Columns past XFD can be up to
+/// seven letters long, since column indices are 32 bit.
+/// </summary>
+const std::size_t max_column_letters = 7;
+
+/// <summary>
+/// The most characters format_reference writes, e.g. "$MWLQKWU$4294967295".
+/// </summary>
+const std::size_t max_reference_size = 1 + max_column_letters + 1 + 10;
+
+/// <summary>
+/// Writes the letters of column to first, which must have room for
+/// max_column_letters characters, and returns the end of what was written.
+/// The letters of A to XFD come from a table built on first use. Throws
+/// invalid_column_index for column 0.
+/// </summary>
+XLNT_API char *format_column(column_t column, char *first);
+
+/// <summary>
+/// Writes reference, e.g. "B12" or "$B$12", to first, which must have room for
+/// max_reference_size characters, and returns the end of what was written.
+/// Nothing is allocated.
+/// </summary>
+XLNT_API char *format_reference(const cell_reference &reference, char *first);
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,150 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Hands batches of work from a producer thread to a consumer thread. A fixed
+/// number of batches circulates between the two, so memory use is bounded by
+/// the batch count and the storage inside each batch is reused.
+/// </summary>
+template <typename Batch>
+class batch_pipeline
+{
+public:
+    explicit batch_pipeline(std::size_t batch_count)
+        : batches_(batch_count)
+    {
+        for (auto &batch : batches_)
+        {
+            empty_.push_back(&batch);
+        }
+    }
+
+    batch_pipeline(const batch_pipeline &) = delete;
+    batch_pipeline &operator=(const batch_pipeline &) = delete;
+
+    /// <summary>
+    /// Producer: waits for a batch which can be filled. Returns nullptr if the
+    /// pipeline was cancelled.
+    /// </summary>
+    Batch *acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return cancelled_ || !empty_.empty(); });
+
+        if (cancelled_)
+        {
+            return nullptr;
+        }
+
+        auto batch = empty_.front();
+        empty_.pop_front();
+
+        return batch;
+    }
+
+    /// <summary>
+    /// Producer: passes a filled batch to the consumer.
+    /// </summary>
+    void publish(Batch *batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        filled_.push_back(batch);
+        changed_.notify_all();
+    }
+
+    /// <summary>
+    /// Producer: signals that no more batches will be published.
+    /// </summary>
+    void finish()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+        changed_.notify_all();
+    }
+
+    /// <summary>
+    /// Consumer: waits for the next filled batch. Returns nullptr once the
+    /// producer has finished and every batch has been consumed, or if the
+    /// pipeline was cancelled.
+    /// </summary>
+    Batch *next()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return cancelled_ || finished_ || !filled_.empty(); });
+
+        if (cancelled_ || filled_.empty())
+        {
+            return nullptr;
+        }
+
+        auto batch = filled_.front();
+        filled_.pop_front();
+
+        return batch;
+    }
+
+    /// <summary>
+    /// Consumer: returns a batch to the producer for reuse.
+    /// </summary>
+    void release(Batch *batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        empty_.push_back(batch);
+        changed_.notify_all();
+    }
+
+    /// <summary>
+    /// Either side: stops the pipeline, waking up a thread waiting in
+    /// acquire() or next().
+    /// </summary>
+    void cancel()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        changed_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<Batch> batches_;
+    std::deque<Batch *> empty_;
+    std::deque<Batch *> filled_;
+    bool finished_ = false;
+    bool cancelled_ = false;
+};
+
+} // namespace detail
+} // namespace xlnt
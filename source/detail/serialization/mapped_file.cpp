@@ -0,0 +1,210 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/path.hpp>
+#include <detail/external/include_windows.hpp>
+#include <detail/serialization/mapped_file.hpp>
+
+namespace xlnt {
+namespace detail {
+
+#ifdef _MSC_VER
+
+mapped_file::mapped_file(const path &filename, std::size_t size)
+    : filename_(filename),
+      size_(size)
+{
+    file_ = CreateFileW(filename.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        throw xlnt::exception("couldn't create " + filename.string());
+    }
+
+    if (size_ == 0) return;
+
+    const auto size64 = static_cast<std::uint64_t>(size_);
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+
+    if (mapping_ != nullptr)
+    {
+        data_ = static_cast<std::uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, size_));
+    }
+
+    if (data_ == nullptr)
+    {
+        discard();
+        throw xlnt::exception("couldn't map " + filename.string());
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (file_ == INVALID_HANDLE_VALUE) return;
+
+    discard();
+}
+
+void mapped_file::discard()
+{
+    unmap();
+
+    LARGE_INTEGER start;
+    start.QuadPart = 0;
+    SetFilePointerEx(file_, start, nullptr, FILE_BEGIN);
+    SetEndOfFile(file_);
+
+    CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+    DeleteFileW(filename_.wstring().c_str());
+}
+
+void mapped_file::unmap()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+}
+
+void mapped_file::close(std::size_t size)
+{
+    unmap();
+
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    const auto truncated = SetFilePointerEx(file_, end, nullptr, FILE_BEGIN) && SetEndOfFile(file_);
+
+    CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+
+    if (!truncated)
+    {
+        throw xlnt::exception("couldn't truncate mapped file");
+    }
+}
+
+#else
+
+mapped_file::mapped_file(const path &filename, std::size_t size)
+    : filename_(filename),
+      size_(size)
+{
+    file_ = ::open(filename.string().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+    if (file_ < 0)
+    {
+        throw xlnt::exception("couldn't create " + filename.string());
+    }
+
+    if (size_ == 0) return;
+
+    if (ftruncate(file_, static_cast<off_t>(size_)) == 0)
+    {
+        auto mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+        data_ = mapping == MAP_FAILED ? nullptr : static_cast<std::uint8_t *>(mapping);
+    }
+
+    if (data_ == nullptr)
+    {
+        discard();
+        throw xlnt::exception("couldn't map " + filename.string());
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    if (file_ < 0) return;
+
+    discard();
+}
+
+void mapped_file::discard()
+{
+    unmap();
+
+    if (ftruncate(file_, 0) != 0)
+    {
+        // it's deleted below anyway, emptying it only matters if that fails
+    }
+
+    ::close(file_);
+    file_ = -1;
+    ::unlink(filename_.string().c_str());
+}
+
+void mapped_file::unmap()
+{
+    if (data_ != nullptr)
+    {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+}
+
+void mapped_file::close(std::size_t size)
+{
+    unmap();
+
+    const auto truncated = ftruncate(file_, static_cast<off_t>(size)) == 0;
+
+    ::close(file_);
+    file_ = -1;
+
+    if (!truncated)
+    {
+        throw xlnt::exception("couldn't truncate mapped file");
+    }
+}
+
+#endif
+
+std::uint8_t *mapped_file::data()
+{
+    return data_;
+}
+
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,86 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/utils/path.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A file which is created, or truncated, with a given size and mapped into
+/// memory for writing, so it can be written without going through a stream's
+/// buffer. Throws xlnt::exception if the file can't be created or mapped,
+/// in which case no file is left behind.
+/// </summary>
+class XLNT_API mapped_file
+{
+public:
+    mapped_file(const path &filename, std::size_t size);
+
+    /// <summary>
+    /// If close() wasn't called, because writing the file failed, unmaps it
+    /// and deletes it rather than leave a file of the full size behind.
+    /// </summary>
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    std::uint8_t *data();
+
+    std::size_t size() const;
+
+    /// <summary>
+    /// Unmaps the file and truncates it to the first size bytes.
+    /// </summary>
+    void close(std::size_t size);
+
+private:
+    void unmap();
+
+    /// <summary>
+    /// Unmaps, empties, closes and deletes the file.
+    /// </summary>
+    void discard();
+
+    path filename_;
+    std::uint8_t *data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifdef _MSC_VER
+    void *file_;
+    void *mapping_ = nullptr;
+#else
+    int file_;
+#endif
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -30,12 +30,18 @@ struct Cell_Reference
     // the common case. row # is already known during parsing (from parent <row> element)
     // just need to evaluate the column
     explicit Cell_Reference(xlnt::row_t row_arg, const std::string &reference) noexcept
+        : Cell_Reference(row_arg, reference.c_str())
+    {
+    }
+
+    // as above, for references which are followed by any character that can't be part of the column
+    explicit Cell_Reference(xlnt::row_t row_arg, const char *reference) noexcept
         : row(row_arg)
     {
         // only three characters allowed for the column
         // assumption:
         // - regex pattern match: [A-Z]{1,3}\d{1,7}
-        const char *iter = reference.c_str();
+        const char *iter = reference;
         int temp = *iter - 'A' + 1; // 'A' == 1
         ++iter;
         if (*iter >= 'A') // second char
@@ -86,7 +92,7 @@ struct Cell
     xlnt::cell_type type = xlnt::cell_type::number; // 't'
     int cell_metatdata_idx = -1; // 'cm'
     int style_index = -1; // 's'
-    Cell_Reference ref{0, 0}; // 'r'
+    Cell_Reference ref{xlnt::row_t(0), xlnt::column_t::index_t(0)}; // 'r'
     std::string value; // <v> OR <is>
     std::string formula_string; // <f>
 };
@@ -0,0 +1,1245 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <algorithm>
+#include <cstring>
+
+#include <detail/serialization/sheet_data_scanner.hpp>
+
+namespace {
+
+using xlnt::detail::text_span;
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_name_end(char c)
+{
+    return is_space(c) || c == '/' || c == '>' || c == '=';
+}
+
+void skip_space(const char *&current, const char *last)
+{
+    while (current != last && is_space(*current))
+    {
+        ++current;
+    }
+}
+
+const char *find_char(const char *first, const char *last, char c)
+{
+    auto found = static_cast<const char *>(std::memchr(first, c, static_cast<std::size_t>(last - first)));
+    return found == nullptr ? last : found;
+}
+
+bool needs_decoding(const char *first, const char *last, bool attribute)
+{
+    for (; first != last; ++first)
+    {
+        if (*first == '&' || *first == '\r' || (attribute && (*first == '\n' || *first == '\t')))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Appends code_point encoded as UTF-8 to out. Returns false if it isn't a valid XML character.
+/// </summary>
+bool append_code_point(unsigned long code_point, std::string &out)
+{
+    if (code_point < 0x20 && code_point != 0x9 && code_point != 0xA && code_point != 0xD)
+    {
+        return false;
+    }
+
+    if (code_point < 0x80)
+    {
+        out.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000)
+    {
+        if ((code_point >= 0xD800 && code_point <= 0xDFFF) || code_point > 0xFFFD)
+        {
+            return false;
+        }
+
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point <= 0x10FFFF)
+    {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Decodes a character reference such as "#60" or "#x3C" and appends the result to out.
+/// </summary>
+bool append_character_reference(const char *first, const char *last, std::string &out)
+{
+    auto base = 10ul;
+    ++first; // '#'
+
+    if (first != last && *first == 'x')
+    {
+        base = 16;
+        ++first;
+    }
+
+    if (first == last || last - first > 8)
+    {
+        return false;
+    }
+
+    auto code_point = 0ul;
+
+    for (; first != last; ++first)
+    {
+        auto c = *first;
+        unsigned long digit = 0;
+
+        if (c >= '0' && c <= '9')
+        {
+            digit = static_cast<unsigned long>(c - '0');
+        }
+        else if (base == 16 && c >= 'a' && c <= 'f')
+        {
+            digit = static_cast<unsigned long>(c - 'a' + 10);
+        }
+        else if (base == 16 && c >= 'A' && c <= 'F')
+        {
+            digit = static_cast<unsigned long>(c - 'A' + 10);
+        }
+        else
+        {
+            return false;
+        }
+
+        code_point = code_point * base + digit;
+    }
+
+    return append_code_point(code_point, out);
+}
+
+/// <summary>
+/// Appends [first, last) to out, expanding the predefined entities and character references and
+/// normalizing line endings (and whitespace in attribute values) the way an XML processor must.
+/// Returns false for anything which can't be decoded without a DTD.
+/// </summary>
+bool decode(const char *first, const char *last, bool attribute, std::string &out)
+{
+    while (first != last)
+    {
+        auto c = *first;
+
+        if (c == '&')
+        {
+            auto semicolon = find_char(first + 1, last, ';');
+
+            if (semicolon == last)
+            {
+                return false;
+            }
+
+            auto name = text_span{first + 1, static_cast<std::size_t>(semicolon - first - 1)};
+
+            if (name.equals("lt"))
+            {
+                out.push_back('<');
+            }
+            else if (name.equals("gt"))
+            {
+                out.push_back('>');
+            }
+            else if (name.equals("amp"))
+            {
+                out.push_back('&');
+            }
+            else if (name.equals("quot"))
+            {
+                out.push_back('"');
+            }
+            else if (name.equals("apos"))
+            {
+                out.push_back('\'');
+            }
+            else if (name.empty() || name.data[0] != '#' || !append_character_reference(name.data, semicolon, out))
+            {
+                return false;
+            }
+
+            first = semicolon + 1;
+            continue;
+        }
+
+        if (c == '\r')
+        {
+            c = '\n';
+
+            if (first + 1 != last && first[1] == '\n')
+            {
+                ++first;
+            }
+        }
+
+        if (attribute && (c == '\n' || c == '\t'))
+        {
+            c = ' ';
+        }
+
+        out.push_back(c);
+        ++first;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Appends the character data [first, last) to text, only copying into buffer when text
+/// consists of more than one piece or entities have to be expanded.
+/// </summary>
+bool append_text(const char *first, const char *last, std::string &buffer, text_span &text)
+{
+    auto decode_needed = needs_decoding(first, last, false);
+
+    if (text.empty() && !decode_needed)
+    {
+        text = text_span{first, static_cast<std::size_t>(last - first)};
+        return true;
+    }
+
+    if (text.empty())
+    {
+        buffer.clear();
+    }
+    else if (text.data != buffer.data())
+    {
+        buffer.assign(text.data, text.size);
+    }
+
+    if (decode_needed)
+    {
+        if (!decode(first, last, false, buffer))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        buffer.append(first, last);
+    }
+
+    text = text_span{buffer.data(), buffer.size()};
+
+    return true;
+}
+
+/// <summary>
+/// Reads an XML qualified name starting at current and splits it into prefix and local name.
+/// </summary>
+bool read_qname(const char *&current, const char *last, text_span &prefix, text_span &local_name)
+{
+    auto first = current;
+
+    while (current != last && !is_name_end(*current))
+    {
+        ++current;
+    }
+
+    if (current == first || current == last)
+    {
+        return false;
+    }
+
+    auto colon = find_char(first, current, ':');
+
+    if (colon == current)
+    {
+        prefix = text_span{first, 0};
+        local_name = text_span{first, static_cast<std::size_t>(current - first)};
+    }
+    else
+    {
+        prefix = text_span{first, static_cast<std::size_t>(colon - first)};
+        local_name = text_span{colon + 1, static_cast<std::size_t>(current - colon - 1)};
+    }
+
+    return true;
+}
+
+bool prefix_equals(const text_span &prefix, const std::string &expected)
+{
+    return prefix.size == expected.size()
+        && std::char_traits<char>::compare(prefix.data, expected.data(), prefix.size) == 0;
+}
+
+/// <summary>
+/// Returns true if the XML declaration [first, last) doesn't specify an encoding other than UTF-8.
+/// </summary>
+bool is_utf8_declaration(const char *first, const char *last)
+{
+    const std::string encoding = "encoding";
+    auto found = std::search(first, last, encoding.begin(), encoding.end());
+
+    if (found == last)
+    {
+        return true;
+    }
+
+    auto current = found + encoding.size();
+    skip_space(current, last);
+
+    if (current == last || *current != '=')
+    {
+        return false;
+    }
+
+    ++current;
+    skip_space(current, last);
+
+    if (current == last || (*current != '"' && *current != '\''))
+    {
+        return false;
+    }
+
+    auto quote = *current++;
+    auto value_end = find_char(current, last, quote);
+    auto value = std::string(current, value_end);
+    std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+        return static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+    });
+
+    return value == "UTF-8";
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+bool sheet_data_scanner::find_sheet_data_start(const char *first, const char *last,
+    const char *&content_first, std::string &prefix)
+{
+    auto current = find_char(first, last, '<');
+
+    // the XML declaration is the only thing expected before the root element
+    if (current != last && current + 1 != last && current[1] == '?')
+    {
+        const std::string declaration_end = "?>";
+        auto end = std::search(current, last, declaration_end.begin(), declaration_end.end());
+
+        if (end == last || !is_utf8_declaration(current, end))
+        {
+            return false;
+        }
+
+        current = find_char(end + 2, last, '<');
+    }
+
+    if (current == last)
+    {
+        return false;
+    }
+
+    auto root_prefix = text_span();
+    auto root_name = text_span();
+
+    if (!read_qname(++current, last, root_prefix, root_name) || !root_name.equals("worksheet"))
+    {
+        return false;
+    }
+
+    prefix.assign(root_prefix.data, root_prefix.size);
+
+    // elements before <sheetData> are small, look at each of them until it's found
+    while (true)
+    {
+        current = find_char(current, last, '<');
+
+        if (current == last || current + 1 == last || current[1] == '!' || current[1] == '?')
+        {
+            return false;
+        }
+
+        auto element_prefix = text_span();
+        auto element_name = text_span();
+
+        if (current[1] != '/' && read_qname(++current, last, element_prefix, element_name)
+            && element_name.equals("sheetData") && prefix_equals(element_prefix, prefix))
+        {
+            break;
+        }
+
+        ++current;
+    }
+
+    // '>' is allowed in attribute values
+    auto quote = '\0';
+    auto start_tag = current;
+
+    for (; current != last; ++current)
+    {
+        if (quote != '\0')
+        {
+            quote = *current == quote ? '\0' : quote;
+        }
+        else if (*current == '"' || *current == '\'')
+        {
+            quote = *current;
+        }
+        else if (*current == '>')
+        {
+            break;
+        }
+    }
+
+    if (current == last || current[-1] == '/')
+    {
+        return false;
+    }
+
+    // a namespace declaration here could change what prefixes in the content refer to
+    const std::string declaration = "xmlns";
+
+    if (std::search(start_tag, current, declaration.begin(), declaration.end()) != current)
+    {
+        return false;
+    }
+
+    content_first = current + 1;
+
+    return true;
+}
+
+bool sheet_data_scanner::find_dimension(const char *first, const char *last,
+    const std::string &prefix, std::string &ref)
+{
+    auto current = first;
+
+    while (true)
+    {
+        current = find_char(current, last, '<');
+
+        if (current == last)
+        {
+            return false;
+        }
+
+        auto element_prefix = text_span();
+        auto element_name = text_span();
+
+        if (read_qname(++current, last, element_prefix, element_name)
+            && element_name.equals("dimension") && prefix_equals(element_prefix, prefix))
+        {
+            break;
+        }
+    }
+
+    while (true)
+    {
+        skip_space(current, last);
+
+        auto attribute_prefix = text_span();
+        auto attribute_name = text_span();
+
+        if (!read_qname(current, last, attribute_prefix, attribute_name))
+        {
+            return false;
+        }
+
+        skip_space(current, last);
+
+        if (current == last || *current != '=')
+        {
+            return false;
+        }
+
+        skip_space(++current, last);
+
+        if (current == last || (*current != '"' && *current != '\''))
+        {
+            return false;
+        }
+
+        auto quote = *current++;
+        auto value_end = find_char(current, last, quote);
+
+        if (value_end == last)
+        {
+            return false;
+        }
+
+        if (attribute_prefix.empty() && attribute_name.equals("ref"))
+        {
+            ref.assign(current, value_end);
+            return true;
+        }
+
+        current = value_end + 1;
+    }
+}
+
+bool sheet_data_scanner::find_namespace_prefix(const char *first, const char *last,
+    const std::string &namespace_uri, std::string &prefix)
+{
+    auto current = find_char(first, last, '<');
+
+    if (current != last && current + 1 != last && current[1] == '?')
+    {
+        const std::string declaration_end = "?>";
+        current = find_char(std::search(current, last, declaration_end.begin(), declaration_end.end()), last, '<');
+    }
+
+    auto root_prefix = text_span();
+    auto root_name = text_span();
+
+    if (current == last || !read_qname(++current, last, root_prefix, root_name))
+    {
+        return false;
+    }
+
+    // stops at the end of the start tag, where there's no name to read
+    while (true)
+    {
+        skip_space(current, last);
+
+        auto attribute_prefix = text_span();
+        auto attribute_name = text_span();
+
+        if (!read_qname(current, last, attribute_prefix, attribute_name))
+        {
+            return false;
+        }
+
+        skip_space(current, last);
+
+        if (current == last || *current != '=')
+        {
+            return false;
+        }
+
+        skip_space(++current, last);
+
+        if (current == last || (*current != '"' && *current != '\''))
+        {
+            return false;
+        }
+
+        auto quote = *current++;
+        auto value_end = find_char(current, last, quote);
+
+        if (value_end == last)
+        {
+            return false;
+        }
+
+        if (attribute_prefix.equals("xmlns")
+            && static_cast<std::size_t>(value_end - current) == namespace_uri.size()
+            && std::equal(current, value_end, namespace_uri.begin()))
+        {
+            prefix.assign(attribute_name.data, attribute_name.size);
+            return true;
+        }
+
+        current = value_end + 1;
+    }
+}
+
+bool sheet_data_scanner::find_sheet_data(const char *first, const char *last,
+    const char *&content_first, const char *&content_last, std::string &prefix)
+{
+    if (!find_sheet_data_start(first, last, content_first, prefix))
+    {
+        return false;
+    }
+
+    // the end tag is much closer to the end of the part than to the start of the element
+    const auto end_tag = "</" + (prefix.empty() ? std::string() : prefix + ":") + "sheetData";
+    auto end = std::find_end(content_first, last, end_tag.begin(), end_tag.end());
+
+    if (end == last)
+    {
+        return false;
+    }
+
+    content_last = end;
+
+    return true;
+}
+
+sheet_data_scanner::sheet_data_scanner(const char *first, const char *last,
+    const std::string &prefix, const std::string &x14ac_prefix)
+    : current_(first),
+      last_(last),
+      prefix_(prefix),
+      x14ac_prefix_(x14ac_prefix)
+{
+}
+
+const scanned_row &sheet_data_scanner::row() const
+{
+    return row_;
+}
+
+const scanned_cell &sheet_data_scanner::cell() const
+{
+    return cell_;
+}
+
+sheet_data_scanner::event sheet_data_scanner::next()
+{
+    while (true)
+    {
+        if (!skip_text())
+        {
+            return event::unsupported;
+        }
+
+        if (current_ == last_)
+        {
+            return in_row_ ? event::unsupported : event::end_of_data;
+        }
+
+        auto current_tag = tag();
+
+        if (!read_tag(current_tag))
+        {
+            return event::unsupported;
+        }
+
+        if (current_tag.closing)
+        {
+            if (!in_row_ || !current_tag.name.equals("row"))
+            {
+                return event::unsupported;
+            }
+
+            in_row_ = false;
+            continue;
+        }
+
+        auto self_closing = false;
+
+        if (!in_row_)
+        {
+            if (!current_tag.name.equals("row") || !read_row_attributes(self_closing) || !row_.r.present())
+            {
+                return event::unsupported;
+            }
+
+            in_row_ = !self_closing;
+
+            return event::row;
+        }
+
+        if (!current_tag.name.equals("c") || !read_cell_attributes(self_closing) || !cell_.r.present())
+        {
+            return event::unsupported;
+        }
+
+        if (!self_closing && !read_cell_content())
+        {
+            return event::unsupported;
+        }
+
+        return event::cell;
+    }
+}
+
+bool sheet_data_scanner::skip_text()
+{
+    // only whitespace is expected between rows and cells, anything which
+    // would need to be decoded is left to the XML parser to validate
+    for (; current_ != last_ && *current_ != '<'; ++current_)
+    {
+        if (*current_ == '&')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool sheet_data_scanner::read_tag(tag &result)
+{
+    ++current_; // '<'
+
+    if (current_ == last_ || *current_ == '!' || *current_ == '?')
+    {
+        return false;
+    }
+
+    result.closing = *current_ == '/';
+
+    if (result.closing)
+    {
+        ++current_;
+    }
+
+    auto prefix = text_span();
+
+    if (!read_qname(current_, last_, prefix, result.name) || !prefix_equals(prefix, prefix_))
+    {
+        return false;
+    }
+
+    if (result.closing)
+    {
+        skip_space(current_, last_);
+
+        if (current_ == last_ || *current_ != '>')
+        {
+            return false;
+        }
+
+        ++current_;
+    }
+
+    return true;
+}
+
+bool sheet_data_scanner::next_attribute(text_span &prefix, text_span &name, text_span &raw_value, bool &self_closing)
+{
+    skip_space(current_, last_);
+
+    if (current_ == last_)
+    {
+        return false;
+    }
+
+    if (*current_ == '>' || *current_ == '/')
+    {
+        self_closing = *current_ == '/';
+        current_ += self_closing ? 1 : 0;
+
+        if (current_ == last_ || *current_ != '>')
+        {
+            return false;
+        }
+
+        ++current_;
+        prefix = text_span();
+        name = text_span();
+
+        return true;
+    }
+
+    if (!read_qname(current_, last_, prefix, name))
+    {
+        return false;
+    }
+
+    // namespace declarations could change what the element prefix refers to
+    if ((prefix.empty() && name.equals("xmlns")) || prefix.equals("xmlns"))
+    {
+        return false;
+    }
+
+    skip_space(current_, last_);
+
+    if (current_ == last_ || *current_ != '=')
+    {
+        return false;
+    }
+
+    ++current_;
+    skip_space(current_, last_);
+
+    if (current_ == last_ || (*current_ != '"' && *current_ != '\''))
+    {
+        return false;
+    }
+
+    auto value_first = ++current_;
+    current_ = find_char(current_, last_, value_first[-1]);
+
+    if (current_ == last_ || find_char(value_first, current_, '<') != current_)
+    {
+        return false;
+    }
+
+    raw_value = text_span{value_first, static_cast<std::size_t>(current_ - value_first)};
+    ++current_;
+
+    return true;
+}
+
+bool sheet_data_scanner::attribute_value(const text_span &raw_value, std::size_t buffer, text_span &value)
+{
+    if (!needs_decoding(raw_value.data, raw_value.data + raw_value.size, true))
+    {
+        value = raw_value;
+        return true;
+    }
+
+    auto &decoded = attribute_buffers_[buffer];
+    decoded.clear();
+
+    if (!decode(raw_value.data, raw_value.data + raw_value.size, true, decoded))
+    {
+        return false;
+    }
+
+    value = text_span{decoded.data(), decoded.size()};
+
+    return true;
+}
+
+bool sheet_data_scanner::read_row_attributes(bool &self_closing)
+{
+    row_ = scanned_row();
+
+    auto prefix = text_span();
+    auto name = text_span();
+    auto value = text_span();
+
+    while (next_attribute(prefix, name, value, self_closing))
+    {
+        if (!name.present())
+        {
+            return true;
+        }
+
+        auto decoded = true;
+
+        // the only prefix known to be bound is the one the root element declares for x14ac
+        if (!prefix.empty())
+        {
+            if (x14ac_prefix_.empty() || !prefix_equals(prefix, x14ac_prefix_) || !name.equals("dyDescent"))
+            {
+                return false;
+            }
+
+            decoded = attribute_value(value, 7, row_.dy_descent);
+        }
+        else if (name.equals("r"))
+        {
+            decoded = attribute_value(value, 0, row_.r);
+        }
+        else if (name.equals("spans"))
+        {
+            decoded = attribute_value(value, 1, row_.spans);
+        }
+        else if (name.equals("ht"))
+        {
+            decoded = attribute_value(value, 2, row_.ht);
+        }
+        else if (name.equals("s"))
+        {
+            decoded = attribute_value(value, 3, row_.s);
+        }
+        else if (name.equals("hidden"))
+        {
+            decoded = attribute_value(value, 4, row_.hidden);
+        }
+        else if (name.equals("customFormat"))
+        {
+            decoded = attribute_value(value, 5, row_.custom_format);
+        }
+        else if (name.equals("customHeight"))
+        {
+            decoded = attribute_value(value, 6, row_.custom_height);
+        }
+
+        if (!decoded)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool sheet_data_scanner::read_cell_attributes(bool &self_closing)
+{
+    cell_ = scanned_cell();
+
+    auto prefix = text_span();
+    auto name = text_span();
+    auto value = text_span();
+
+    while (next_attribute(prefix, name, value, self_closing))
+    {
+        if (!name.present())
+        {
+            return true;
+        }
+
+        if (!prefix.empty())
+        {
+            return false;
+        }
+
+        auto decoded = true;
+
+        if (name.equals("r"))
+        {
+            decoded = attribute_value(value, 0, cell_.r);
+        }
+        else if (name.equals("t"))
+        {
+            decoded = attribute_value(value, 1, cell_.t);
+        }
+        else if (name.equals("s"))
+        {
+            decoded = attribute_value(value, 2, cell_.s);
+        }
+        else if (name.equals("ph"))
+        {
+            decoded = attribute_value(value, 3, cell_.ph);
+        }
+
+        if (!decoded)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool sheet_data_scanner::read_cell_content()
+{
+    // nesting level as in parse_cell: 1 == <c>, 2 == <v>/<f>/<is>, 3 == <is><t>
+    auto level = 1;
+    text_span open_elements[3];
+    open_elements[0] = text_span{"c", 1};
+    auto last_name = open_elements[0];
+    auto formula_seen = false;
+
+    while (level > 0)
+    {
+        auto text_last = find_char(current_, last_, '<');
+
+        if (text_last != current_)
+        {
+            auto appended = true;
+
+            if (level == 2 && last_name.equals("v"))
+            {
+                appended = append_text(current_, text_last, value_buffer_, cell_.value);
+            }
+            else if (level == 2 && last_name.equals("f"))
+            {
+                appended = append_text(current_, text_last, formula_buffer_, cell_.formula);
+            }
+            else if (level == 3 && last_name.equals("t"))
+            {
+                appended = append_text(current_, text_last, value_buffer_, cell_.value);
+            }
+            else
+            {
+                appended = find_char(current_, text_last, '&') == text_last;
+            }
+
+            if (!appended)
+            {
+                return false;
+            }
+
+            current_ = text_last;
+        }
+
+        if (current_ == last_)
+        {
+            return false;
+        }
+
+        auto current_tag = tag();
+
+        if (!read_tag(current_tag))
+        {
+            return false;
+        }
+
+        if (current_tag.closing)
+        {
+            auto &open = open_elements[level - 1];
+
+            if (current_tag.name.size != open.size
+                || std::char_traits<char>::compare(current_tag.name.data, open.data, open.size) != 0)
+            {
+                return false;
+            }
+
+            last_name = current_tag.name;
+            --level;
+
+            continue;
+        }
+
+        // rich text runs, phonetic runs and extensions are left to the XML parser
+        auto &name = current_tag.name;
+        auto expected = level == 1 ? (name.equals("v") || name.equals("f") || name.equals("is"))
+                                   : level == 2 && name.equals("t") && open_elements[1].equals("is");
+
+        if (!expected)
+        {
+            return false;
+        }
+
+        auto self_closing = false;
+        auto attribute_prefix = text_span();
+        auto attribute_name = text_span();
+        auto raw_value = text_span();
+        auto is_formula = name.equals("f");
+
+        if (is_formula)
+        {
+            if (formula_seen)
+            {
+                return false;
+            }
+
+            formula_seen = true;
+        }
+
+        while (true)
+        {
+            if (!next_attribute(attribute_prefix, attribute_name, raw_value, self_closing))
+            {
+                return false;
+            }
+
+            if (!attribute_name.present())
+            {
+                break;
+            }
+
+            if (!attribute_prefix.empty())
+            {
+                return false;
+            }
+
+            if (!is_formula)
+            {
+                continue;
+            }
+
+            auto decoded = true;
+
+            if (attribute_name.equals("t"))
+            {
+                decoded = attribute_value(raw_value, 4, cell_.formula_type);
+            }
+            else if (attribute_name.equals("ref"))
+            {
+                decoded = attribute_value(raw_value, 5, cell_.formula_ref);
+            }
+            else if (attribute_name.equals("si"))
+            {
+                decoded = attribute_value(raw_value, 6, cell_.formula_shared_index);
+            }
+
+            if (!decoded)
+            {
+                return false;
+            }
+        }
+
+        last_name = name;
+
+        if (!self_closing)
+        {
+            open_elements[level++] = name;
+        }
+    }
+
+    // typed formulae need a ref once they have text and shared formulae need an index
+    if (cell_.formula_type.present())
+    {
+        if (!cell_.formula.empty() && !cell_.formula_ref.present())
+        {
+            return false;
+        }
+
+        if (cell_.formula_type.equals("shared") && !cell_.formula_shared_index.present())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const std::size_t sheet_data_reader::default_window_size;
+
+sheet_data_reader::sheet_data_reader(std::istream &stream, std::string &part_data, std::size_t window_size)
+    : stream_(stream),
+      part_data_(part_data),
+      window_size_(window_size)
+{
+}
+
+bool sheet_data_reader::read_chunk(std::string &destination)
+{
+    const auto size = destination.size();
+
+    destination.resize(size + window_size_);
+    stream_.read(&destination[size], static_cast<std::streamsize>(window_size_));
+    destination.resize(size + static_cast<std::size_t>(stream_.gcount()));
+
+    return destination.size() > size;
+}
+
+bool sheet_data_reader::open(std::string &prefix)
+{
+    // elements before <sheetData> are small, past this it's not going to be found
+    const std::size_t head_limit = 1024 * 1024;
+
+    while (true)
+    {
+        const auto more = read_chunk(part_data_);
+        const char *content_first = nullptr;
+
+        if (sheet_data_scanner::find_sheet_data_start(part_data_.data(), part_data_.data() + part_data_.size(),
+                content_first, prefix))
+        {
+            const auto content_offset = static_cast<std::size_t>(content_first - part_data_.data());
+            window_.assign(part_data_, content_offset, std::string::npos);
+            part_data_.resize(content_offset);
+
+            const auto qualifier = prefix.empty() ? std::string() : prefix + ":";
+            row_end_tag_ = "</" + qualifier + "row>";
+            end_tag_ = "</" + qualifier + "sheetData";
+
+            return true;
+        }
+
+        if (!more)
+        {
+            return false;
+        }
+
+        if (part_data_.size() > head_limit)
+        {
+            while (read_chunk(part_data_))
+            {
+            }
+
+            return false;
+        }
+    }
+}
+
+bool sheet_data_reader::next(const char *&first, const char *&last)
+{
+    window_.erase(0, returned_);
+    searched_ -= searched_ < returned_ ? searched_ : returned_;
+    row_searched_ -= row_searched_ < returned_ ? row_searched_ : returned_;
+    returned_ = 0;
+
+    if (finished_ || failed_)
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        // both searches only cover text that wasn't searched before, and since rows
+        // don't follow the end of sheetData, that's only looked for past the last row
+        const auto window_first = window_.begin();
+        const auto window_last = window_.end();
+        const auto row_end_found = std::find_end(window_first + static_cast<std::ptrdiff_t>(row_searched_),
+            window_last, row_end_tag_.begin(), row_end_tag_.end());
+        const auto row_end = row_end_found == window_last
+            ? std::string::npos
+            : static_cast<std::size_t>(row_end_found - window_first);
+        const auto end = window_.find(end_tag_,
+            row_end == std::string::npos ? searched_ : (std::max)(searched_, row_end));
+
+        if (end != std::string::npos)
+        {
+            part_data_.append(window_, end, std::string::npos);
+
+            while (read_chunk(part_data_))
+            {
+            }
+
+            window_.resize(end);
+            returned_ = end;
+            finished_ = true;
+            first = window_.data();
+            last = first + end;
+
+            return true;
+        }
+
+        // either tag could start in the last few characters and finish in the next chunk
+        searched_ = window_.size() < end_tag_.size() ? 0 : window_.size() - end_tag_.size() + 1;
+        row_searched_ = row_end != std::string::npos
+            ? row_end
+            : window_.size() < row_end_tag_.size() ? 0 : window_.size() - row_end_tag_.size() + 1;
+
+        if (window_.size() >= window_size_ && row_end != std::string::npos)
+        {
+            returned_ = row_end + row_end_tag_.size();
+            first = window_.data();
+            last = first + returned_;
+
+            return true;
+        }
+
+        if (!read_chunk(window_))
+        {
+            failed_ = true;
+
+            return false;
+        }
+    }
+}
+
+bool sheet_data_reader::finished() const
+{
+    return finished_;
+}
+
+bool sheet_data_reader::failed() const
+{
+    return failed_;
+}
+
+} // namespace detail
+} // namespace xlnt
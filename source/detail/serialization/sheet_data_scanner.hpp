@@ -0,0 +1,269 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A non-owning range of characters. The characters are not null terminated
+/// but are always followed by at least one character which can't be part of a
+/// number, so strtol and friends can be used on data directly.
+/// A span with a null data pointer represents an absent attribute.
+/// </summary>
+struct text_span
+{
+    const char *data = nullptr;
+    std::size_t size = 0;
+
+    bool present() const
+    {
+        return data != nullptr;
+    }
+
+    bool empty() const
+    {
+        return size == 0;
+    }
+
+    template <std::size_t N>
+    bool equals(const char (&literal)[N]) const
+    {
+        return size == N - 1 && std::char_traits<char>::compare(data, literal, N - 1) == 0;
+    }
+
+    std::string str() const
+    {
+        return std::string(data, size);
+    }
+};
+
+/// <summary>
+/// The attributes of a <row> element which are used when loading a worksheet.
+/// </summary>
+struct scanned_row
+{
+    text_span r;
+    text_span spans;
+    text_span ht;
+    text_span s;
+    text_span hidden;
+    text_span custom_format;
+    text_span custom_height;
+    text_span dy_descent;
+};
+
+/// <summary>
+/// The attributes and content of a <c> element. value holds the text of <v>
+/// or <is><t>, formula the text of <f>.
+/// </summary>
+struct scanned_cell
+{
+    text_span r;
+    text_span t;
+    text_span s;
+    text_span ph;
+    text_span value;
+    text_span formula;
+    text_span formula_type;
+    text_span formula_ref;
+    text_span formula_shared_index;
+};
+
+/// <summary>
+/// A pull tokenizer for the content of a worksheet's <sheetData> element which
+/// works directly on the decompressed part and doesn't allocate per cell.
+/// Spans returned by row() and cell() point into the scanned buffer, or into
+/// internal buffers when entities had to be decoded, and are valid until the
+/// next call to next(). Only the markup Excel and xlnt write is understood;
+/// anything else (comments, CDATA, namespace declarations, rich inline strings,
+/// unknown elements, ...) makes next() return event::unsupported so that the
+/// caller can fall back to the generic XML parser.
+/// </summary>
+class XLNT_API sheet_data_scanner
+{
+public:
+    enum class event
+    {
+        row,
+        cell,
+        end_of_data,
+        unsupported
+    };
+
+    /// <summary>
+    /// Locates the content of the <sheetData> element in the worksheet part
+    /// [first, last). Returns false if the element is missing, empty or
+    /// couldn't be found unambiguously. Otherwise content_first and
+    /// content_last are set to the range between the start and end tags and
+    /// prefix to the namespace prefix used for elements in the part.
+    /// </summary>
+    static bool find_sheet_data(const char *first, const char *last,
+        const char *&content_first, const char *&content_last, std::string &prefix);
+
+    /// <summary>
+    /// As above, but only looks for the start tag, so [first, last) can be the
+    /// beginning of the part. Returns false if the start tag isn't complete yet.
+    /// </summary>
+    static bool find_sheet_data_start(const char *first, const char *last,
+        const char *&content_first, std::string &prefix);
+
+    /// <summary>
+    /// Sets ref to the ref attribute of the <dimension> element among the
+    /// elements before <sheetData>, [first, last), whose elements use the given
+    /// namespace prefix. Returns false if there is no such attribute.
+    /// </summary>
+    static bool find_dimension(const char *first, const char *last,
+        const std::string &prefix, std::string &ref);
+
+    /// <summary>
+    /// Sets prefix to the prefix which the root element of the part [first, last)
+    /// declares for namespace_uri. Returns false if it doesn't declare one.
+    /// </summary>
+    static bool find_namespace_prefix(const char *first, const char *last,
+        const std::string &namespace_uri, std::string &prefix);
+
+    /// <summary>
+    /// Scans the content of a <sheetData> element, [first, last), whose
+    /// elements use the given namespace prefix. Prefixed attributes are
+    /// unsupported, except for dyDescent on rows when its prefix is
+    /// x14ac_prefix, the one the part declares for the x14ac namespace.
+    /// </summary>
+    sheet_data_scanner(const char *first, const char *last,
+        const std::string &prefix, const std::string &x14ac_prefix = std::string());
+
+    /// <summary>
+    /// Advances to the next <row> or <c> element. A row event is followed by
+    /// a cell event for each of its cells.
+    /// </summary>
+    event next();
+
+    /// <summary>
+    /// The row which was last returned by next().
+    /// </summary>
+    const scanned_row &row() const;
+
+    /// <summary>
+    /// The cell which was last returned by next().
+    /// </summary>
+    const scanned_cell &cell() const;
+
+private:
+    struct tag
+    {
+        text_span name;
+        bool closing = false;
+    };
+
+    bool read_tag(tag &result);
+    bool next_attribute(text_span &prefix, text_span &name, text_span &raw_value, bool &self_closing);
+    bool attribute_value(const text_span &raw_value, std::size_t buffer, text_span &value);
+    bool read_row_attributes(bool &self_closing);
+    bool read_cell_attributes(bool &self_closing);
+    bool read_cell_content();
+    bool skip_text();
+
+    const char *current_;
+    const char *last_;
+    std::string prefix_;
+    std::string x14ac_prefix_;
+    bool in_row_ = false;
+
+    scanned_row row_;
+    scanned_cell cell_;
+
+    std::string value_buffer_;
+    std::string formula_buffer_;
+    std::string attribute_buffers_[8];
+};
+
+/// <summary>
+/// Reads a worksheet part from a stream and hands out the content of its
+/// <sheetData> element a window of complete rows at a time, so that all of the
+/// decompressed sheetData never has to be in memory at once. Everything
+/// else in the part is collected in part_data for the XML parser.
+/// </summary>
+class XLNT_API sheet_data_reader
+{
+public:
+    /// <summary>
+    /// The size windows grow to before they're handed out, which is also the
+    /// size of the chunks read from the stream.
+    /// </summary>
+    static const std::size_t default_window_size = 256 * 1024;
+
+    sheet_data_reader(std::istream &stream, std::string &part_data,
+        std::size_t window_size = default_window_size);
+
+    /// <summary>
+    /// Reads the part up to the start of <sheetData>. Returns false if it couldn't
+    /// be found (see sheet_data_scanner::find_sheet_data), in which case part_data
+    /// holds the whole part.
+    /// </summary>
+    bool open(std::string &prefix);
+
+    /// <summary>
+    /// Discards the previous window and sets [first, last) to the next one, which
+    /// ends with a complete row. Returns false once all of sheetData was returned,
+    /// at which point part_data holds the part without the content of sheetData,
+    /// or if the end tag is missing, see failed().
+    /// </summary>
+    bool next(const char *&first, const char *&last);
+
+    /// <summary>
+    /// True once the end of sheetData has been read. If this is already the case
+    /// after the first call to next(), all of sheetData fit in one window.
+    /// </summary>
+    bool finished() const;
+
+    /// <summary>
+    /// True if the stream ended before </sheetData>. part_data is incomplete then.
+    /// </summary>
+    bool failed() const;
+
+private:
+    bool read_chunk(std::string &destination);
+
+    std::istream &stream_;
+    std::string &part_data_;
+    std::size_t window_size_;
+    std::string window_;
+    std::size_t returned_ = 0;
+    std::size_t searched_ = 0;
+    std::size_t row_searched_ = 0;
+    std::string row_end_tag_;
+    std::string end_tag_;
+    bool finished_ = false;
+    bool failed_ = false;
+};
+
+} // namespace detail
+} // namespace xlnt
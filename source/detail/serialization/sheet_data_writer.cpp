@@ -0,0 +1,178 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <string>
+
+#include <xlnt/utils/numeric.hpp>
+#include <detail/external/include_libstudxml.hpp>
+#include <detail/reference_format.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+
+namespace {
+
+// the buffer is written to the stream once it's this long
+const std::size_t buffer_size = 64 * 1024;
+
+/// <summary>
+/// Returns true if text can be written as it is, which is the case for printable
+/// ASCII without markup characters. Anything else is escaped and validated by the
+/// serializer.
+/// </summary>
+bool is_plain_text(const std::string &text)
+{
+    for (auto c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+
+        if ((byte < 0x20 && c != '\t' && c != '\n') || byte > 0x7e || c == '&' || c == '<' || c == '>')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+sheet_data_writer::sheet_data_writer(std::ostream &stream, xml::serializer &serializer)
+    : stream_(stream),
+      serializer_(serializer)
+{
+    buffer_.reserve(buffer_size + 1024);
+}
+
+void sheet_data_writer::characters(const std::string &text)
+{
+    if (!is_plain_text(text))
+    {
+        flush();
+        serializer_.characters(text);
+
+        return;
+    }
+
+    close_start_tag();
+    buffer_.append(text);
+}
+
+void sheet_data_writer::characters(std::size_t value)
+{
+    close_start_tag();
+    append(value);
+}
+
+void sheet_data_writer::characters(double value)
+{
+    close_start_tag();
+    append(value);
+}
+
+void sheet_data_writer::flush()
+{
+    close_start_tag();
+    stream_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void sheet_data_writer::start_element(const char *name, std::size_t size)
+{
+    close_start_tag();
+    buffer_.push_back('<');
+    buffer_.append(name, size);
+    start_tag_open_ = true;
+}
+
+void sheet_data_writer::end_element(const char *name, std::size_t size)
+{
+    if (start_tag_open_)
+    {
+        buffer_.append("/>", 2);
+        start_tag_open_ = false;
+    }
+    else
+    {
+        buffer_.append("</", 2);
+        buffer_.append(name, size);
+        buffer_.push_back('>');
+    }
+
+    if (buffer_.size() >= buffer_size)
+    {
+        flush();
+    }
+}
+
+void sheet_data_writer::start_attribute(const char *name, std::size_t size)
+{
+    buffer_.push_back(' ');
+    buffer_.append(name, size);
+    buffer_.append("=\"", 2);
+}
+
+void sheet_data_writer::close_start_tag()
+{
+    if (start_tag_open_)
+    {
+        buffer_.push_back('>');
+        start_tag_open_ = false;
+    }
+}
+
+void sheet_data_writer::append(const char *text)
+{
+    buffer_.append(text);
+}
+
+void sheet_data_writer::append(std::size_t value)
+{
+    char digits[20];
+    auto first = digits + sizeof(digits);
+
+    do
+    {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    buffer_.append(first, static_cast<std::size_t>(digits + sizeof(digits) - first));
+}
+
+void sheet_data_writer::append(double value)
+{
+    char number[32];
+    buffer_.append(number, static_cast<std::size_t>(format_number(value, number) - number));
+}
+
+void sheet_data_writer::append(column_t column)
+{
+    char letters[max_column_letters];
+    buffer_.append(letters, static_cast<std::size_t>(format_column(column, letters) - letters));
+}
+
+} // namespace detail
+} // namespace xlnt
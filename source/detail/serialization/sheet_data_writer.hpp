@@ -0,0 +1,154 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xml {
+class serializer;
+} // namespace xml
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Writes the content of a worksheet's <sheetData> element straight into the part
+/// stream. References and numbers are formatted into a local buffer instead of
+/// going through xml::serializer for every row and cell. Elements and attributes
+/// are written as given, so element names must be in the default namespace of the
+/// part and prefixed attribute names must be declared already. Text which could
+/// need escaping is handed to the serializer, so the output is the same as if the
+/// serializer had written all of it.
+/// </summary>
+class XLNT_API sheet_data_writer
+{
+public:
+    /// <summary>
+    /// Writes to stream, which must be the one serializer writes to. The element
+    /// the serializer is in must already have content, see flush().
+    /// </summary>
+    sheet_data_writer(std::ostream &stream, xml::serializer &serializer);
+
+    /// <summary>
+    /// Writes the start of an element whose start tag is completed by its first
+    /// child or text, or which is written as an empty element if it has neither.
+    /// </summary>
+    template <std::size_t N>
+    void start_element(const char (&name)[N])
+    {
+        start_element(name, N - 1);
+    }
+
+    template <std::size_t N>
+    void end_element(const char (&name)[N])
+    {
+        end_element(name, N - 1);
+    }
+
+    /// <summary>
+    /// Writes an attribute whose value doesn't need escaping.
+    /// </summary>
+    template <std::size_t N>
+    void attribute(const char (&name)[N], const char *value)
+    {
+        start_attribute(name, N - 1);
+        append(value);
+        buffer_.push_back('"');
+    }
+
+    template <std::size_t N>
+    void attribute(const char (&name)[N], std::size_t value)
+    {
+        start_attribute(name, N - 1);
+        append(value);
+        buffer_.push_back('"');
+    }
+
+    template <std::size_t N>
+    void attribute(const char (&name)[N], double value)
+    {
+        start_attribute(name, N - 1);
+        append(value);
+        buffer_.push_back('"');
+    }
+
+    /// <summary>
+    /// Writes the reference of the cell at column and row, e.g. r="B7".
+    /// </summary>
+    template <std::size_t N>
+    void attribute(const char (&name)[N], column_t column, row_t row)
+    {
+        start_attribute(name, N - 1);
+        append(column);
+        append(std::size_t(row));
+        buffer_.push_back('"');
+    }
+
+    /// <summary>
+    /// Writes the range of columns first:last, e.g. spans="1:4".
+    /// </summary>
+    template <std::size_t N>
+    void attribute(const char (&name)[N], std::size_t first, std::size_t last)
+    {
+        start_attribute(name, N - 1);
+        append(first);
+        buffer_.push_back(':');
+        append(last);
+        buffer_.push_back('"');
+    }
+
+    void characters(const std::string &text);
+    void characters(std::size_t value);
+    void characters(double value);
+
+    /// <summary>
+    /// Completes a pending start tag and writes everything buffered to the stream,
+    /// after which the serializer can write the next part of the content.
+    /// </summary>
+    void flush();
+
+private:
+    void start_element(const char *name, std::size_t size);
+    void end_element(const char *name, std::size_t size);
+    void start_attribute(const char *name, std::size_t size);
+    void close_start_tag();
+    void append(const char *text);
+    void append(std::size_t value);
+    void append(double value);
+    void append(column_t column);
+
+    std::ostream &stream_;
+    xml::serializer &serializer_;
+    std::string buffer_;
+    bool start_tag_open_ = false;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -213,6 +213,85 @@ std::streampos vector_ostreambuf::seekpos(std::streampos sp, std::ios_base::open
     return static_cast<std::ptrdiff_t>(position_);
 }
 
+buffer_ostreambuf::buffer_ostreambuf(std::uint8_t *data, std::size_t capacity)
+    : data_(data),
+      capacity_(capacity),
+      position_(0),
+      size_(0)
+{
+}
+
+std::size_t buffer_ostreambuf::size() const
+{
+    return size_;
+}
+
+buffer_ostreambuf::int_type buffer_ostreambuf::overflow(int_type c)
+{
+    if (c == traits_type::eof())
+    {
+        return traits_type::not_eof(c);
+    }
+
+    const auto byte = static_cast<char>(c);
+
+    return xsputn(&byte, 1) == 1 ? c : traits_type::eof();
+}
+
+std::streamsize buffer_ostreambuf::xsputn(const char *s, std::streamsize n)
+{
+    const auto count = static_cast<std::size_t>(n);
+
+    if (count > capacity_ - position_)
+    {
+        return 0;
+    }
+
+    if (data_ != nullptr)
+    {
+        std::copy(s, s + n, data_ + position_);
+    }
+
+    position_ += count;
+    size_ = std::max(size_, position_);
+
+    return n;
+}
+
+std::streampos buffer_ostreambuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+{
+    auto origin = position_;
+
+    if (way == std::ios_base::beg)
+    {
+        origin = 0;
+    }
+    else if (way == std::ios_base::end)
+    {
+        origin = size_;
+    }
+
+    if ((off < 0 && static_cast<std::size_t>(-off) > origin)
+        || (off > 0 && static_cast<std::size_t>(off) > size_ - origin))
+    {
+        return static_cast<std::ptrdiff_t>(-1);
+    }
+
+    return seekpos(static_cast<std::streamoff>(origin) + off, which);
+}
+
+std::streampos buffer_ostreambuf::seekpos(std::streampos sp, std::ios_base::openmode)
+{
+    if (sp < 0 || static_cast<std::size_t>(sp) > size_)
+    {
+        return static_cast<std::ptrdiff_t>(-1);
+    }
+
+    position_ = static_cast<std::size_t>(sp);
+
+    return sp;
+}
+
 XLNT_API std::vector<std::uint8_t> to_vector(std::istream &in_stream)
 {
     if (!in_stream)
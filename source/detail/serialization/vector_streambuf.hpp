@@ -88,6 +88,43 @@ private:
     std::size_t position_;
 };
 
+/// <summary>
+/// Allows a caller's buffer of fixed size to be written through a std::ostream
+/// with block copies. Writes which don't fit fail and set badbit on the stream.
+/// If data is null, nothing is copied and only the size is kept track of, which
+/// is used to measure a file before writing it.
+/// </summary>
+class XLNT_API buffer_ostreambuf : public std::streambuf
+{
+    using int_type = std::streambuf::int_type;
+
+public:
+    buffer_ostreambuf(std::uint8_t *data, std::size_t capacity);
+
+    buffer_ostreambuf(const buffer_ostreambuf &) = delete;
+    buffer_ostreambuf &operator=(const buffer_ostreambuf &) = delete;
+
+    /// <summary>
+    /// Returns the number of bytes written, up to the end of the furthest write.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    int_type overflow(int_type c) override;
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode) override;
+
+    std::streampos seekpos(std::streampos sp, std::ios_base::openmode) override;
+
+private:
+    std::uint8_t *data_;
+    std::size_t capacity_;
+    std::size_t position_;
+    std::size_t size_;
+};
+
 //TODO: detail headers shouldn't be exporting such functions
 
 /// <summary>
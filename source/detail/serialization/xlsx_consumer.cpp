@@ -21,10 +21,16 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <cassert>
+#include <atomic>
 #include <cctype>
+#include <exception>
+#include <limits>
 #include <numeric> // for std::accumulate
 #include <sstream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include <xlnt/cell/cell.hpp>
@@ -34,15 +40,18 @@
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/selection.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/constants.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
 #include <detail/implementations/workbook_impl.hpp>
+#include <detail/serialization/batch_pipeline.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
 #include <detail/serialization/serialisation_helpers.hpp>
+#include <detail/serialization/sheet_data_scanner.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -75,19 +84,44 @@ inline bool string_equal(const std::string &lhs, const char (&rhs)[N])
     return string_arr_loop_equal(lhs, rhs);
 }
 
-xml::qname &qn(const std::string &namespace_, const std::string &name)
+template <size_t N>
+inline bool string_equal(const xlnt::detail::text_span &lhs, const char (&rhs)[N])
 {
-    using qname_map = std::unordered_map<std::string, xml::qname>;
-    static auto memo = std::unordered_map<std::string, qname_map>();
+    return lhs.equals(rhs);
+}
 
-    auto &ns_memo = memo[namespace_];
+/// <summary>
+/// Returns the qname made by make, which is only called the first time. Each
+/// lambda has a type of its own, so every use of XLNT_QN below gets its own constant.
+/// </summary>
+template <typename Make>
+const xml::qname &interned_qname(Make make)
+{
+    static const xml::qname name = make();
+    return name;
+}
 
-    if (ns_memo.find(name) == ns_memo.end())
-    {
-        return ns_memo.emplace(name, xml::qname(xlnt::constants::ns(namespace_), name)).first->second;
-    }
+/// <summary>
+/// The qualified name with the given namespace id (see constants::ns) and local
+/// name. It's constructed once where it's used, so comparing elements against it
+/// in a loop doesn't build strings or look anything up, and unlike a shared memo
+/// it's safe with worksheets being read on several threads.
+/// </summary>
+#define XLNT_QN(namespace_id, name) interned_qname([] { return xml::qname(xlnt::constants::ns(namespace_id), name); })
+
+/// <summary>
+/// As XLNT_QN, for the name of an attribute without a namespace.
+/// </summary>
+#define XLNT_ATTRIBUTE_QN(name) interned_qname([] { return xml::qname(name); })
 
-    return ns_memo[name];
+/// <summary>
+/// Returns true if name has the given namespace and local name, without
+/// constructing a qname to compare it with.
+/// </summary>
+template <size_t N>
+bool is_name(const xml::qname &name, const std::string &namespace_, const char (&local_name)[N])
+{
+    return string_equal(name.name(), local_name) && name.namespace_() == namespace_;
 }
 
 /// <summary>
@@ -113,6 +147,39 @@ bool is_true(const std::string &bool_string)
 #endif
 }
 
+bool is_true(const xlnt::detail::text_span &bool_string)
+{
+#ifdef THROW_ON_INVALID_XML
+    return is_true(bool_string.str());
+#else
+    return bool_string.equals("1") || bool_string.equals("true");
+#endif
+}
+
+/// <summary>
+/// Parses an xsd:int attribute value, returning false if it isn't one.
+/// </summary>
+bool parse_int(const xlnt::detail::text_span &value, int &result)
+{
+    if (value.empty())
+    {
+        return false;
+    }
+
+    char *end = nullptr;
+    auto parsed = strtol(value.data, &end, 10);
+
+    if (end != value.data + value.size || parsed < std::numeric_limits<int>::min()
+        || parsed > std::numeric_limits<int>::max())
+    {
+        return false;
+    }
+
+    result = static_cast<int>(parsed);
+
+    return true;
+}
+
 using style_id_pair = std::pair<xlnt::detail::style_impl, std::size_t>;
 
 /// <summary>
@@ -137,7 +204,8 @@ struct Sheet_Data
     std::vector<xlnt::detail::Cell> parsed_cells;
 };
 
-xlnt::cell_type type_from_string(const std::string &str)
+template <typename String>
+xlnt::cell_type type_from_string(const String &str)
 {
     if (string_equal(str, "s"))
     {
@@ -203,13 +271,13 @@ xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::uno
         switch (e)
         {
         case xml::parser::start_element: {
-            if (string_equal(parser->name(), "f") && parser->attribute_present("t"))
+            if (string_equal(parser->name(), "f") && parser->attribute_present(XLNT_ATTRIBUTE_QN("t")))
             {
                 // Skip shared formulas with a ref attribute because it indicates that this
                 // is the master cell which will be handled in the xml::parser::characters case.
-                if (parser->attribute("t") == "shared" && !parser->attribute_present("ref"))
+                if (parser->attribute(XLNT_ATTRIBUTE_QN("t")) == "shared" && !parser->attribute_present(XLNT_ATTRIBUTE_QN("ref")))
                 {
-                    auto shared_index = parser->attribute<int>("si");
+                    auto shared_index = parser->attribute<int>(XLNT_ATTRIBUTE_QN("si"));
                     c.formula_string = shared_formulae[shared_index];
                 }
             }
@@ -235,13 +303,13 @@ xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser, std::uno
                 {
                     c.formula_string += std::move(parser->value());
                     
-                    if (parser->attribute_present("t"))
+                    if (parser->attribute_present(XLNT_ATTRIBUTE_QN("t")))
                     {
-                        auto formula_ref = parser->attribute("ref");
-                        auto formula_type = parser->attribute("t");
+                        auto formula_ref = parser->attribute(XLNT_ATTRIBUTE_QN("ref"));
+                        auto formula_type = parser->attribute(XLNT_ATTRIBUTE_QN("t"));
                         if (formula_type == "shared")
                         {
-                            auto shared_index = parser->attribute<int>("si");
+                            auto shared_index = parser->attribute<int>(XLNT_ATTRIBUTE_QN("si"));
                             shared_formulae[shared_index] = c.formula_string;
                         }
                         else if (formula_type == "array")
@@ -352,8 +420,11 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail
 }
 
 // <sheetData> inside <worksheet> element
-Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae)
+// rows are handed to add_rows in batches so that only a batch of parsed cells is held at once
+template <typename AddRows>
+void parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::unordered_map<std::string, std::string> &array_formulae, std::unordered_map<int, std::string> &shared_formulae, AddRows add_rows)
 {
+    const std::size_t batch_size = 4096;
     Sheet_Data sheet_data;
     int level = 1; // nesting level
         // 1 == <sheetData>
@@ -366,6 +437,12 @@ Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser
         {
         case xml::parser::start_element: {
             sheet_data.parsed_rows.push_back(parse_row(parser, converter, sheet_data.parsed_cells, array_formulae, shared_formulae));
+            if (sheet_data.parsed_cells.size() >= batch_size)
+            {
+                add_rows(sheet_data);
+                sheet_data.parsed_rows.clear();
+                sheet_data.parsed_cells.clear();
+            }
             break;
         }
         case xml::parser::end_element: {
@@ -386,7 +463,8 @@ Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser
         }
         }
     }
-    return sheet_data;
+
+    add_rows(sheet_data);
 }
 
 } // namespace
@@ -412,8 +490,9 @@ namespace xlnt {
 namespace detail {
 
 xlsx_consumer::xlsx_consumer(workbook &target)
-    : target_(target),
-      parser_(nullptr)
+    : target_(&target),
+      parser_(nullptr),
+      sheet_data_window_size_(sheet_data_reader::default_window_size)
 {
 }
 
@@ -421,12 +500,36 @@ xlsx_consumer::~xlsx_consumer()
 {
 }
 
+/// <summary>
+/// A worksheet part which was read ahead of the rest of the workbook by
+/// xlsx_consumer::prepare_worksheets, along with the formulae needed to
+/// finish reading it.
+/// </summary>
+struct prepared_worksheet
+{
+    std::string part_data;
+    std::unordered_map<int, std::string> shared_formulae;
+    std::unordered_map<std::string, std::string> array_formulae;
+};
+
+void xlsx_consumer::sheet_data_reading(std::size_t window_size, sheet_data_threading threading)
+{
+    sheet_data_window_size_ = window_size;
+    sheet_data_threading_ = threading;
+}
+
 void xlsx_consumer::read(std::istream &source)
 {
     archive_.reset(new izstream(source));
     populate_workbook(false);
 }
 
+void xlsx_consumer::read(std::istream &source, const load_options &options)
+{
+    options_ = options;
+    read(source);
+}
+
 void xlsx_consumer::open(std::istream &source)
 {
     archive_.reset(new izstream(source));
@@ -520,85 +623,89 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
         streaming_cell_.reset(new detail::cell_impl());
     }
     
-    array_formulae_.clear();
-    shared_formulae_.clear();
+    if (streaming_)
+    {
+        // read_part() clears these before scanning sheetData when not streaming
+        array_formulae_.clear();
+        shared_formulae_.clear();
+    }
 
-    auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
-        target_.d_->sheet_title_rel_id_map_.end(),
+    auto title = std::find_if(target_->d_->sheet_title_rel_id_map_.begin(),
+        target_->d_->sheet_title_rel_id_map_.end(),
         [&](const std::pair<std::string, std::string> &p) {
             return p.second == rel_id;
         })->first;
 
     auto ws = worksheet(current_worksheet_);
 
-    expect_start_element(qn("spreadsheetml", "worksheet"), xml::content::complex); // CT_Worksheet
-    skip_attributes({qn("mc", "Ignorable")});
+    expect_start_element(XLNT_QN("spreadsheetml", "worksheet"), xml::content::complex); // CT_Worksheet
+    skip_attributes({XLNT_QN("mc", "Ignorable")});
     
     read_defined_names(ws, defined_names_);
 
-    while (in_element(qn("spreadsheetml", "worksheet")))
+    while (in_element(XLNT_QN("spreadsheetml", "worksheet")))
     {
         auto current_worksheet_element = expect_start_element(xml::content::complex);
 
-        if (current_worksheet_element == qn("spreadsheetml", "sheetPr")) // CT_SheetPr 0-1
+        if (current_worksheet_element == XLNT_QN("spreadsheetml", "sheetPr")) // CT_SheetPr 0-1
         {
             sheet_pr props;
-            if (parser().attribute_present("syncHorizontal"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("syncHorizontal")))
             { // optional, boolean, false
-                props.sync_horizontal.set(parser().attribute<bool>("syncHorizontal"));
+                props.sync_horizontal.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("syncHorizontal")));
             }
-            if (parser().attribute_present("syncVertical"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("syncVertical")))
             { // optional, boolean, false
-                props.sync_vertical.set(parser().attribute<bool>("syncVertical"));
+                props.sync_vertical.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("syncVertical")));
             }
-            if (parser().attribute_present("syncRef"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("syncRef")))
             { // optional, ST_Ref, false
-                props.sync_ref.set(cell_reference(parser().attribute("syncRef")));
+                props.sync_ref.set(cell_reference(parser().attribute(XLNT_ATTRIBUTE_QN("syncRef"))));
             }
-            if (parser().attribute_present("transitionEvaluation"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("transitionEvaluation")))
             { // optional, boolean, false
-                props.transition_evaluation.set(parser().attribute<bool>("transitionEvaluation"));
+                props.transition_evaluation.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("transitionEvaluation")));
             }
-            if (parser().attribute_present("transitionEntry"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("transitionEntry")))
             { // optional, boolean, false
-                props.transition_entry.set(parser().attribute<bool>("transitionEntry"));
+                props.transition_entry.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("transitionEntry")));
             }
-            if (parser().attribute_present("published"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("published")))
             { // optional, boolean, true
-                props.published.set(parser().attribute<bool>("published"));
+                props.published.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("published")));
             }
-            if (parser().attribute_present("codeName"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("codeName")))
             { // optional, string
-                props.code_name.set(parser().attribute<std::string>("codeName"));
+                props.code_name.set(parser().attribute<std::string>(XLNT_ATTRIBUTE_QN("codeName")));
             }
-            if (parser().attribute_present("filterMode"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("filterMode")))
             { // optional, boolean, false
-                props.filter_mode.set(parser().attribute<bool>("filterMode"));
+                props.filter_mode.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("filterMode")));
             }
-            if (parser().attribute_present("enableFormatConditionsCalculation"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("enableFormatConditionsCalculation")))
             { // optional, boolean, true
-                props.enable_format_condition_calculation.set(parser().attribute<bool>("enableFormatConditionsCalculation"));
+                props.enable_format_condition_calculation.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("enableFormatConditionsCalculation")));
             }
             ws.d_->sheet_properties_.set(props);
             while (in_element(current_worksheet_element))
             {
                 auto sheet_pr_child_element = expect_start_element(xml::content::simple);
 
-                if (sheet_pr_child_element == qn("spreadsheetml", "tabColor")) // CT_Color 0-1
+                if (sheet_pr_child_element == XLNT_QN("spreadsheetml", "tabColor")) // CT_Color 0-1
                 {
                     read_color();
                 }
-                else if (sheet_pr_child_element == qn("spreadsheetml", "outlinePr")) // CT_OutlinePr 0-1
+                else if (sheet_pr_child_element == XLNT_QN("spreadsheetml", "outlinePr")) // CT_OutlinePr 0-1
                 {
-                    skip_attribute("applyStyles"); // optional, boolean, false
-                    skip_attribute("summaryBelow"); // optional, boolean, true
-                    skip_attribute("summaryRight"); // optional, boolean, true
-                    skip_attribute("showOutlineSymbols"); // optional, boolean, true
+                    skip_attribute(XLNT_ATTRIBUTE_QN("applyStyles")); // optional, boolean, false
+                    skip_attribute(XLNT_ATTRIBUTE_QN("summaryBelow")); // optional, boolean, true
+                    skip_attribute(XLNT_ATTRIBUTE_QN("summaryRight")); // optional, boolean, true
+                    skip_attribute(XLNT_ATTRIBUTE_QN("showOutlineSymbols")); // optional, boolean, true
                 }
-                else if (sheet_pr_child_element == qn("spreadsheetml", "pageSetUpPr")) // CT_PageSetUpPr 0-1
+                else if (sheet_pr_child_element == XLNT_QN("spreadsheetml", "pageSetUpPr")) // CT_PageSetUpPr 0-1
                 {
-                    skip_attribute("autoPageBreaks"); // optional, boolean, true
-                    skip_attribute("fitToPage"); // optional, boolean, false
+                    skip_attribute(XLNT_ATTRIBUTE_QN("autoPageBreaks")); // optional, boolean, true
+                    skip_attribute(XLNT_ATTRIBUTE_QN("fitToPage")); // optional, boolean, false
                 }
                 else
                 {
@@ -608,115 +715,126 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
                 expect_end_element(sheet_pr_child_element);
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "dimension")) // CT_SheetDimension 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "dimension")) // CT_SheetDimension 0-1
         {
+            // the sheetData scanner reserves room from the dimension before adding cells,
+            // and a streamed worksheet keeps only the current cell
+            if (!streaming_ && current_worksheet_->cells_.empty() && parser().attribute_present(XLNT_ATTRIBUTE_QN("ref")))
+            {
+                reserve_worksheet(parser().attribute(XLNT_ATTRIBUTE_QN("ref")));
+            }
+
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "sheetViews")) // CT_SheetViews 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "sheetViews")) // CT_SheetViews 0-1
         {
             while (in_element(current_worksheet_element))
             {
-                expect_start_element(qn("spreadsheetml", "sheetView"), xml::content::complex); // CT_SheetView 1+
+                expect_start_element(XLNT_QN("spreadsheetml", "sheetView"), xml::content::complex); // CT_SheetView 1+
 
                 sheet_view new_view;
-                new_view.id(parser().attribute<std::size_t>("workbookViewId"));
+                new_view.id(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("workbookViewId")));
 
-                if (parser().attribute_present("showGridLines")) // default="true"
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("showGridLines"))) // default="true"
                 {
-                    new_view.show_grid_lines(is_true(parser().attribute("showGridLines")));
+                    new_view.show_grid_lines(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("showGridLines"))));
                 }
-                if (parser().attribute_present("topLeftCell"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("topLeftCell")))
                 {
-                    new_view.top_left_cell(cell_reference(parser().attribute("topLeftCell")));
+                    new_view.top_left_cell(cell_reference(parser().attribute(XLNT_ATTRIBUTE_QN("topLeftCell"))));
                 }
 
-                if (parser().attribute_present("defaultGridColor")) // default="true"
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("defaultGridColor"))) // default="true"
                 {
-                    new_view.default_grid_color(is_true(parser().attribute("defaultGridColor")));
+                    new_view.default_grid_color(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("defaultGridColor"))));
                 }
 
-                if (parser().attribute_present("view")
-                    && parser().attribute("view") != "normal")
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("view"))
+                    && parser().attribute(XLNT_ATTRIBUTE_QN("view")) != "normal")
                 {
-                    new_view.type(parser().attribute("view") == "pageBreakPreview"
+                    new_view.type(parser().attribute(XLNT_ATTRIBUTE_QN("view")) == "pageBreakPreview"
                             ? sheet_view_type::page_break_preview
                             : sheet_view_type::page_layout);
                 }
 
-                if (parser().attribute_present("tabSelected")
-                    && is_true(parser().attribute("tabSelected")))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("tabSelected"))
+                    && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("tabSelected"))))
                 {
-                    target_.d_->view_.get().active_tab = ws.id() - 1;
+                    target_->d_->view_.get().active_tab = ws.id() - 1;
                 }
 
-                skip_attributes({"windowProtection", "showFormulas", "showRowColHeaders", "showZeros", "rightToLeft", "showRuler", "showOutlineSymbols", "showWhiteSpace",
-                    "view", "topLeftCell", "colorId", "zoomScale", "zoomScaleNormal", "zoomScaleSheetLayoutView",
-                    "zoomScalePageLayoutView"});
+                skip_attributes({XLNT_ATTRIBUTE_QN("windowProtection"), XLNT_ATTRIBUTE_QN("showFormulas"),
+                    XLNT_ATTRIBUTE_QN("showRowColHeaders"), XLNT_ATTRIBUTE_QN("showZeros"),
+                    XLNT_ATTRIBUTE_QN("rightToLeft"), XLNT_ATTRIBUTE_QN("showRuler"),
+                    XLNT_ATTRIBUTE_QN("showOutlineSymbols"), XLNT_ATTRIBUTE_QN("showWhiteSpace"),
+                    XLNT_ATTRIBUTE_QN("view"), XLNT_ATTRIBUTE_QN("topLeftCell"), XLNT_ATTRIBUTE_QN("colorId"),
+                    XLNT_ATTRIBUTE_QN("zoomScale"), XLNT_ATTRIBUTE_QN("zoomScaleNormal"),
+                    XLNT_ATTRIBUTE_QN("zoomScaleSheetLayoutView"), XLNT_ATTRIBUTE_QN("zoomScalePageLayoutView")});
 
-                while (in_element(qn("spreadsheetml", "sheetView")))
+                while (in_element(XLNT_QN("spreadsheetml", "sheetView")))
                 {
                     auto sheet_view_child_element = expect_start_element(xml::content::simple);
 
-                    if (sheet_view_child_element == qn("spreadsheetml", "pane")) // CT_Pane 0-1
+                    if (sheet_view_child_element == XLNT_QN("spreadsheetml", "pane")) // CT_Pane 0-1
                     {
                         pane new_pane;
 
-                        if (parser().attribute_present("topLeftCell"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("topLeftCell")))
                         {
-                            new_pane.top_left_cell = cell_reference(parser().attribute("topLeftCell"));
+                            new_pane.top_left_cell = cell_reference(parser().attribute(XLNT_ATTRIBUTE_QN("topLeftCell")));
                         }
 
-                        if (parser().attribute_present("xSplit"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("xSplit")))
                         {
-                            new_pane.x_split = parser().attribute<column_t::index_t>("xSplit");
+                            new_pane.x_split = parser().attribute<column_t::index_t>(XLNT_ATTRIBUTE_QN("xSplit"));
                         }
 
-                        if (parser().attribute_present("ySplit"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("ySplit")))
                         {
-                            new_pane.y_split = parser().attribute<row_t>("ySplit");
+                            new_pane.y_split = parser().attribute<row_t>(XLNT_ATTRIBUTE_QN("ySplit"));
                         }
 
-                        if (parser().attribute_present("activePane"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("activePane")))
                         {
-                            new_pane.active_pane = parser().attribute<pane_corner>("activePane");
+                            new_pane.active_pane = parser().attribute<pane_corner>(XLNT_ATTRIBUTE_QN("activePane"));
                         }
 
-                        if (parser().attribute_present("state"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("state")))
                         {
-                            new_pane.state = parser().attribute<pane_state>("state");
+                            new_pane.state = parser().attribute<pane_state>(XLNT_ATTRIBUTE_QN("state"));
                         }
 
                         new_view.pane(new_pane);
                     }
-                    else if (sheet_view_child_element == qn("spreadsheetml", "selection")) // CT_Selection 0-4
+                    else if (sheet_view_child_element == XLNT_QN("spreadsheetml", "selection")) // CT_Selection 0-4
                     {
                         selection current_selection;
 
-                        if (parser().attribute_present("activeCell"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("activeCell")))
                         {
-                            current_selection.active_cell(parser().attribute("activeCell"));
+                            current_selection.active_cell(parser().attribute(XLNT_ATTRIBUTE_QN("activeCell")));
                         }
 
-                        if (parser().attribute_present("sqref"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("sqref")))
                         {
-                            const auto sqref = range_reference(parser().attribute("sqref"));
+                            const auto sqref = range_reference(parser().attribute(XLNT_ATTRIBUTE_QN("sqref")));
                             current_selection.sqref(sqref);
                         }
 
-                        if (parser().attribute_present("pane"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("pane")))
                         {
-                            current_selection.pane(parser().attribute<pane_corner>("pane"));
+                            current_selection.pane(parser().attribute<pane_corner>(XLNT_ATTRIBUTE_QN("pane")));
                         }
 
                         new_view.add_selection(current_selection);
 
                         skip_remaining_content(sheet_view_child_element);
                     }
-                    else if (sheet_view_child_element == qn("spreadsheetml", "pivotSelection")) // CT_PivotSelection 0-4
+                    else if (sheet_view_child_element == XLNT_QN("spreadsheetml", "pivotSelection")) // CT_PivotSelection 0-4
                     {
                         skip_remaining_content(sheet_view_child_element);
                     }
-                    else if (sheet_view_child_element == qn("spreadsheetml", "extLst")) // CT_ExtensionList 0-1
+                    else if (sheet_view_child_element == XLNT_QN("spreadsheetml", "extLst")) // CT_ExtensionList 0-1
                     {
                         skip_remaining_content(sheet_view_child_element);
                     }
@@ -728,76 +846,76 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
                     expect_end_element(sheet_view_child_element);
                 }
 
-                expect_end_element(qn("spreadsheetml", "sheetView"));
+                expect_end_element(XLNT_QN("spreadsheetml", "sheetView"));
 
                 ws.d_->views_.push_back(new_view);
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "sheetFormatPr")) // CT_SheetFormatPr 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "sheetFormatPr")) // CT_SheetFormatPr 0-1
         {
-            if (parser().attribute_present("baseColWidth"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("baseColWidth")))
             {
                 ws.d_->format_properties_.base_col_width =
-                    converter_.deserialise(parser().attribute("baseColWidth"));
+                    converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("baseColWidth")));
             }
-            if (parser().attribute_present("defaultColWidth"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("defaultColWidth")))
             {
                 ws.d_->format_properties_.default_column_width =
-                    converter_.deserialise(parser().attribute("defaultColWidth"));
+                    converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("defaultColWidth")));
             }
-            if (parser().attribute_present("defaultRowHeight"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("defaultRowHeight")))
             {
                 ws.d_->format_properties_.default_row_height =
-                    converter_.deserialise(parser().attribute("defaultRowHeight"));
+                    converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("defaultRowHeight")));
             }
 
-            if (parser().attribute_present(qn("x14ac", "dyDescent")))
+            if (parser().attribute_present(XLNT_QN("x14ac", "dyDescent")))
             {
                 ws.d_->format_properties_.dy_descent =
-                    converter_.deserialise(parser().attribute(qn("x14ac", "dyDescent")));
+                    converter_.deserialise(parser().attribute(XLNT_QN("x14ac", "dyDescent")));
             }
 
             skip_attributes();
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "cols")) // CT_Cols 0+
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "cols")) // CT_Cols 0+
         {
-            while (in_element(qn("spreadsheetml", "cols")))
+            while (in_element(XLNT_QN("spreadsheetml", "cols")))
             {
-                expect_start_element(qn("spreadsheetml", "col"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "col"), xml::content::simple);
 
-                skip_attributes(std::vector<std::string>{"collapsed", "outlineLevel"});
+                skip_attributes({XLNT_ATTRIBUTE_QN("collapsed"), XLNT_ATTRIBUTE_QN("outlineLevel")});
 
-                auto min = static_cast<column_t::index_t>(std::stoull(parser().attribute("min")));
-                auto max = static_cast<column_t::index_t>(std::stoull(parser().attribute("max")));
+                auto min = static_cast<column_t::index_t>(std::stoull(parser().attribute(XLNT_ATTRIBUTE_QN("min"))));
+                auto max = static_cast<column_t::index_t>(std::stoull(parser().attribute(XLNT_ATTRIBUTE_QN("max"))));
 
                 // avoid uninitialised warnings in GCC by using a lambda to make the conditional initialisation
                 optional<double> width = [this](xml::parser &p) -> xlnt::optional<double> {
-                    if (p.attribute_present("width"))
+                    if (p.attribute_present(XLNT_ATTRIBUTE_QN("width")))
                     {
-                        return (converter_.deserialise(p.attribute("width")) * 7 - 5) / 7;
+                        return (converter_.deserialise(p.attribute(XLNT_ATTRIBUTE_QN("width"))) * 7 - 5) / 7;
                     }
                     return xlnt::optional<double>();
                 }(parser());
                 // avoid uninitialised warnings in GCC by using a lambda to make the conditional initialisation
                 optional<std::size_t> column_style = [](xml::parser &p) -> xlnt::optional<std::size_t> {
-                    if (p.attribute_present("style"))
+                    if (p.attribute_present(XLNT_ATTRIBUTE_QN("style")))
                     {
-                        return p.attribute<std::size_t>("style");
+                        return p.attribute<std::size_t>(XLNT_ATTRIBUTE_QN("style"));
                     }
                     return xlnt::optional<std::size_t>();
                 }(parser());
 
-                auto custom = parser().attribute_present("customWidth")
-                    ? is_true(parser().attribute("customWidth"))
+                auto custom = parser().attribute_present(XLNT_ATTRIBUTE_QN("customWidth"))
+                    ? is_true(parser().attribute(XLNT_ATTRIBUTE_QN("customWidth")))
                     : false;
-                auto hidden = parser().attribute_present("hidden")
-                    ? is_true(parser().attribute("hidden"))
+                auto hidden = parser().attribute_present(XLNT_ATTRIBUTE_QN("hidden"))
+                    ? is_true(parser().attribute(XLNT_ATTRIBUTE_QN("hidden")))
                     : false;
-                auto best_fit = parser().attribute_present("bestFit")
-                    ? is_true(parser().attribute("bestFit"))
+                auto best_fit = parser().attribute_present(XLNT_ATTRIBUTE_QN("bestFit"))
+                    ? is_true(parser().attribute(XLNT_ATTRIBUTE_QN("bestFit")))
                     : false;
 
-                expect_end_element(qn("spreadsheetml", "col"));
+                expect_end_element(XLNT_QN("spreadsheetml", "col"));
 
                 for (auto column = min; column <= max; column++)
                 {
@@ -820,7 +938,7 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
                 }
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "sheetData")) // CT_SheetData 1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "sheetData")) // CT_SheetData 1
         {
             return title;
         }
@@ -833,79 +951,347 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
 
 void xlsx_consumer::read_worksheet_sheetdata()
 {
-    if (stack_.back() != qn("spreadsheetml", "sheetData"))
+    if (stack_.back() != XLNT_QN("spreadsheetml", "sheetData"))
     {
         return;
     }
 
-    auto ws_data = parse_sheet_data(parser_, converter_, array_formulae_, shared_formulae_);
-    // NOTE: parse->construct are seperated here and could easily be threaded
-    // with a SPSC queue for what is likely to be an easy performance win
-    for (auto &row : ws_data.parsed_rows)
+    // this is the fallback for markup sheet_data_scanner doesn't handle, the
+    // scanner path pipelines parse->construct (see the overload below)
+    parse_sheet_data(parser_, converter_, array_formulae_, shared_formulae_, [this](Sheet_Data &ws_data) {
+        for (auto &row : ws_data.parsed_rows)
+        {
+            current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+            current_worksheet_->row_properties_added(row.second);
+        }
+        for (Cell &cell : ws_data.parsed_cells)
+        {
+            add_cell(cell);
+        }
+    });
+    stack_.pop_back();
+}
+
+/// <summary>
+/// Rows and cells scanned from <sheetData> which are waiting to be added to the
+/// worksheet. Cells past cell_count are left over from earlier use of the batch
+/// and are kept so that their strings keep their capacity.
+/// </summary>
+struct sheet_data_batch
+{
+    std::vector<std::pair<row_t, row_properties>> rows;
+    std::vector<Cell> cells;
+    std::size_t cell_count = 0;
+};
+
+bool xlsx_consumer::read_worksheet_sheetdata(sheet_data_reader &reader,
+    const std::string &prefix, const std::string &x14ac_prefix)
+{
+    const std::size_t batch_count = 4;
+
+    auto row = row_t(0);
+    const char *first = nullptr;
+    const char *last = nullptr;
+
+    // scans each window of rows into batches, calling publish for each of them;
+    // the scanned text is copied into the batch, so the window can go once it's scanned
+    auto scan_windows = [&](const std::function<sheet_data_batch *()> &acquire,
+                            const std::function<void(sheet_data_batch *)> &publish) {
+        do
+        {
+            sheet_data_scanner scanner(first, last, prefix, x14ac_prefix);
+            auto end_of_data = false;
+
+            while (!end_of_data)
+            {
+                auto batch = acquire();
+
+                if (batch == nullptr)
+                {
+                    return true;
+                }
+
+                auto scanned = scan_sheet_data(scanner, row, *batch, end_of_data);
+                publish(batch);
+
+                if (!scanned)
+                {
+                    return false;
+                }
+            }
+        } while (reader.next(first, last));
+
+        return !reader.failed();
+    };
+
+    if (!reader.next(first, last))
     {
-        current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
+        return !reader.failed();
     }
-    auto impl = detail::cell_impl();
-    for (Cell &cell : ws_data.parsed_cells)
+
+    // when all of sheetData fits in the first window, or without a second core, a second
+    // thread costs more than it saves; worksheets read in parallel already keep the cores busy
+    if (sheet_data_threading_ == sheet_data_threading::never || reader.finished()
+        || (sheet_data_threading_ == sheet_data_threading::automatic && std::thread::hardware_concurrency() < 2))
     {
-        impl.parent_ = current_worksheet_;
-        impl.column_ = cell.ref.column;
-        impl.row_ = cell.ref.row;
-        detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(cell_reference(impl.column_, impl.row_), std::move(impl)).first->second;
-        if (cell.style_index != -1)
+        sheet_data_batch batch;
+
+        return scan_windows([&]() { return &batch; }, [&](sheet_data_batch *scanned) { add_sheet_data(*scanned); });
+    }
+
+    // decompressing and scanning run on their own thread and hand bounded batches
+    // of cells to this one, which converts the values and adds the cells to the worksheet
+    batch_pipeline<sheet_data_batch> pipeline(batch_count);
+    auto scanned = true;
+    std::exception_ptr scanner_exception;
+
+    std::thread scanner_thread([&]() {
+        try
         {
-            ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
+            scanned = scan_windows([&]() { return pipeline.acquire(); },
+                [&](sheet_data_batch *batch) { pipeline.publish(batch); });
         }
-        if (cell.cell_metatdata_idx != -1)
+        catch (...)
         {
+            scanner_exception = std::current_exception();
         }
-        ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
-        if (!cell.formula_string.empty())
+
+        pipeline.finish();
+    });
+
+    try
+    {
+        while (auto batch = pipeline.next())
         {
-            ws_cell_impl->formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
+            add_sheet_data(*batch);
+            pipeline.release(batch);
         }
-        if (!cell.value.empty())
+    }
+    catch (...)
+    {
+        pipeline.cancel();
+        scanner_thread.join();
+        throw;
+    }
+
+    scanner_thread.join();
+
+    if (scanner_exception)
+    {
+        std::rethrow_exception(scanner_exception);
+    }
+
+    return scanned;
+}
+
+bool xlsx_consumer::scan_sheet_data(sheet_data_scanner &scanner, row_t &row, sheet_data_batch &batch, bool &end_of_data)
+{
+    const std::size_t batch_size = 4096;
+
+    batch.rows.clear();
+    batch.cell_count = 0;
+
+    while (batch.cell_count < batch_size)
+    {
+        switch (scanner.next())
         {
-            ws_cell_impl->type_ = cell.type;
-            switch (cell.type)
+        case sheet_data_scanner::event::row: {
+            const auto &scanned = scanner.row();
+            row_properties props;
+
+            if (scanned.dy_descent.present())
             {
-            case cell::type::boolean: {
-                ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
-                break;
+                props.dy_descent = converter_.deserialise(scanned.dy_descent.data, scanned.dy_descent.size);
             }
-            case cell::type::empty:
-            case cell::type::number:
-            case cell::type::date: {
-                ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
-                break;
+            if (scanned.spans.present())
+            {
+                props.spans = scanned.spans.str();
             }
-            case cell::type::shared_string: {
-                ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
-                break;
+            if (scanned.ht.present())
+            {
+                props.height = converter_.deserialise(scanned.ht.data, scanned.ht.size);
             }
-            case cell::type::inline_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+            if (scanned.s.present())
+            {
+                props.style = strtoul(scanned.s.data, nullptr, 10);
             }
-            case cell::type::formula_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+            if (scanned.hidden.present())
+            {
+                props.hidden = is_true(scanned.hidden);
             }
-            case cell::type::error: {
-                ws_cell_impl->value_text_.plain_text(cell.value, false);
-                break;
+            if (scanned.custom_format.present())
+            {
+                props.custom_format = is_true(scanned.custom_format);
             }
+            if (scanned.custom_height.present())
+            {
+                props.custom_height = is_true(scanned.custom_height);
             }
+
+            row = static_cast<row_t>(static_cast<int>(strtol(scanned.r.data, nullptr, 10)));
+            batch.rows.emplace_back(row, std::move(props));
+            break;
+        }
+        case sheet_data_scanner::event::cell: {
+            const auto &scanned = scanner.cell();
+
+            if (batch.cell_count == batch.cells.size())
+            {
+                batch.cells.emplace_back();
+            }
+
+            auto &cell = batch.cells[batch.cell_count++];
+            cell.ref = Cell_Reference(row, scanned.r.data);
+            cell.type = scanned.t.present() ? type_from_string(scanned.t) : cell::type::number;
+            cell.style_index = scanned.s.present() ? static_cast<int>(strtol(scanned.s.data, nullptr, 10)) : -1;
+            cell.is_phonetic = scanned.ph.present() && is_true(scanned.ph);
+            cell.value.assign(scanned.value.data, scanned.value.size);
+            cell.formula_string.assign(scanned.formula.data, scanned.formula.size);
+
+            if (scanned.formula_type.present())
+            {
+                auto shared = scanned.formula_type.equals("shared");
+                auto shared_index = 0;
+
+                if (shared && !parse_int(scanned.formula_shared_index, shared_index))
+                {
+                    return false;
+                }
+
+                // see parse_cell, cells using a shared formula have no text and no ref
+                if (shared && !scanned.formula_ref.present())
+                {
+                    cell.formula_string = shared_formulae_[shared_index];
+                }
+                else if (!scanned.formula.empty() && shared)
+                {
+                    shared_formulae_[shared_index] = cell.formula_string;
+                }
+                else if (!scanned.formula.empty() && scanned.formula_type.equals("array"))
+                {
+                    array_formulae_[scanned.formula_ref.str()] = cell.formula_string;
+                }
+            }
+
+            break;
+        }
+        case sheet_data_scanner::event::end_of_data:
+            end_of_data = true;
+            return true;
+        case sheet_data_scanner::event::unsupported:
+            return false;
         }
     }
-    stack_.pop_back();
-    
-    
+
+    return true;
+}
+
+void xlsx_consumer::add_sheet_data(sheet_data_batch &batch)
+{
+    for (auto &row : batch.rows)
+    {
+        current_worksheet_->row_properties_.emplace(row.first, std::move(row.second));
+        current_worksheet_->row_properties_added(row.first);
+    }
+
+    for (std::size_t i = 0; i < batch.cell_count; ++i)
+    {
+        add_cell(batch.cells[i]);
+    }
+}
+
+void xlsx_consumer::add_cell(Cell &cell)
+{
+    // throws for row or column 0, which is what a missing r attribute parses to
+    const auto reference = cell_reference(cell.ref.column, cell.ref.row);
+    detail::cell_impl *ws_cell_impl = current_worksheet_->cells_.emplace(
+        reference.column_index(), reference.row()).first;
+    ws_cell_impl->parent_ = current_worksheet_;
+    if (cell.style_index != -1 && !options_.skip_styles)
+    {
+        ws_cell_impl->format_ = target_->format(static_cast<size_t>(cell.style_index)).d_;
+    }
+    if (cell.cell_metatdata_idx != -1)
+    {
+    }
+    ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
+    if (!cell.formula_string.empty() && !options_.values_only)
+    {
+        ws_cell_impl->extension().formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
+    }
+    if (!cell.value.empty())
+    {
+        ws_cell_impl->type_ = cell.type;
+        switch (cell.type)
+        {
+        case cell::type::boolean: {
+            ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
+            break;
+        }
+        case cell::type::empty:
+        case cell::type::number:
+        case cell::type::date: {
+            ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
+            break;
+        }
+        case cell::type::shared_string: {
+            ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
+            break;
+        }
+        case cell::type::inline_string: {
+            ws_cell_impl->extension().value_text_ = std::move(cell.value);
+            break;
+        }
+        case cell::type::formula_string: {
+            ws_cell_impl->extension().value_text_ = std::move(cell.value);
+            break;
+        }
+        case cell::type::error: {
+            ws_cell_impl->extension().value_text_.plain_text(cell.value, false);
+            break;
+        }
+        }
+    }
+}
+
+void xlsx_consumer::reserve_worksheet(const std::string &dimension)
+{
+    // a dimension can cover far more cells than a sparse worksheet has,
+    // so it's only trusted up to this many cells or rows
+    const std::size_t max_reserved = 65536;
+
+    range_reference range;
+
+    try
+    {
+        range = range_reference(dimension);
+    }
+    catch (const xlnt::exception &)
+    {
+        return;
+    }
+
+    if (range.bottom_right().row() < range.top_left().row()
+        || range.bottom_right().column() < range.top_left().column())
+    {
+        return;
+    }
+
+    const auto height = std::min(static_cast<std::size_t>(range.height()), max_reserved);
+    const auto width = static_cast<std::size_t>(range.width());
+    const auto row_size = std::min(width, max_reserved / height);
+
+    current_worksheet_->cells_.reserve(row_size * height);
+    current_worksheet_->cells_.reserve_rows(height, row_size);
+    current_worksheet_->row_properties_.reserve(height);
 }
 
 worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 {
-    auto &manifest = target_.manifest();
+    // sheetData has been read, rows added to the worksheet later get no reserved room
+    current_worksheet_->cells_.clear_row_reservation();
+
+    auto &manifest = target_->manifest();
 
     const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
     const auto sheet_rel = manifest.relationship(workbook_rel.target().path(), rel_id);
@@ -914,88 +1300,88 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
     auto ws = worksheet(current_worksheet_);
 
-    while (in_element(qn("spreadsheetml", "worksheet")))
+    while (in_element(XLNT_QN("spreadsheetml", "worksheet")))
     {
         auto current_worksheet_element = expect_start_element(xml::content::complex);
 
-        if (current_worksheet_element == qn("spreadsheetml", "sheetCalcPr")) // CT_SheetCalcPr 0-1
+        if (current_worksheet_element == XLNT_QN("spreadsheetml", "sheetCalcPr")) // CT_SheetCalcPr 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "sheetProtection")) // CT_SheetProtection 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "sheetProtection")) // CT_SheetProtection 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "protectedRanges")) // CT_ProtectedRanges 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "protectedRanges")) // CT_ProtectedRanges 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "scenarios")) // CT_Scenarios 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "scenarios")) // CT_Scenarios 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "autoFilter")) // CT_AutoFilter 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "autoFilter")) // CT_AutoFilter 0-1
         {
-            ws.auto_filter(xlnt::range_reference(parser().attribute("ref")));
+            ws.auto_filter(xlnt::range_reference(parser().attribute(XLNT_ATTRIBUTE_QN("ref"))));
             // auto filter complex
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "sortState")) // CT_SortState 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "sortState")) // CT_SortState 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "dataConsolidate")) // CT_DataConsolidate 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "dataConsolidate")) // CT_DataConsolidate 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "customSheetViews")) // CT_CustomSheetViews 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "customSheetViews")) // CT_CustomSheetViews 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "mergeCells")) // CT_MergeCells 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "mergeCells")) // CT_MergeCells 0-1
         {
             parser().attribute_map();
 
-            while (in_element(qn("spreadsheetml", "mergeCells")))
+            while (in_element(XLNT_QN("spreadsheetml", "mergeCells")))
             {
-                expect_start_element(qn("spreadsheetml", "mergeCell"), xml::content::simple);
-                ws.merge_cells(range_reference(parser().attribute("ref")));
-                expect_end_element(qn("spreadsheetml", "mergeCell"));
+                expect_start_element(XLNT_QN("spreadsheetml", "mergeCell"), xml::content::simple);
+                ws.merge_cells(range_reference(parser().attribute(XLNT_ATTRIBUTE_QN("ref"))));
+                expect_end_element(XLNT_QN("spreadsheetml", "mergeCell"));
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "phoneticPr")) // CT_PhoneticPr 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "phoneticPr")) // CT_PhoneticPr 0-1
         {
-            phonetic_pr phonetic_properties(parser().attribute<std::uint32_t>("fontId"));
-            if (parser().attribute_present("type"))
+            phonetic_pr phonetic_properties(parser().attribute<std::uint32_t>(XLNT_ATTRIBUTE_QN("fontId")));
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("type")))
             {
-                phonetic_properties.type(phonetic_pr::type_from_string(parser().attribute("type")));
+                phonetic_properties.type(phonetic_pr::type_from_string(parser().attribute(XLNT_ATTRIBUTE_QN("type"))));
             }
-            if (parser().attribute_present("alignment"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("alignment")))
             {
-                phonetic_properties.alignment(phonetic_pr::alignment_from_string(parser().attribute("alignment")));
+                phonetic_properties.alignment(phonetic_pr::alignment_from_string(parser().attribute(XLNT_ATTRIBUTE_QN("alignment"))));
             }
             current_worksheet_->phonetic_properties_.set(phonetic_properties);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "conditionalFormatting")) // CT_ConditionalFormatting 0+
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "conditionalFormatting")) // CT_ConditionalFormatting 0+
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "dataValidations")) // CT_DataValidations 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "dataValidations")) // CT_DataValidations 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "hyperlinks")) // CT_Hyperlinks 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "hyperlinks")) // CT_Hyperlinks 0-1
         {
             while (in_element(current_worksheet_element))
             {
                 // CT_Hyperlink
-                expect_start_element(qn("spreadsheetml", "hyperlink"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "hyperlink"), xml::content::simple);
 
-                auto cell = ws.cell(parser().attribute("ref"));
+                auto cell = ws.cell(parser().attribute(XLNT_ATTRIBUTE_QN("ref")));
 
-                if (parser().attribute_present(qn("r", "id")))
+                if (parser().attribute_present(XLNT_QN("r", "id")))
                 {
-                    auto hyperlink_rel_id = parser().attribute(qn("r", "id"));
+                    auto hyperlink_rel_id = parser().attribute(XLNT_QN("r", "id"));
                     auto hyperlink_rel = std::find_if(hyperlinks.begin(), hyperlinks.end(),
                         [&](const relationship &r) { return r.id() == hyperlink_rel_id; });
 
@@ -1013,111 +1399,111 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
                         }
                     }
                 }
-                else if (parser().attribute_present("location"))
+                else if (parser().attribute_present(XLNT_ATTRIBUTE_QN("location")))
                 {
                     auto hyperlink = hyperlink_impl();
 
-                    auto location = parser().attribute("location");
+                    auto location = parser().attribute(XLNT_ATTRIBUTE_QN("location"));
                     hyperlink.relationship = relationship("", relationship_type::hyperlink,
                         uri(""), uri(location), target_mode::internal);
 
-                    if (parser().attribute_present("display"))
+                    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("display")))
                     {
-                        hyperlink.display = parser().attribute("display");
+                        hyperlink.display = parser().attribute(XLNT_ATTRIBUTE_QN("display"));
                     }
 
-                    if (parser().attribute_present("tooltip"))
+                    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("tooltip")))
                     {
-                        hyperlink.tooltip = parser().attribute("tooltip");
+                        hyperlink.tooltip = parser().attribute(XLNT_ATTRIBUTE_QN("tooltip"));
                     }
 
-                    cell.d_->hyperlink_ = hyperlink;
+                    cell.d_->extension().hyperlink_ = hyperlink;
                 }
 
-                expect_end_element(qn("spreadsheetml", "hyperlink"));
+                expect_end_element(XLNT_QN("spreadsheetml", "hyperlink"));
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "printOptions")) // CT_PrintOptions 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "printOptions")) // CT_PrintOptions 0-1
         {
             print_options opts;
-            if (parser().attribute_present("gridLines"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("gridLines")))
             {
-                opts.print_grid_lines.set(parser().attribute<bool>("gridLines"));
+                opts.print_grid_lines.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("gridLines")));
             }
-            if (parser().attribute_present("gridLinesSet"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("gridLinesSet")))
             {
-                opts.grid_lines_set.set(parser().attribute<bool>("gridLinesSet"));
+                opts.grid_lines_set.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("gridLinesSet")));
             }
-            if (parser().attribute_present("headings"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("headings")))
             {
-                opts.print_headings.set(parser().attribute<bool>("headings"));
+                opts.print_headings.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("headings")));
             }
-            if (parser().attribute_present("horizontalCentered"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("horizontalCentered")))
             {
-                opts.horizontal_centered.set(parser().attribute<bool>("horizontalCentered"));
+                opts.horizontal_centered.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("horizontalCentered")));
             }
-            if (parser().attribute_present("verticalCentered"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("verticalCentered")))
             {
-                opts.vertical_centered.set(parser().attribute<bool>("verticalCentered"));
+                opts.vertical_centered.set(parser().attribute<bool>(XLNT_ATTRIBUTE_QN("verticalCentered")));
             }
             ws.d_->print_options_.set(opts);
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "pageMargins")) // CT_PageMargins 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "pageMargins")) // CT_PageMargins 0-1
         {
             page_margins margins;
 
-            margins.top(converter_.deserialise(parser().attribute("top")));
-            margins.bottom(converter_.deserialise(parser().attribute("bottom")));
-            margins.left(converter_.deserialise(parser().attribute("left")));
-            margins.right(converter_.deserialise(parser().attribute("right")));
-            margins.header(converter_.deserialise(parser().attribute("header")));
-            margins.footer(converter_.deserialise(parser().attribute("footer")));
+            margins.top(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("top"))));
+            margins.bottom(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("bottom"))));
+            margins.left(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("left"))));
+            margins.right(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("right"))));
+            margins.header(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("header"))));
+            margins.footer(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("footer"))));
 
             ws.page_margins(margins);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "pageSetup")) // CT_PageSetup 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "pageSetup")) // CT_PageSetup 0-1
         {
             page_setup setup;
-            if (parser().attribute_present("orientation"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("orientation")))
             {
-                setup.orientation_.set(parser().attribute<orientation>("orientation"));
+                setup.orientation_.set(parser().attribute<orientation>(XLNT_ATTRIBUTE_QN("orientation")));
             }
-            if (parser().attribute_present("horizontalDpi"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("horizontalDpi")))
             {
-                setup.horizontal_dpi_.set(parser().attribute<std::size_t>("horizontalDpi"));
+                setup.horizontal_dpi_.set(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("horizontalDpi")));
             }
-            if (parser().attribute_present("verticalDpi"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("verticalDpi")))
             {
-                setup.vertical_dpi_.set(parser().attribute<std::size_t>("verticalDpi"));
+                setup.vertical_dpi_.set(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("verticalDpi")));
             }
-            if (parser().attribute_present("paperSize"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("paperSize")))
             {
-                setup.paper_size(static_cast<xlnt::paper_size>(parser().attribute<std::size_t>("paperSize")));
+                setup.paper_size(static_cast<xlnt::paper_size>(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("paperSize"))));
             }
-            if (parser().attribute_present("scale"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("scale")))
             {
-                setup.scale(parser().attribute<double>("scale"));
+                setup.scale(parser().attribute<double>(XLNT_ATTRIBUTE_QN("scale")));
             }
-            if (parser().attribute_present(qn("r", "id")))
+            if (parser().attribute_present(XLNT_QN("r", "id")))
             {
-                setup.rel_id(parser().attribute(qn("r", "id")));
+                setup.rel_id(parser().attribute(XLNT_QN("r", "id")));
             }
             ws.page_setup(setup);
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "headerFooter")) // CT_HeaderFooter 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "headerFooter")) // CT_HeaderFooter 0-1
         {
             header_footer hf;
 
-            hf.align_with_margins(!parser().attribute_present("alignWithMargins")
-                || is_true(parser().attribute("alignWithMargins")));
-            hf.scale_with_doc(!parser().attribute_present("alignWithMargins")
-                || is_true(parser().attribute("alignWithMargins")));
-            auto different_odd_even = parser().attribute_present("differentOddEven")
-                && is_true(parser().attribute("differentOddEven"));
-            auto different_first = parser().attribute_present("differentFirst")
-                && is_true(parser().attribute("differentFirst"));
+            hf.align_with_margins(!parser().attribute_present(XLNT_ATTRIBUTE_QN("alignWithMargins"))
+                || is_true(parser().attribute(XLNT_ATTRIBUTE_QN("alignWithMargins"))));
+            hf.scale_with_doc(!parser().attribute_present(XLNT_ATTRIBUTE_QN("alignWithMargins"))
+                || is_true(parser().attribute(XLNT_ATTRIBUTE_QN("alignWithMargins"))));
+            auto different_odd_even = parser().attribute_present(XLNT_ATTRIBUTE_QN("differentOddEven"))
+                && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("differentOddEven")));
+            auto different_first = parser().attribute_present(XLNT_ATTRIBUTE_QN("differentFirst"))
+                && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("differentFirst")));
 
             optional<std::array<optional<rich_text>, 3>> odd_header;
             optional<std::array<optional<rich_text>, 3>> odd_footer;
@@ -1132,27 +1518,27 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
             {
                 auto current_hf_element = expect_start_element(xml::content::simple);
 
-                if (current_hf_element == qn("spreadsheetml", "oddHeader"))
+                if (current_hf_element == XLNT_QN("spreadsheetml", "oddHeader"))
                 {
                     odd_header = decode_header_footer(read_text(), converter_);
                 }
-                else if (current_hf_element == qn("spreadsheetml", "oddFooter"))
+                else if (current_hf_element == XLNT_QN("spreadsheetml", "oddFooter"))
                 {
                     odd_footer = decode_header_footer(read_text(), converter_);
                 }
-                else if (current_hf_element == qn("spreadsheetml", "evenHeader"))
+                else if (current_hf_element == XLNT_QN("spreadsheetml", "evenHeader"))
                 {
                     even_header = decode_header_footer(read_text(), converter_);
                 }
-                else if (current_hf_element == qn("spreadsheetml", "evenFooter"))
+                else if (current_hf_element == XLNT_QN("spreadsheetml", "evenFooter"))
                 {
                     even_footer = decode_header_footer(read_text(), converter_);
                 }
-                else if (current_hf_element == qn("spreadsheetml", "firstHeader"))
+                else if (current_hf_element == XLNT_QN("spreadsheetml", "firstHeader"))
                 {
                     first_header = decode_header_footer(read_text(), converter_);
                 }
-                else if (current_hf_element == qn("spreadsheetml", "firstFooter"))
+                else if (current_hf_element == XLNT_QN("spreadsheetml", "firstFooter"))
                 {
                     first_footer = decode_header_footer(read_text(), converter_);
                 }
@@ -1207,87 +1593,87 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
             ws.header_footer(hf);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "rowBreaks")) // CT_PageBreak 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "rowBreaks")) // CT_PageBreak 0-1
         {
-            auto count = parser().attribute_present("count") ? parser().attribute<std::size_t>("count") : 0;
-            auto manual_break_count = parser().attribute_present("manualBreakCount")
-                ? parser().attribute<std::size_t>("manualBreakCount")
+            auto count = parser().attribute_present(XLNT_ATTRIBUTE_QN("count")) ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count")) : 0;
+            auto manual_break_count = parser().attribute_present(XLNT_ATTRIBUTE_QN("manualBreakCount"))
+                ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("manualBreakCount"))
                 : 0;
 
-            while (in_element(qn("spreadsheetml", "rowBreaks")))
+            while (in_element(XLNT_QN("spreadsheetml", "rowBreaks")))
             {
-                expect_start_element(qn("spreadsheetml", "brk"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "brk"), xml::content::simple);
 
-                if (parser().attribute_present("id"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("id")))
                 {
-                    ws.page_break_at_row(parser().attribute<row_t>("id"));
+                    ws.page_break_at_row(parser().attribute<row_t>(XLNT_ATTRIBUTE_QN("id")));
                     --count;
                 }
 
-                if (parser().attribute_present("man") && is_true(parser().attribute("man")))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("man")) && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("man"))))
                 {
                     --manual_break_count;
                 }
 
-                skip_attributes({"min", "max", "pt"});
-                expect_end_element(qn("spreadsheetml", "brk"));
+                skip_attributes({XLNT_ATTRIBUTE_QN("min"), XLNT_ATTRIBUTE_QN("max"), XLNT_ATTRIBUTE_QN("pt")});
+                expect_end_element(XLNT_QN("spreadsheetml", "brk"));
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "colBreaks")) // CT_PageBreak 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "colBreaks")) // CT_PageBreak 0-1
         {
-            auto count = parser().attribute_present("count") ? parser().attribute<std::size_t>("count") : 0;
-            auto manual_break_count = parser().attribute_present("manualBreakCount")
-                ? parser().attribute<std::size_t>("manualBreakCount")
+            auto count = parser().attribute_present(XLNT_ATTRIBUTE_QN("count")) ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count")) : 0;
+            auto manual_break_count = parser().attribute_present(XLNT_ATTRIBUTE_QN("manualBreakCount"))
+                ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("manualBreakCount"))
                 : 0;
 
-            while (in_element(qn("spreadsheetml", "colBreaks")))
+            while (in_element(XLNT_QN("spreadsheetml", "colBreaks")))
             {
-                expect_start_element(qn("spreadsheetml", "brk"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "brk"), xml::content::simple);
 
-                if (parser().attribute_present("id"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("id")))
                 {
-                    ws.page_break_at_column(parser().attribute<column_t::index_t>("id"));
+                    ws.page_break_at_column(parser().attribute<column_t::index_t>(XLNT_ATTRIBUTE_QN("id")));
                     --count;
                 }
 
-                if (parser().attribute_present("man") && is_true(parser().attribute("man")))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("man")) && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("man"))))
                 {
                     --manual_break_count;
                 }
 
-                skip_attributes({"min", "max", "pt"});
-                expect_end_element(qn("spreadsheetml", "brk"));
+                skip_attributes({XLNT_ATTRIBUTE_QN("min"), XLNT_ATTRIBUTE_QN("max"), XLNT_ATTRIBUTE_QN("pt")});
+                expect_end_element(XLNT_QN("spreadsheetml", "brk"));
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "customProperties")) // CT_CustomProperties 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "customProperties")) // CT_CustomProperties 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "cellWatches")) // CT_CellWatches 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "cellWatches")) // CT_CellWatches 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "ignoredErrors")) // CT_IgnoredErrors 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "ignoredErrors")) // CT_IgnoredErrors 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "smartTags")) // CT_SmartTags 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "smartTags")) // CT_SmartTags 0-1
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "drawing")) // CT_Drawing 0-1
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "drawing")) // CT_Drawing 0-1
         {
-            if (parser().attribute_present(qn("r", "id")))
+            if (parser().attribute_present(XLNT_QN("r", "id")))
             {
-                auto drawing_rel_id = parser().attribute(qn("r", "id"));
+                auto drawing_rel_id = parser().attribute(XLNT_QN("r", "id"));
                 ws.d_->drawing_rel_id_ = drawing_rel_id;
             }
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "legacyDrawing"))
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "legacyDrawing"))
         {
             skip_remaining_content(current_worksheet_element);
         }
-        else if (current_worksheet_element == qn("spreadsheetml", "extLst"))
+        else if (current_worksheet_element == XLNT_QN("spreadsheetml", "extLst"))
         {
             ext_list extensions(parser(), current_worksheet_element.namespace_());
             ws.d_->extension_list_.set(extensions);
@@ -1300,9 +1686,9 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         expect_end_element(current_worksheet_element);
     }
 
-    expect_end_element(qn("spreadsheetml", "worksheet"));
+    expect_end_element(XLNT_QN("spreadsheetml", "worksheet"));
 
-    if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments))
+    if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments) && !options_.skip_comments)
     {
         auto comments_part = manifest.canonicalize({workbook_rel, sheet_rel,
             manifest.relationship(sheet_path, xlnt::relationship_type::comments)});
@@ -1329,7 +1715,11 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         }
     }
 
-    if (manifest.has_relationship(sheet_path, xlnt::relationship_type::drawings))
+    if (manifest.has_relationship(sheet_path, xlnt::relationship_type::drawings) && options_.skip_images)
+    {
+        target_->d_->skipped_parts_ = true;
+    }
+    else if (manifest.has_relationship(sheet_path, xlnt::relationship_type::drawings))
     {
         auto drawings_part = manifest.canonicalize({workbook_rel, sheet_rel,
             manifest.relationship(sheet_path, xlnt::relationship_type::drawings)});
@@ -1349,9 +1739,11 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
             manifest.relationship(sheet_path,
                 relationship_type::printer_settings)});
     }
-    
+
     for (auto array_formula : array_formulae_)
     {
+        if (options_.values_only) continue;
+
         for (auto row : ws.range(array_formula.first))
         {
             for (auto cell : row)
@@ -1374,57 +1766,56 @@ bool xlsx_consumer::has_cell()
     auto ws = worksheet(current_worksheet_);
 
     while (streaming_cell_ // we're not at the end of the file
-           && !in_element(qn("spreadsheetml", "row"))) // we're at the end of a row, or between rows
+           && !in_element(XLNT_QN("spreadsheetml", "row"))) // we're at the end of a row, or between rows
     {
         if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "row"))
+            && stack_.back() == XLNT_QN("spreadsheetml", "row"))
         {
             // We're at the end of a row.
-            expect_end_element(qn("spreadsheetml", "row"));
+            expect_end_element(XLNT_QN("spreadsheetml", "row"));
             // ... and keep parsing.
         }
 
         if (parser().peek() == xml::parser::event_type::end_element
-            && stack_.back() == qn("spreadsheetml", "sheetData"))
+            && stack_.back() == XLNT_QN("spreadsheetml", "sheetData"))
         {
             // End of sheet. Mark it by setting streaming_cell_ to nullptr, so we never get here again.
-            expect_end_element(qn("spreadsheetml", "sheetData"));
+            expect_end_element(XLNT_QN("spreadsheetml", "sheetData"));
             streaming_cell_.reset(nullptr);
             break;
         }
 
-        expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        auto row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
-        auto &row_properties = ws.row_properties(row_index);
+        expect_start_element(XLNT_QN("spreadsheetml", "row"), xml::content::complex); // CT_Row
+        streaming_row_ = static_cast<row_t>(std::strtoul(parser().attribute(XLNT_ATTRIBUTE_QN("r")).c_str(), nullptr, 10));
+        auto &row_properties = ws.row_properties(streaming_row_);
 
-        if (parser().attribute_present("ht"))
+        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("ht")))
         {
-            row_properties.height = converter_.deserialise(parser().attribute("ht"));
+            row_properties.height = converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("ht")));
         }
 
-        if (parser().attribute_present("customHeight"))
+        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("customHeight")))
         {
-            row_properties.custom_height = is_true(parser().attribute("customHeight"));
+            row_properties.custom_height = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("customHeight")));
         }
 
-        if (parser().attribute_present("hidden") && is_true(parser().attribute("hidden")))
+        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("hidden")) && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("hidden"))))
         {
             row_properties.hidden = true;
         }
 
-        if (parser().attribute_present(qn("x14ac", "dyDescent")))
+        if (parser().attribute_present(XLNT_QN("x14ac", "dyDescent")))
         {
-            row_properties.dy_descent = converter_.deserialise(parser().attribute(qn("x14ac", "dyDescent")));
+            row_properties.dy_descent = converter_.deserialise(parser().attribute(XLNT_QN("x14ac", "dyDescent")));
         }
 
-        if (parser().attribute_present("spans"))
+        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("spans")))
         {
-            row_properties.spans = parser().attribute("spans");
+            row_properties.spans = parser().attribute(XLNT_ATTRIBUTE_QN("spans"));
         }
 
-        skip_attributes({"customFormat", "s", "customFont",
-            "outlineLevel", "collapsed", "thickTop", "thickBot",
-            "ph"});
+        // like the other sheetData readers, the remaining row attributes are ignored
+        skip_attributes();
     }
 
     if (!streaming_cell_)
@@ -1433,43 +1824,48 @@ bool xlsx_consumer::has_cell()
         return false;
     }
 
-    expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
+    expect_start_element(XLNT_QN("spreadsheetml", "c"), xml::content::complex);
 
     assert(streaming_);
-    streaming_cell_.reset(new detail::cell_impl()); // Clean cell state - otherwise it might contain information from the previously streamed cell.
+    // Clean cell state - otherwise it might contain information from the previously streamed cell.
+    // The slot and its extension are reused so that streaming doesn't allocate for every cell.
+    streaming_cell_->clear();
     auto cell = xlnt::cell(streaming_cell_.get());
-    auto reference = cell_reference(parser().attribute("r"));
+    const auto reference = Cell_Reference(streaming_row_, parser().attribute(XLNT_ATTRIBUTE_QN("r")));
     cell.d_->parent_ = current_worksheet_;
-    cell.d_->column_ = reference.column_index();
-    cell.d_->row_ = reference.row();
+    cell.d_->column_ = reference.column;
+    cell.d_->row_ = reference.row;
 
-    if (parser().attribute_present("ph"))
+    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("ph")))
     {
-        cell.d_->phonetics_visible_ = parser().attribute<bool>("ph");
+        cell.d_->phonetics_visible_ = parser().attribute<bool>(XLNT_ATTRIBUTE_QN("ph"));
     }
 
-    auto has_type = parser().attribute_present("t");
-    auto type = has_type ? parser().attribute("t") : "n";
+    static const std::string numeric_type = "n";
+    // copied because the attribute goes away with the end of <c>, short enough not to allocate
+    const auto type = parser().attribute_present(XLNT_ATTRIBUTE_QN("t")) ? parser().attribute(XLNT_ATTRIBUTE_QN("t")) : numeric_type;
 
-    if (parser().attribute_present("s"))
+    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("s")))
     {
-        cell.format(target_.format(static_cast<std::size_t>(std::stoull(parser().attribute("s")))));
+        cell.format(target_->format(static_cast<std::size_t>(std::strtoull(parser().attribute(XLNT_ATTRIBUTE_QN("s")).c_str(), nullptr, 10))));
     }
 
     auto has_value = false;
-    auto value_string = std::string();
-    auto formula_string = std::string();
+    auto &value_string = streaming_value_;
+    auto &formula_string = streaming_formula_;
+    value_string.clear();
+    formula_string.clear();
 
-    while (in_element(qn("spreadsheetml", "c")))
+    while (in_element(XLNT_QN("spreadsheetml", "c")))
     {
         auto current_element = expect_start_element(xml::content::mixed);
 
-        if (current_element == qn("spreadsheetml", "v")) // s:ST_Xstring
+        if (current_element == XLNT_QN("spreadsheetml", "v")) // s:ST_Xstring
         {
             has_value = true;
-            value_string = read_text();
+            read_text(value_string);
         }
-        else if (current_element == qn("spreadsheetml", "f")) // CT_CellFormula
+        else if (current_element == XLNT_QN("spreadsheetml", "f")) // CT_CellFormula
         {
             auto has_shared_formula = false;
             auto has_array_formula = false;
@@ -1477,14 +1873,14 @@ bool xlsx_consumer::has_cell()
             auto shared_formula_index = 0;
             auto formula_range = range_reference();
 
-            if (parser().attribute_present("t"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("t")))
             {
-                auto formula_type = parser().attribute("t");
+                auto formula_type = parser().attribute(XLNT_ATTRIBUTE_QN("t"));
                 if (formula_type == "shared")
                 {
                     has_shared_formula = true;
-                    shared_formula_index = parser().attribute<int>("si");
-                    if (parser().attribute_present("ref"))
+                    shared_formula_index = parser().attribute<int>(XLNT_ATTRIBUTE_QN("si"));
+                    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("ref")))
                     {
                         is_master_cell = true;
                     }
@@ -1492,16 +1888,15 @@ bool xlsx_consumer::has_cell()
                 else if (formula_type == "array")
                 {
                     has_array_formula = true;
-                    formula_range = range_reference(parser().attribute("ref"));
+                    formula_range = range_reference(parser().attribute(XLNT_ATTRIBUTE_QN("ref")));
                     is_master_cell = true;
                 }
             }
 
-            skip_attributes({"aca", "dt2D", "dtr", "del1", "del2", "r1",
-                "r2", "ca", "bx"});
+            skip_attributes();
+
+            read_text(formula_string);
 
-            formula_string = read_text();
-            
             if (is_master_cell)
             {
                 if (has_shared_formula)
@@ -1522,12 +1917,12 @@ bool xlsx_consumer::has_cell()
                 }
             }
         }
-        else if (current_element == qn("spreadsheetml", "is")) // CT_Rst
+        else if (current_element == XLNT_QN("spreadsheetml", "is")) // CT_Rst
         {
-            expect_start_element(qn("spreadsheetml", "t"), xml::content::simple);
+            expect_start_element(XLNT_QN("spreadsheetml", "t"), xml::content::simple);
             has_value = true;
-            value_string = read_text();
-            expect_end_element(qn("spreadsheetml", "t"));
+            read_text(value_string);
+            expect_end_element(XLNT_QN("spreadsheetml", "t"));
         }
         else
         {
@@ -1537,7 +1932,7 @@ bool xlsx_consumer::has_cell()
         expect_end_element(current_element);
     }
 
-    expect_end_element(qn("spreadsheetml", "c"));
+    expect_end_element(XLNT_QN("spreadsheetml", "c"));
 
     if (!formula_string.empty())
     {
@@ -1548,12 +1943,12 @@ bool xlsx_consumer::has_cell()
     {
         if (type == "str")
         {
-            cell.d_->value_text_ = value_string;
+            cell.d_->extension().value_text_.plain_text(value_string, false);
             cell.data_type(cell::type::formula_string);
         }
         else if (type == "inlineStr")
         {
-            cell.d_->value_text_ = value_string;
+            cell.d_->extension().value_text_.plain_text(value_string, false);
             cell.data_type(cell::type::inline_string);
         }
         else if (type == "s")
@@ -1590,43 +1985,205 @@ std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
     xml::parser parser(rels_stream, part_rels_path.string());
     parser_ = &parser;
 
-    expect_start_element(qn("relationships", "Relationships"), xml::content::complex);
+    expect_start_element(XLNT_QN("relationships", "Relationships"), xml::content::complex);
 
-    while (in_element(qn("relationships", "Relationships")))
+    while (in_element(XLNT_QN("relationships", "Relationships")))
     {
-        expect_start_element(qn("relationships", "Relationship"), xml::content::simple);
+        expect_start_element(XLNT_QN("relationships", "Relationship"), xml::content::simple);
 
-        const auto target_mode = parser.attribute_present("TargetMode")
-            ? parser.attribute<xlnt::target_mode>("TargetMode")
+        const auto target_mode = parser.attribute_present(XLNT_ATTRIBUTE_QN("TargetMode"))
+            ? parser.attribute<xlnt::target_mode>(XLNT_ATTRIBUTE_QN("TargetMode"))
             : xlnt::target_mode::internal;
-        auto target = xlnt::uri(parser.attribute("Target"));
+        auto target = xlnt::uri(parser.attribute(XLNT_ATTRIBUTE_QN("Target")));
 
         if (target.path().is_absolute() && target_mode == xlnt::target_mode::internal)
         {
             target = uri(target.path().relative_to(path(part.string()).resolve(path("/"))).string());
         }
 
-        relationships.emplace_back(parser.attribute("Id"),
-            parser.attribute<xlnt::relationship_type>("Type"),
+        relationships.emplace_back(parser.attribute(XLNT_ATTRIBUTE_QN("Id")),
+            parser.attribute<xlnt::relationship_type>(XLNT_ATTRIBUTE_QN("Type")),
             xlnt::uri(part.string()), target, target_mode);
 
-        expect_end_element(qn("relationships", "Relationship"));
+        expect_end_element(XLNT_QN("relationships", "Relationship"));
     }
 
-    expect_end_element(qn("relationships", "Relationships"));
+    expect_end_element(XLNT_QN("relationships", "Relationships"));
     parser_ = nullptr;
 
     return relationships;
 }
 
+void xlsx_consumer::read_worksheet_data(std::istream &part_stream, std::string &part_data,
+    const std::function<std::unique_ptr<std::streambuf>()> &reopen_part)
+{
+    // cells are read from sheetData directly, the XML parser sees the rest of the part
+    // with an empty sheetData unless the scanner gives up
+    array_formulae_.clear();
+    shared_formulae_.clear();
+
+    sheet_data_reader reader(part_stream, part_data, sheet_data_window_size_);
+    std::string prefix;
+
+    if (!reader.open(prefix))
+    {
+        return;
+    }
+
+    std::string dimension;
+
+    if (sheet_data_scanner::find_dimension(part_data.data(), part_data.data() + part_data.size(), prefix, dimension))
+    {
+        reserve_worksheet(dimension);
+    }
+
+    // the scanner only accepts x14ac:dyDescent if it knows the prefix to be bound
+    std::string x14ac_prefix;
+    sheet_data_scanner::find_namespace_prefix(part_data.data(), part_data.data() + part_data.size(),
+        constants::ns("x14ac"), x14ac_prefix);
+
+    if (read_worksheet_sheetdata(reader, prefix, x14ac_prefix))
+    {
+        return;
+    }
+
+    // the scanner gave up after earlier rows were already discarded,
+    // so the XML parser reads the whole part again from the start
+    current_worksheet_->cells_.clear();
+    current_worksheet_->row_properties_.clear();
+    current_worksheet_->row_properties_removed();
+    array_formulae_.clear();
+    shared_formulae_.clear();
+    part_data.clear();
+
+    auto part_streambuf = reopen_part();
+    std::istream stream(part_streambuf.get());
+    char chunk[65536];
+
+    while (stream.read(chunk, sizeof(chunk)) || stream.gcount() > 0)
+    {
+        part_data.append(chunk, static_cast<std::size_t>(stream.gcount()));
+    }
+}
+
+void xlsx_consumer::prepare_worksheets(const std::vector<std::pair<path, worksheet_impl *>> &worksheets)
+{
+    auto thread_count = options_.worksheet_threads;
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    thread_count = thread_count < worksheets.size() ? thread_count : worksheets.size();
+
+    // each worksheet gets its own consumer so that formulae and scanner state
+    // aren't shared; they're constructed here since the constructor isn't thread-safe
+    std::vector<std::unique_ptr<xlsx_consumer>> consumers;
+    std::vector<std::unique_ptr<prepared_worksheet>> results(worksheets.size());
+    std::vector<std::exception_ptr> errors(worksheets.size());
+
+    for (const auto &worksheet : worksheets)
+    {
+        consumers.emplace_back(new xlsx_consumer(*target_));
+        consumers.back()->current_worksheet_ = worksheet.second;
+        consumers.back()->options_ = options_;
+        consumers.back()->sheet_data_window_size_ = sheet_data_window_size_;
+        consumers.back()->sheet_data_threading_ = sheet_data_threading::never;
+    }
+
+    std::atomic<std::size_t> next_worksheet(0);
+    std::mutex archive_mutex;
+
+    auto read_worksheets = [&]() {
+        for (auto i = next_worksheet++; i < worksheets.size(); i = next_worksheet++)
+        {
+            try
+            {
+                auto open_part = [&]() {
+                    std::lock_guard<std::mutex> lock(archive_mutex);
+                    return archive_->open_detached(worksheets[i].first);
+                };
+
+                auto part_streambuf = open_part();
+                std::istream part_stream(part_streambuf.get());
+                std::unique_ptr<prepared_worksheet> result(new prepared_worksheet());
+                auto &consumer = *consumers[i];
+
+                consumer.read_worksheet_data(part_stream, result->part_data, open_part);
+                result->shared_formulae = std::move(consumer.shared_formulae_);
+                result->array_formulae = std::move(consumer.array_formulae_);
+                results[i] = std::move(result);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(read_worksheets);
+    }
+
+    read_worksheets();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // report the error a serial load would have hit first
+    for (auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (std::size_t i = 0; i < worksheets.size(); ++i)
+    {
+        prepared_worksheets_[worksheets[i].second] = std::move(results[i]);
+    }
+}
+
 void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
 {
-    const auto &manifest = target_.manifest();
+    const auto &manifest = target_->manifest();
     const auto part_path = manifest.canonicalize(rel_chain);
     auto part_streambuf = archive_->open(part_path);
     std::istream part_stream(part_streambuf.get());
-    xml::parser parser(part_stream, part_path.string());
-    parser_ = &parser;
+    std::unique_ptr<xml::parser> parser;
+    std::string part_data;
+
+    if (rel_chain.back().type() == relationship_type::worksheet && !streaming_)
+    {
+        auto prepared = prepared_worksheets_.find(current_worksheet_);
+
+        if (prepared != prepared_worksheets_.end())
+        {
+            part_data = std::move(prepared->second->part_data);
+            shared_formulae_ = std::move(prepared->second->shared_formulae);
+            array_formulae_ = std::move(prepared->second->array_formulae);
+            prepared_worksheets_.erase(prepared);
+        }
+        else
+        {
+            read_worksheet_data(part_stream, part_data, [&]() { return archive_->open(part_path); });
+        }
+
+        parser.reset(new xml::parser(part_data.data(), part_data.size(), part_path.string()));
+    }
+    else
+    {
+        parser.reset(new xml::parser(part_stream, part_path.string()));
+    }
+
+    parser_ = parser.get();
 
     switch (rel_chain.back().type())
     {
@@ -1764,7 +2321,7 @@ void xlsx_consumer::populate_workbook(bool streaming)
 {
     streaming_ = streaming;
 
-    target_.clear();
+    target_->clear();
 
     read_content_types();
     const auto root_path = path("/");
@@ -1801,28 +2358,28 @@ void xlsx_consumer::populate_workbook(bool streaming)
 
 void xlsx_consumer::read_content_types()
 {
-    auto &manifest = target_.manifest();
+    auto &manifest = target_->manifest();
     auto content_types_streambuf = archive_->open(path("[Content_Types].xml"));
     std::istream content_types_stream(content_types_streambuf.get());
     xml::parser parser(content_types_stream, "[Content_Types].xml");
     parser_ = &parser;
 
-    expect_start_element(qn("content-types", "Types"), xml::content::complex);
+    expect_start_element(XLNT_QN("content-types", "Types"), xml::content::complex);
 
-    while (in_element(qn("content-types", "Types")))
+    while (in_element(XLNT_QN("content-types", "Types")))
     {
         auto current_element = expect_start_element(xml::content::complex);
 
-        if (current_element == qn("content-types", "Default"))
+        if (current_element == XLNT_QN("content-types", "Default"))
         {
-            auto extension = parser.attribute("Extension");
-            auto content_type = parser.attribute("ContentType");
+            auto extension = parser.attribute(XLNT_ATTRIBUTE_QN("Extension"));
+            auto content_type = parser.attribute(XLNT_ATTRIBUTE_QN("ContentType"));
             manifest.register_default_type(extension, content_type);
         }
-        else if (current_element == qn("content-types", "Override"))
+        else if (current_element == XLNT_QN("content-types", "Override"))
         {
-            auto part_name = parser.attribute("PartName");
-            auto content_type = parser.attribute("ContentType");
+            auto part_name = parser.attribute(XLNT_ATTRIBUTE_QN("PartName"));
+            auto content_type = parser.attribute(XLNT_ATTRIBUTE_QN("ContentType"));
             manifest.register_override_type(path(part_name), content_type);
         }
         else
@@ -1833,60 +2390,60 @@ void xlsx_consumer::read_content_types()
         expect_end_element(current_element);
     }
 
-    expect_end_element(qn("content-types", "Types"));
+    expect_end_element(XLNT_QN("content-types", "Types"));
 }
 
 void xlsx_consumer::read_core_properties()
 {
-    //qn("extended-properties", "Properties");
-    //qn("custom-properties", "Properties");
-    expect_start_element(qn("core-properties", "coreProperties"), xml::content::complex);
+    //XLNT_QN("extended-properties", "Properties");
+    //XLNT_QN("custom-properties", "Properties");
+    expect_start_element(XLNT_QN("core-properties", "coreProperties"), xml::content::complex);
 
-    while (in_element(qn("core-properties", "coreProperties")))
+    while (in_element(XLNT_QN("core-properties", "coreProperties")))
     {
         const auto property_element = expect_start_element(xml::content::simple);
         const auto prop = detail::from_string<core_property>(property_element.name());
         if (prop == core_property::created || prop == core_property::modified)
         {
-            skip_attribute(qn("xsi", "type"));
+            skip_attribute(XLNT_QN("xsi", "type"));
         }
-        target_.core_property(prop, read_text());
+        target_->core_property(prop, read_text());
         expect_end_element(property_element);
     }
 
-    expect_end_element(qn("core-properties", "coreProperties"));
+    expect_end_element(XLNT_QN("core-properties", "coreProperties"));
 }
 
 void xlsx_consumer::read_extended_properties()
 {
-    expect_start_element(qn("extended-properties", "Properties"), xml::content::complex);
+    expect_start_element(XLNT_QN("extended-properties", "Properties"), xml::content::complex);
 
-    while (in_element(qn("extended-properties", "Properties")))
+    while (in_element(XLNT_QN("extended-properties", "Properties")))
     {
         const auto property_element = expect_start_element(xml::content::mixed);
         const auto prop = detail::from_string<extended_property>(property_element.name());
-        target_.extended_property(prop, read_variant());
+        target_->extended_property(prop, read_variant());
         expect_end_element(property_element);
     }
 
-    expect_end_element(qn("extended-properties", "Properties"));
+    expect_end_element(XLNT_QN("extended-properties", "Properties"));
 }
 
 void xlsx_consumer::read_custom_properties()
 {
-    expect_start_element(qn("custom-properties", "Properties"), xml::content::complex);
+    expect_start_element(XLNT_QN("custom-properties", "Properties"), xml::content::complex);
 
-    while (in_element(qn("custom-properties", "Properties")))
+    while (in_element(XLNT_QN("custom-properties", "Properties")))
     {
         const auto property_element = expect_start_element(xml::content::complex);
-        const auto prop = parser().attribute("name");
-        const auto format_id = parser().attribute("fmtid");
-        const auto property_id = parser().attribute("pid");
-        target_.custom_property(prop, read_variant());
+        const auto prop = parser().attribute(XLNT_ATTRIBUTE_QN("name"));
+        const auto format_id = parser().attribute(XLNT_ATTRIBUTE_QN("fmtid"));
+        const auto property_id = parser().attribute(XLNT_ATTRIBUTE_QN("pid"));
+        target_->custom_property(prop, read_variant());
         expect_end_element(property_element);
     }
 
-    expect_end_element(qn("custom-properties", "Properties"));
+    expect_end_element(XLNT_QN("custom-properties", "Properties"));
 }
 
 void xlsx_consumer::read_office_document(const std::string &content_type) // CT_Workbook
@@ -1904,62 +2461,62 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         throw xlnt::invalid_file(content_type);
     }
 
-    target_.d_->calculation_properties_.clear();
+    target_->d_->calculation_properties_.clear();
 
-    expect_start_element(qn("workbook", "workbook"), xml::content::complex);
-    skip_attribute(qn("mc", "Ignorable"));
+    expect_start_element(XLNT_QN("workbook", "workbook"), xml::content::complex);
+    skip_attribute(XLNT_QN("mc", "Ignorable"));
 
-    while (in_element(qn("workbook", "workbook")))
+    while (in_element(XLNT_QN("workbook", "workbook")))
     {
         auto current_workbook_element = expect_start_element(xml::content::complex);
 
-        if (current_workbook_element == qn("workbook", "fileVersion")) // CT_FileVersion 0-1
+        if (current_workbook_element == XLNT_QN("workbook", "fileVersion")) // CT_FileVersion 0-1
         {
             detail::workbook_impl::file_version_t file_version;
 
-            if (parser().attribute_present("appName"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("appName")))
             {
-                file_version.app_name = parser().attribute("appName");
+                file_version.app_name = parser().attribute(XLNT_ATTRIBUTE_QN("appName"));
             }
 
-            if (parser().attribute_present("lastEdited"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("lastEdited")))
             {
-                file_version.last_edited = parser().attribute<std::size_t>("lastEdited");
+                file_version.last_edited = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("lastEdited"));
             }
 
-            if (parser().attribute_present("lowestEdited"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("lowestEdited")))
             {
-                file_version.lowest_edited = parser().attribute<std::size_t>("lowestEdited");
+                file_version.lowest_edited = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("lowestEdited"));
             }
 
-            if (parser().attribute_present("lowestEdited"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("lowestEdited")))
             {
-                file_version.rup_build = parser().attribute<std::size_t>("rupBuild");
+                file_version.rup_build = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("rupBuild"));
             }
 
-            skip_attribute("codeName");
+            skip_attribute(XLNT_ATTRIBUTE_QN("codeName"));
 
-            target_.d_->file_version_ = file_version;
+            target_->d_->file_version_ = file_version;
         }
-        else if (current_workbook_element == qn("workbook", "fileSharing")) // CT_FileSharing 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "fileSharing")) // CT_FileSharing 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("mc", "AlternateContent"))
+        else if (current_workbook_element == XLNT_QN("mc", "AlternateContent"))
         {
-            while (in_element(qn("mc", "AlternateContent")))
+            while (in_element(XLNT_QN("mc", "AlternateContent")))
             {
                 auto alternate_content_element = expect_start_element(xml::content::complex);
 
-                if (alternate_content_element == qn("mc", "Choice")
-                    && parser().attribute_present("Requires")
-                    && parser().attribute("Requires") == "x15")
+                if (alternate_content_element == XLNT_QN("mc", "Choice")
+                    && parser().attribute_present(XLNT_ATTRIBUTE_QN("Requires"))
+                    && parser().attribute(XLNT_ATTRIBUTE_QN("Requires")) == "x15")
                 {
                     auto x15_element = expect_start_element(xml::content::simple);
 
-                    if (x15_element == qn("x15ac", "absPath"))
+                    if (x15_element == XLNT_QN("x15ac", "absPath"))
                     {
-                        target_.d_->abs_path_ = parser().attribute("url");
+                        target_->d_->abs_path_ = parser().attribute(XLNT_ATTRIBUTE_QN("url"));
                     }
 
                     skip_remaining_content(x15_element);
@@ -1970,192 +2527,192 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
                 expect_end_element(alternate_content_element);
             }
         }
-        else if (current_workbook_element == qn("workbook", "workbookPr")) // CT_WorkbookPr 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "workbookPr")) // CT_WorkbookPr 0-1
         {
-            target_.base_date(parser().attribute_present("date1904") // optional, bool=false
-                        && is_true(parser().attribute("date1904"))
+            target_->base_date(parser().attribute_present(XLNT_ATTRIBUTE_QN("date1904")) // optional, bool=false
+                        && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("date1904")))
                     ? calendar::mac_1904
                     : calendar::windows_1900);
-            skip_attribute("showObjects"); // optional, ST_Objects="all"
-            skip_attribute("showBorderUnselectedTables"); // optional, bool=true
-            skip_attribute("filterPrivacy"); // optional, bool=false
-            skip_attribute("promptedSolutions"); // optional, bool=false
-            skip_attribute("showInkAnnotation"); // optional, bool=true
-            skip_attribute("backupFile"); // optional, bool=false
-            skip_attribute("saveExternalLinkValues"); // optional, bool=true
-            skip_attribute("updateLinks"); // optional, ST_UpdateLinks="userSet"
-            skip_attribute("codeName"); // optional, string
-            skip_attribute("hidePivotFieldList"); // optional, bool=false
-            skip_attribute("showPivotChartFilter"); // optional, bool=false
-            skip_attribute("allowRefreshQuery"); // optional, bool=false
-            skip_attribute("publishItems"); // optional, bool=false
-            skip_attribute("checkCompatibility"); // optional, bool=false
-            skip_attribute("autoCompressPictures"); // optional, bool=true
-            skip_attribute("refreshAllConnections"); // optional, bool=false
-            skip_attribute("defaultThemeVersion"); // optional, uint
-            skip_attribute("dateCompatibility"); // optional, bool (undocumented)
-        }
-        else if (current_workbook_element == qn("workbook", "workbookProtection")) // CT_WorkbookProtection 0-1
+            skip_attribute(XLNT_ATTRIBUTE_QN("showObjects")); // optional, ST_Objects="all"
+            skip_attribute(XLNT_ATTRIBUTE_QN("showBorderUnselectedTables")); // optional, bool=true
+            skip_attribute(XLNT_ATTRIBUTE_QN("filterPrivacy")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("promptedSolutions")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("showInkAnnotation")); // optional, bool=true
+            skip_attribute(XLNT_ATTRIBUTE_QN("backupFile")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("saveExternalLinkValues")); // optional, bool=true
+            skip_attribute(XLNT_ATTRIBUTE_QN("updateLinks")); // optional, ST_UpdateLinks="userSet"
+            skip_attribute(XLNT_ATTRIBUTE_QN("codeName")); // optional, string
+            skip_attribute(XLNT_ATTRIBUTE_QN("hidePivotFieldList")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("showPivotChartFilter")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("allowRefreshQuery")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("publishItems")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("checkCompatibility")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("autoCompressPictures")); // optional, bool=true
+            skip_attribute(XLNT_ATTRIBUTE_QN("refreshAllConnections")); // optional, bool=false
+            skip_attribute(XLNT_ATTRIBUTE_QN("defaultThemeVersion")); // optional, uint
+            skip_attribute(XLNT_ATTRIBUTE_QN("dateCompatibility")); // optional, bool (undocumented)
+        }
+        else if (current_workbook_element == XLNT_QN("workbook", "workbookProtection")) // CT_WorkbookProtection 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "bookViews")) // CT_BookViews 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "bookViews")) // CT_BookViews 0-1
         {
-            while (in_element(qn("workbook", "bookViews")))
+            while (in_element(XLNT_QN("workbook", "bookViews")))
             {
-                expect_start_element(qn("workbook", "workbookView"), xml::content::simple);
-                skip_attributes({"firstSheet", "showHorizontalScroll",
-                    "showSheetTabs", "showVerticalScroll"});
+                expect_start_element(XLNT_QN("workbook", "workbookView"), xml::content::simple);
+                skip_attributes({XLNT_ATTRIBUTE_QN("firstSheet"), XLNT_ATTRIBUTE_QN("showHorizontalScroll"),
+                    XLNT_ATTRIBUTE_QN("showSheetTabs"), XLNT_ATTRIBUTE_QN("showVerticalScroll")});
 
                 workbook_view view;
 
-                if (parser().attribute_present("xWindow"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("xWindow")))
                 {
-                    view.x_window = parser().attribute<int>("xWindow");
+                    view.x_window = parser().attribute<int>(XLNT_ATTRIBUTE_QN("xWindow"));
                 }
 
-                if (parser().attribute_present("yWindow"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("yWindow")))
                 {
-                    view.y_window = parser().attribute<int>("yWindow");
+                    view.y_window = parser().attribute<int>(XLNT_ATTRIBUTE_QN("yWindow"));
                 }
 
-                if (parser().attribute_present("windowWidth"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("windowWidth")))
                 {
-                    view.window_width = parser().attribute<std::size_t>("windowWidth");
+                    view.window_width = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("windowWidth"));
                 }
 
-                if (parser().attribute_present("windowHeight"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("windowHeight")))
                 {
-                    view.window_height = parser().attribute<std::size_t>("windowHeight");
+                    view.window_height = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("windowHeight"));
                 }
 
-                if (parser().attribute_present("tabRatio"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("tabRatio")))
                 {
-                    view.tab_ratio = parser().attribute<std::size_t>("tabRatio");
+                    view.tab_ratio = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("tabRatio"));
                 }
 
-                if (parser().attribute_present("activeTab"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("activeTab")))
                 {
-                    view.active_tab = parser().attribute<std::size_t>("activeTab");
-                    target_.d_->active_sheet_index_.set(view.active_tab.get());
+                    view.active_tab = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("activeTab"));
+                    target_->d_->active_sheet_index_.set(view.active_tab.get());
                 }
 
-                target_.view(view);
+                target_->view(view);
 
                 skip_attributes();
-                expect_end_element(qn("workbook", "workbookView"));
+                expect_end_element(XLNT_QN("workbook", "workbookView"));
             }
         }
-        else if (current_workbook_element == qn("workbook", "sheets")) // CT_Sheets 1
+        else if (current_workbook_element == XLNT_QN("workbook", "sheets")) // CT_Sheets 1
         {
             std::size_t index = 0;
 
-            while (in_element(qn("workbook", "sheets")))
+            while (in_element(XLNT_QN("workbook", "sheets")))
             {
-                expect_start_element(qn("spreadsheetml", "sheet"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "sheet"), xml::content::simple);
 
-                auto title = parser().attribute("name");
+                auto title = parser().attribute(XLNT_ATTRIBUTE_QN("name"));
 
                 sheet_title_index_map_[title] = index++;
-                sheet_title_id_map_[title] = parser().attribute<std::size_t>("sheetId");
-                target_.d_->sheet_title_rel_id_map_[title] = parser().attribute(qn("r", "id"));
+                sheet_title_id_map_[title] = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("sheetId"));
+                target_->d_->sheet_title_rel_id_map_[title] = parser().attribute(XLNT_QN("r", "id"));
 
-                bool hidden = parser().attribute<std::string>("state", "") == "hidden";
-                target_.d_->sheet_hidden_.push_back(hidden);
+                bool hidden = parser().attribute<std::string>(XLNT_ATTRIBUTE_QN("state"), "") == "hidden";
+                target_->d_->sheet_hidden_.push_back(hidden);
 
-                expect_end_element(qn("spreadsheetml", "sheet"));
+                expect_end_element(XLNT_QN("spreadsheetml", "sheet"));
             }
         }
-        else if (current_workbook_element == qn("workbook", "functionGroups")) // CT_FunctionGroups 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "functionGroups")) // CT_FunctionGroups 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "externalReferences")) // CT_ExternalReferences 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "externalReferences")) // CT_ExternalReferences 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "definedNames")) // CT_DefinedNames 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "definedNames")) // CT_DefinedNames 0-1
         {
-            while (in_element(qn("workbook", "definedNames")))
+            while (in_element(XLNT_QN("workbook", "definedNames")))
             {
-                expect_start_element(qn("spreadsheetml", "definedName"), xml::content::mixed);
+                expect_start_element(XLNT_QN("spreadsheetml", "definedName"), xml::content::mixed);
 
                 defined_name name;
-                name.name = parser().attribute("name");
-                name.sheet_id = parser().attribute<std::size_t>("localSheetId");
+                name.name = parser().attribute(XLNT_ATTRIBUTE_QN("name"));
+                name.sheet_id = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("localSheetId"));
                 name.hidden = false;
-                if (parser().attribute_present("hidden"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("hidden")))
                 {
-                    name.hidden = is_true(parser().attribute("hidden"));
+                    name.hidden = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("hidden")));
                 }
                 parser().attribute_map(); // skip remaining attributes
                 name.value = read_text();
                 defined_names_.push_back(name);
                 
-                expect_end_element(qn("spreadsheetml", "definedName"));
+                expect_end_element(XLNT_QN("spreadsheetml", "definedName"));
             }
         }
-        else if (current_workbook_element == qn("workbook", "calcPr")) // CT_CalcPr 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "calcPr")) // CT_CalcPr 0-1
         {
             xlnt::calculation_properties calc_props;
-            if (parser().attribute_present("calcId"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("calcId")))
             {
-                calc_props.calc_id = parser().attribute<std::size_t>("calcId");
+                calc_props.calc_id = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("calcId"));
             }
-            if (parser().attribute_present("concurrentCalc"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("concurrentCalc")))
             {
-                calc_props.concurrent_calc = is_true(parser().attribute("concurrentCalc"));
+                calc_props.concurrent_calc = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("concurrentCalc")));
             }
-            target_.calculation_properties(calc_props);
+            target_->calculation_properties(calc_props);
             parser().attribute_map(); // skip remaining
         }
-        else if (current_workbook_element == qn("workbook", "oleSize")) // CT_OleSize 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "oleSize")) // CT_OleSize 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "customWorkbookViews")) // CT_CustomWorkbookViews 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "customWorkbookViews")) // CT_CustomWorkbookViews 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "pivotCaches")) // CT_PivotCaches 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "pivotCaches")) // CT_PivotCaches 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "smartTagPr")) // CT_SmartTagPr 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "smartTagPr")) // CT_SmartTagPr 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "smartTagTypes")) // CT_SmartTagTypes 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "smartTagTypes")) // CT_SmartTagTypes 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "webPublishing")) // CT_WebPublishing 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "webPublishing")) // CT_WebPublishing 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "fileRecoveryPr")) // CT_FileRecoveryPr 0+
+        else if (current_workbook_element == XLNT_QN("workbook", "fileRecoveryPr")) // CT_FileRecoveryPr 0+
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "webPublishObjects")) // CT_WebPublishObjects 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "webPublishObjects")) // CT_WebPublishObjects 0-1
         {
             skip_remaining_content(current_workbook_element);
         }
-        else if (current_workbook_element == qn("workbook", "extLst")) // CT_ExtensionList 0-1
+        else if (current_workbook_element == XLNT_QN("workbook", "extLst")) // CT_ExtensionList 0-1
         {
-            while (in_element(qn("workbook", "extLst")))
+            while (in_element(XLNT_QN("workbook", "extLst")))
             {
                 auto extension_element = expect_start_element(xml::content::complex);
 
-                if (extension_element == qn("workbook", "ext")
-                    && parser().attribute_present("uri")
-                    && parser().attribute("uri") == "{7523E5D3-25F3-A5E0-1632-64F254C22452}")
+                if (extension_element == XLNT_QN("workbook", "ext")
+                    && parser().attribute_present(XLNT_ATTRIBUTE_QN("uri"))
+                    && parser().attribute(XLNT_ATTRIBUTE_QN("uri")) == "{7523E5D3-25F3-A5E0-1632-64F254C22452}")
                 {
                     auto arch_id_extension_element = expect_start_element(xml::content::simple);
 
-                    if (arch_id_extension_element == qn("mx", "ArchID"))
+                    if (arch_id_extension_element == XLNT_QN("mx", "ArchID"))
                     {
-                        target_.d_->arch_id_flags_ = parser().attribute<std::size_t>("Flags");
+                        target_->d_->arch_id_flags_ = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("Flags"));
                     }
 
                     skip_remaining_content(arch_id_extension_element);
@@ -2174,7 +2731,7 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         expect_end_element(current_workbook_element);
     }
 
-    expect_end_element(qn("workbook", "workbook"));
+    expect_end_element(XLNT_QN("workbook", "workbook"));
 
     auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
     auto workbook_path = workbook_rel.target().path();
@@ -2188,17 +2745,28 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
     for (auto rel_type : rel_types)
     {
-        if (manifest().has_relationship(workbook_path, rel_type))
+        if (rel_type == relationship_type::stylesheet && options_.skip_styles)
+        {
+            target_->d_->skipped_parts_ = true;
+        }
+        else if (manifest().has_relationship(workbook_path, rel_type))
         {
             read_part({workbook_rel,
                 manifest().relationship(workbook_path, rel_type)});
         }
     }
 
-    for (auto worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
+    const auto worksheet_rels = manifest().relationships(workbook_path, relationship_type::worksheet);
+    // worksheets are only read as they're created when they aren't deferred or read ahead in parallel
+    const auto parallel = !options_.lazy && options_.worksheet_threads != 1;
+    std::vector<relationship> parallel_rels;
+    std::vector<std::pair<path, worksheet_impl *>> parallel_worksheets;
+    std::vector<worksheet_impl *> skipped_worksheets;
+
+    for (const auto &worksheet_rel : worksheet_rels)
     {
-        auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
-            target_.d_->sheet_title_rel_id_map_.end(),
+        auto title = std::find_if(target_->d_->sheet_title_rel_id_map_.begin(),
+            target_->d_->sheet_title_rel_id_map_.end(),
             [&](const std::pair<std::string, std::string> &p) {
                 return p.second == worksheet_rel.id();
             })->first;
@@ -2206,20 +2774,155 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         auto id = sheet_title_id_map_[title];
         auto index = sheet_title_index_map_[title];
 
-        auto insertion_iter = target_.d_->worksheets_.begin();
-        while (insertion_iter != target_.d_->worksheets_.end()
+        auto insertion_iter = target_->d_->worksheets_.begin();
+        while (insertion_iter != target_->d_->worksheets_.end()
             && sheet_title_index_map_[insertion_iter->title_] < index)
         {
             ++insertion_iter;
         }
 
-        current_worksheet_ = &*target_.d_->worksheets_.emplace(insertion_iter, &target_, id, title);
+        current_worksheet_ = &*target_->d_->worksheets_.emplace(insertion_iter, target_, id, title);
+        current_worksheet_->cells_.allocation(target_->d_->cell_allocation_);
+
+        if (streaming_)
+        {
+            continue;
+        }
 
-        if (!streaming_)
+        if (!options_.sheets.empty()
+            && std::find(options_.sheets.begin(), options_.sheets.end(), title) == options_.sheets.end())
+        {
+            skipped_worksheets.push_back(current_worksheet_);
+        }
+        else if (options_.lazy)
+        {
+            deferred_worksheets_.push_back(current_worksheet_);
+        }
+        else if (parallel)
+        {
+            parallel_rels.push_back(worksheet_rel);
+            parallel_worksheets.emplace_back(manifest().canonicalize({workbook_rel, worksheet_rel}), current_worksheet_);
+        }
+        else
         {
             read_part({workbook_rel, worksheet_rel});
         }
     }
+
+    if (!parallel_worksheets.empty())
+    {
+        // sheetData is read in parallel and the rest of each part, including
+        // its comments and drawings, is read here in document order
+        prepare_worksheets(parallel_worksheets);
+
+        for (std::size_t i = 0; i < parallel_worksheets.size(); ++i)
+        {
+            current_worksheet_ = parallel_worksheets[i].second;
+            read_part({workbook_rel, parallel_rels[i]});
+        }
+    }
+
+    if (!skipped_worksheets.empty())
+    {
+        remove_worksheets(skipped_worksheets);
+    }
+}
+
+void xlsx_consumer::remove_worksheets(const std::vector<worksheet_impl *> &worksheets)
+{
+    auto &impl = *target_->d_;
+    const worksheet_impl *active_worksheet = nullptr;
+
+    if (impl.active_sheet_index_.is_set() && impl.active_sheet_index_.get() < impl.worksheets_.size())
+    {
+        active_worksheet = &*std::next(impl.worksheets_.begin(),
+            static_cast<std::ptrdiff_t>(impl.active_sheet_index_.get()));
+    }
+
+    std::vector<std::size_t> hidden_indices;
+
+    for (auto ws : worksheets)
+    {
+        hidden_indices.push_back(sheet_title_index_map_[ws->title_]);
+        target_->remove_sheet(worksheet(ws));
+    }
+
+    // sheet_hidden_ is indexed by position in <sheets>, which remove_sheet doesn't update
+    std::sort(hidden_indices.rbegin(), hidden_indices.rend());
+
+    for (auto hidden_index : hidden_indices)
+    {
+        if (hidden_index < impl.sheet_hidden_.size())
+        {
+            impl.sheet_hidden_.erase(impl.sheet_hidden_.begin() + static_cast<std::ptrdiff_t>(hidden_index));
+        }
+    }
+
+    // the active sheet keeps its place if it was loaded, otherwise the first sheet becomes active
+    std::size_t active_index = 0;
+
+    for (auto &ws : impl.worksheets_)
+    {
+        if (&ws == active_worksheet)
+        {
+            break;
+        }
+
+        ++active_index;
+    }
+
+    if (active_index == impl.worksheets_.size())
+    {
+        active_index = 0;
+    }
+
+    if (impl.active_sheet_index_.is_set())
+    {
+        impl.active_sheet_index_.set(active_index);
+    }
+
+    if (impl.view_.is_set() && impl.view_.get().active_tab.is_set())
+    {
+        impl.view_.get().active_tab = active_index;
+    }
+}
+
+bool xlsx_consumer::has_deferred_worksheets() const
+{
+    return !deferred_worksheets_.empty();
+}
+
+void xlsx_consumer::read_deferred_worksheet(worksheet_impl *ws)
+{
+    auto deferred = std::find(deferred_worksheets_.begin(), deferred_worksheets_.end(), ws);
+
+    if (deferred == deferred_worksheets_.end())
+    {
+        return;
+    }
+
+    deferred_worksheets_.erase(deferred);
+
+    // the relationship is looked up now since removing other sheets can change its ID
+    auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    auto worksheet_rel = manifest().relationship(workbook_rel.target().path(),
+        target_->d_->sheet_title_rel_id_map_.at(ws->title_));
+
+    current_worksheet_ = ws;
+    read_part({workbook_rel, worksheet_rel});
+}
+
+void xlsx_consumer::read_deferred_worksheets()
+{
+    while (!deferred_worksheets_.empty())
+    {
+        read_deferred_worksheet(deferred_worksheets_.front());
+    }
+}
+
+void xlsx_consumer::destination(workbook &destination)
+{
+    target_ = &destination;
 }
 
 // Write Workbook Relationship Target Parts
@@ -2258,29 +2961,34 @@ void xlsx_consumer::read_pivot_table()
 
 void xlsx_consumer::read_shared_string_table()
 {
-    expect_start_element(qn("spreadsheetml", "sst"), xml::content::complex);
-    skip_attributes({"count"});
+    expect_start_element(XLNT_QN("spreadsheetml", "sst"), xml::content::complex);
+    skip_attributes({XLNT_ATTRIBUTE_QN("count")});
 
     bool has_unique_count = false;
     std::size_t unique_count = 0;
 
-    if (parser().attribute_present("uniqueCount"))
+    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("uniqueCount")))
     {
         has_unique_count = true;
-        unique_count = parser().attribute<std::size_t>("uniqueCount");
+        unique_count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("uniqueCount"));
+
+        // a wrong count fails the load below, but it shouldn't exhaust memory first
+        const auto reserved = std::min(unique_count, std::size_t(1) << 20);
+        target_->impl().shared_strings_values_.reserve(reserved);
+        target_->impl().shared_strings_ids_.reserve(reserved);
     }
 
-    while (in_element(qn("spreadsheetml", "sst")))
+    while (in_element(XLNT_QN("spreadsheetml", "sst")))
     {
-        expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
-        auto rt = read_rich_text(qn("spreadsheetml", "si"));
-        target_.add_shared_string(rt, true);
-        expect_end_element(qn("spreadsheetml", "si"));
+        expect_start_element(XLNT_QN("spreadsheetml", "si"), xml::content::complex);
+        auto rt = read_rich_text(XLNT_QN("spreadsheetml", "si"));
+        target_->add_shared_string(rt, true);
+        expect_end_element(XLNT_QN("spreadsheetml", "si"));
     }
 
-    expect_end_element(qn("spreadsheetml", "sst"));
+    expect_end_element(XLNT_QN("spreadsheetml", "sst"));
 
-    if (has_unique_count && unique_count != target_.shared_strings().size())
+    if (has_unique_count && unique_count != target_->shared_strings().size())
     {
         throw invalid_file("sizes don't match");
     }
@@ -2300,40 +3008,40 @@ void xlsx_consumer::read_shared_workbook_user_data()
 
 void xlsx_consumer::read_stylesheet()
 {
-    target_.impl().stylesheet_ = detail::stylesheet();
-    auto &stylesheet = target_.impl().stylesheet_.get();
+    target_->impl().stylesheet_ = detail::stylesheet();
+    auto &stylesheet = target_->impl().stylesheet_.get();
 
-    expect_start_element(qn("spreadsheetml", "styleSheet"), xml::content::complex);
-    skip_attributes({qn("mc", "Ignorable")});
+    expect_start_element(XLNT_QN("spreadsheetml", "styleSheet"), xml::content::complex);
+    skip_attributes({XLNT_QN("mc", "Ignorable")});
 
     std::vector<std::pair<style_impl, std::size_t>> styles;
     std::vector<std::pair<format_impl, std::size_t>> format_records;
     std::vector<std::pair<format_impl, std::size_t>> style_records;
 
-    while (in_element(qn("spreadsheetml", "styleSheet")))
+    while (in_element(XLNT_QN("spreadsheetml", "styleSheet")))
     {
         auto current_style_element = expect_start_element(xml::content::complex);
 
-        if (current_style_element == qn("spreadsheetml", "borders"))
+        if (current_style_element == XLNT_QN("spreadsheetml", "borders"))
         {
             auto &borders = stylesheet.borders;
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
 
-            while (in_element(qn("spreadsheetml", "borders")))
+            while (in_element(XLNT_QN("spreadsheetml", "borders")))
             {
                 borders.push_back(xlnt::border());
                 auto &border = borders.back();
 
-                expect_start_element(qn("spreadsheetml", "border"), xml::content::complex);
+                expect_start_element(XLNT_QN("spreadsheetml", "border"), xml::content::complex);
 
                 auto diagonal = diagonal_direction::neither;
 
-                if (parser().attribute_present("diagonalDown") && parser().attribute("diagonalDown") == "1")
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("diagonalDown")) && parser().attribute(XLNT_ATTRIBUTE_QN("diagonalDown")) == "1")
                 {
                     diagonal = diagonal_direction::down;
                 }
 
-                if (parser().attribute_present("diagonalUp") && parser().attribute("diagonalUp") == "1")
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("diagonalUp")) && parser().attribute(XLNT_ATTRIBUTE_QN("diagonalUp")) == "1")
                 {
                     diagonal = diagonal == diagonal_direction::down ? diagonal_direction::both : diagonal_direction::up;
                 }
@@ -2343,22 +3051,22 @@ void xlsx_consumer::read_stylesheet()
                     border.diagonal(diagonal);
                 }
 
-                while (in_element(qn("spreadsheetml", "border")))
+                while (in_element(XLNT_QN("spreadsheetml", "border")))
                 {
                     auto current_side_element = expect_start_element(xml::content::complex);
 
                     xlnt::border::border_property side;
 
-                    if (parser().attribute_present("style"))
+                    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("style")))
                     {
-                        side.style(parser().attribute<xlnt::border_style>("style"));
+                        side.style(parser().attribute<xlnt::border_style>(XLNT_ATTRIBUTE_QN("style")));
                     }
 
                     if (in_element(current_side_element))
                     {
-                        expect_start_element(qn("spreadsheetml", "color"), xml::content::complex);
+                        expect_start_element(XLNT_QN("spreadsheetml", "color"), xml::content::complex);
                         side.color(read_color());
-                        expect_end_element(qn("spreadsheetml", "color"));
+                        expect_end_element(XLNT_QN("spreadsheetml", "color"));
                     }
 
                     expect_end_element(current_side_element);
@@ -2367,7 +3075,7 @@ void xlsx_consumer::read_stylesheet()
                     border.side(side_type, side);
                 }
 
-                expect_end_element(qn("spreadsheetml", "border"));
+                expect_end_element(XLNT_QN("spreadsheetml", "border"));
             }
 
             if (count != borders.size())
@@ -2375,36 +3083,36 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("border counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "fills"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "fills"))
         {
             auto &fills = stylesheet.fills;
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
 
-            while (in_element(qn("spreadsheetml", "fills")))
+            while (in_element(XLNT_QN("spreadsheetml", "fills")))
             {
                 fills.push_back(xlnt::fill());
                 auto &new_fill = fills.back();
 
-                expect_start_element(qn("spreadsheetml", "fill"), xml::content::complex);
+                expect_start_element(XLNT_QN("spreadsheetml", "fill"), xml::content::complex);
                 auto fill_element = expect_start_element(xml::content::complex);
 
-                if (fill_element == qn("spreadsheetml", "patternFill"))
+                if (fill_element == XLNT_QN("spreadsheetml", "patternFill"))
                 {
                     xlnt::pattern_fill pattern;
 
-                    if (parser().attribute_present("patternType"))
+                    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("patternType")))
                     {
-                        pattern.type(parser().attribute<xlnt::pattern_fill_type>("patternType"));
+                        pattern.type(parser().attribute<xlnt::pattern_fill_type>(XLNT_ATTRIBUTE_QN("patternType")));
 
-                        while (in_element(qn("spreadsheetml", "patternFill")))
+                        while (in_element(XLNT_QN("spreadsheetml", "patternFill")))
                         {
                             auto pattern_type_element = expect_start_element(xml::content::complex);
 
-                            if (pattern_type_element == qn("spreadsheetml", "fgColor"))
+                            if (pattern_type_element == XLNT_QN("spreadsheetml", "fgColor"))
                             {
                                 pattern.foreground(read_color());
                             }
-                            else if (pattern_type_element == qn("spreadsheetml", "bgColor"))
+                            else if (pattern_type_element == XLNT_QN("spreadsheetml", "bgColor"))
                             {
                                 pattern.background(read_color());
                             }
@@ -2419,27 +3127,27 @@ void xlsx_consumer::read_stylesheet()
 
                     new_fill = pattern;
                 }
-                else if (fill_element == qn("spreadsheetml", "gradientFill"))
+                else if (fill_element == XLNT_QN("spreadsheetml", "gradientFill"))
                 {
                     xlnt::gradient_fill gradient;
 
-                    if (parser().attribute_present("type"))
+                    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("type")))
                     {
-                        gradient.type(parser().attribute<xlnt::gradient_fill_type>("type"));
+                        gradient.type(parser().attribute<xlnt::gradient_fill_type>(XLNT_ATTRIBUTE_QN("type")));
                     }
                     else
                     {
                         gradient.type(xlnt::gradient_fill_type::linear);
                     }
 
-                    while (in_element(qn("spreadsheetml", "gradientFill")))
+                    while (in_element(XLNT_QN("spreadsheetml", "gradientFill")))
                     {
-                        expect_start_element(qn("spreadsheetml", "stop"), xml::content::complex);
-                        auto position = converter_.deserialise(parser().attribute("position"));
-                        expect_start_element(qn("spreadsheetml", "color"), xml::content::complex);
+                        expect_start_element(XLNT_QN("spreadsheetml", "stop"), xml::content::complex);
+                        auto position = converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("position")));
+                        expect_start_element(XLNT_QN("spreadsheetml", "color"), xml::content::complex);
                         auto color = read_color();
-                        expect_end_element(qn("spreadsheetml", "color"));
-                        expect_end_element(qn("spreadsheetml", "stop"));
+                        expect_end_element(XLNT_QN("spreadsheetml", "color"));
+                        expect_end_element(XLNT_QN("spreadsheetml", "stop"));
 
                         gradient.add_stop(position, color);
                     }
@@ -2452,7 +3160,7 @@ void xlsx_consumer::read_stylesheet()
                 }
 
                 expect_end_element(fill_element);
-                expect_end_element(qn("spreadsheetml", "fill"));
+                expect_end_element(XLNT_QN("spreadsheetml", "fill"));
             }
 
             if (count != fills.size())
@@ -2460,61 +3168,61 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "fonts"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "fonts"))
         {
             auto &fonts = stylesheet.fonts;
-            auto count = parser().attribute<std::size_t>("count", 0);
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"), 0);
 
-            if (parser().attribute_present(qn("x14ac", "knownFonts")))
+            if (parser().attribute_present(XLNT_QN("x14ac", "knownFonts")))
             {
-                target_.enable_known_fonts();
+                target_->enable_known_fonts();
             }
 
-            while (in_element(qn("spreadsheetml", "fonts")))
+            while (in_element(XLNT_QN("spreadsheetml", "fonts")))
             {
                 fonts.push_back(xlnt::font());
                 auto &new_font = stylesheet.fonts.back();
 
-                expect_start_element(qn("spreadsheetml", "font"), xml::content::complex);
+                expect_start_element(XLNT_QN("spreadsheetml", "font"), xml::content::complex);
 
-                while (in_element(qn("spreadsheetml", "font")))
+                while (in_element(XLNT_QN("spreadsheetml", "font")))
                 {
                     auto font_property_element = expect_start_element(xml::content::simple);
 
-                    if (font_property_element == qn("spreadsheetml", "sz"))
+                    if (font_property_element == XLNT_QN("spreadsheetml", "sz"))
                     {
-                        new_font.size(converter_.deserialise(parser().attribute("val")));
+                        new_font.size(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                     }
-                    else if (font_property_element == qn("spreadsheetml", "name"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "name"))
                     {
-                        new_font.name(parser().attribute("val"));
+                        new_font.name(parser().attribute(XLNT_ATTRIBUTE_QN("val")));
                     }
-                    else if (font_property_element == qn("spreadsheetml", "color"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "color"))
                     {
                         new_font.color(read_color());
                     }
-                    else if (font_property_element == qn("spreadsheetml", "family"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "family"))
                     {
-                        new_font.family(parser().attribute<std::size_t>("val"));
+                        new_font.family(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("val")));
                     }
-                    else if (font_property_element == qn("spreadsheetml", "scheme"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "scheme"))
                     {
-                        new_font.scheme(parser().attribute("val"));
+                        new_font.scheme(parser().attribute(XLNT_ATTRIBUTE_QN("val")));
                     }
-                    else if (font_property_element == qn("spreadsheetml", "b"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "b"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            new_font.bold(is_true(parser().attribute("val")));
+                            new_font.bold(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                         }
                         else
                         {
                             new_font.bold(true);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "vertAlign"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "vertAlign"))
                     {
-                        auto vert_align = parser().attribute("val");
+                        auto vert_align = parser().attribute(XLNT_ATTRIBUTE_QN("val"));
 
                         if (vert_align == "superscript")
                         {
@@ -2525,66 +3233,66 @@ void xlsx_consumer::read_stylesheet()
                             new_font.subscript(true);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "strike"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "strike"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            new_font.strikethrough(is_true(parser().attribute("val")));
+                            new_font.strikethrough(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                         }
                         else
                         {
                             new_font.strikethrough(true);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "outline"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "outline"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            new_font.outline(is_true(parser().attribute("val")));
+                            new_font.outline(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                         }
                         else
                         {
                             new_font.outline(true);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "shadow"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "shadow"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            new_font.shadow(is_true(parser().attribute("val")));
+                            new_font.shadow(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                         }
                         else
                         {
                             new_font.shadow(true);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "i"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "i"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            new_font.italic(is_true(parser().attribute("val")));
+                            new_font.italic(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                         }
                         else
                         {
                             new_font.italic(true);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "u"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "u"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            new_font.underline(parser().attribute<xlnt::font::underline_style>("val"));
+                            new_font.underline(parser().attribute<xlnt::font::underline_style>(XLNT_ATTRIBUTE_QN("val")));
                         }
                         else
                         {
                             new_font.underline(xlnt::font::underline_style::single);
                         }
                     }
-                    else if (font_property_element == qn("spreadsheetml", "charset"))
+                    else if (font_property_element == XLNT_QN("spreadsheetml", "charset"))
                     {
-                        if (parser().attribute_present("val"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                         {
-                            parser().attribute("val");
+                            parser().attribute(XLNT_ATTRIBUTE_QN("val"));
                         }
                     }
                     else
@@ -2595,7 +3303,7 @@ void xlsx_consumer::read_stylesheet()
                     expect_end_element(font_property_element);
                 }
 
-                expect_end_element(qn("spreadsheetml", "font"));
+                expect_end_element(XLNT_QN("spreadsheetml", "font"));
             }
 
             if (count != stylesheet.fonts.size())
@@ -2603,16 +3311,16 @@ void xlsx_consumer::read_stylesheet()
                 // throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "numFmts"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "numFmts"))
         {
             auto &number_formats = stylesheet.number_formats;
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
 
-            while (in_element(qn("spreadsheetml", "numFmts")))
+            while (in_element(XLNT_QN("spreadsheetml", "numFmts")))
             {
-                expect_start_element(qn("spreadsheetml", "numFmt"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "numFmt"), xml::content::simple);
 
-                auto format_string = parser().attribute("formatCode");
+                auto format_string = parser().attribute(XLNT_ATTRIBUTE_QN("formatCode"));
 
                 if (format_string == "GENERAL")
                 {
@@ -2622,9 +3330,9 @@ void xlsx_consumer::read_stylesheet()
                 xlnt::number_format nf;
 
                 nf.format_string(format_string);
-                nf.id(parser().attribute<std::size_t>("numFmtId"));
+                nf.id(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("numFmtId")));
 
-                expect_end_element(qn("spreadsheetml", "numFmt"));
+                expect_end_element(XLNT_QN("spreadsheetml", "numFmt"));
 
                 number_formats.push_back(nf);
             }
@@ -2634,35 +3342,35 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "cellStyles"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "cellStyles"))
         {
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
 
-            while (in_element(qn("spreadsheetml", "cellStyles")))
+            while (in_element(XLNT_QN("spreadsheetml", "cellStyles")))
             {
                 auto &data = *styles.emplace(styles.end());
 
-                expect_start_element(qn("spreadsheetml", "cellStyle"), xml::content::simple);
+                expect_start_element(XLNT_QN("spreadsheetml", "cellStyle"), xml::content::simple);
 
-                data.first.name = parser().attribute("name");
-                data.second = parser().attribute<std::size_t>("xfId");
+                data.first.name = parser().attribute(XLNT_ATTRIBUTE_QN("name"));
+                data.second = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("xfId"));
 
-                if (parser().attribute_present("builtinId"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("builtinId")))
                 {
-                    data.first.builtin_id = parser().attribute<std::size_t>("builtinId");
+                    data.first.builtin_id = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("builtinId"));
                 }
 
-                if (parser().attribute_present("hidden"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("hidden")))
                 {
-                    data.first.hidden_style = is_true(parser().attribute("hidden"));
+                    data.first.hidden_style = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("hidden")));
                 }
 
-                if (parser().attribute_present("customBuiltin"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("customBuiltin")))
                 {
-                    data.first.custom_builtin = is_true(parser().attribute("customBuiltin"));
+                    data.first.custom_builtin = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("customBuiltin")));
                 }
 
-                expect_end_element(qn("spreadsheetml", "cellStyle"));
+                expect_end_element(XLNT_QN("spreadsheetml", "cellStyle"));
             }
 
             if (count != styles.size())
@@ -2670,127 +3378,127 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "cellStyleXfs")
-            || current_style_element == qn("spreadsheetml", "cellXfs"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "cellStyleXfs")
+            || current_style_element == XLNT_QN("spreadsheetml", "cellXfs"))
         {
             auto in_style_records = current_style_element.name() == "cellStyleXfs";
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
 
             while (in_element(current_style_element))
             {
-                expect_start_element(qn("spreadsheetml", "xf"), xml::content::complex);
+                expect_start_element(XLNT_QN("spreadsheetml", "xf"), xml::content::complex);
 
                 auto &record = *(!in_style_records
                         ? format_records.emplace(format_records.end())
                         : style_records.emplace(style_records.end()));
 
-                if (parser().attribute_present("applyBorder"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("applyBorder")))
                 {
-                    record.first.border_applied = is_true(parser().attribute("applyBorder"));
+                    record.first.border_applied = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("applyBorder")));
                 }
-                record.first.border_id = parser().attribute_present("borderId")
-                    ? parser().attribute<std::size_t>("borderId")
+                record.first.border_id = parser().attribute_present(XLNT_ATTRIBUTE_QN("borderId"))
+                    ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("borderId"))
                     : optional<std::size_t>();
 
-                if (parser().attribute_present("applyFill"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("applyFill")))
                 {
-                    record.first.fill_applied = is_true(parser().attribute("applyFill"));
+                    record.first.fill_applied = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("applyFill")));
                 }
-                record.first.fill_id = parser().attribute_present("fillId")
-                    ? parser().attribute<std::size_t>("fillId")
+                record.first.fill_id = parser().attribute_present(XLNT_ATTRIBUTE_QN("fillId"))
+                    ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("fillId"))
                     : optional<std::size_t>();
 
-                if (parser().attribute_present("applyFont"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("applyFont")))
                 {
-                    record.first.font_applied = is_true(parser().attribute("applyFont"));
+                    record.first.font_applied = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("applyFont")));
                 }
-                record.first.font_id = parser().attribute_present("fontId")
-                    ? parser().attribute<std::size_t>("fontId")
+                record.first.font_id = parser().attribute_present(XLNT_ATTRIBUTE_QN("fontId"))
+                    ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("fontId"))
                     : optional<std::size_t>();
 
-                if (parser().attribute_present("applyNumberFormat"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("applyNumberFormat")))
                 {
-                    record.first.number_format_applied = is_true(parser().attribute("applyNumberFormat"));
+                    record.first.number_format_applied = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("applyNumberFormat")));
                 }
-                record.first.number_format_id = parser().attribute_present("numFmtId")
-                    ? parser().attribute<std::size_t>("numFmtId")
+                record.first.number_format_id = parser().attribute_present(XLNT_ATTRIBUTE_QN("numFmtId"))
+                    ? parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("numFmtId"))
                     : optional<std::size_t>();
 
-                auto apply_alignment_present = parser().attribute_present("applyAlignment");
+                auto apply_alignment_present = parser().attribute_present(XLNT_ATTRIBUTE_QN("applyAlignment"));
                 if (apply_alignment_present)
                 {
-                    record.first.alignment_applied = is_true(parser().attribute("applyAlignment"));
+                    record.first.alignment_applied = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("applyAlignment")));
                 }
 
-                auto apply_protection_present = parser().attribute_present("applyProtection");
+                auto apply_protection_present = parser().attribute_present(XLNT_ATTRIBUTE_QN("applyProtection"));
                 if (apply_protection_present)
                 {
-                    record.first.protection_applied = is_true(parser().attribute("applyProtection"));
+                    record.first.protection_applied = is_true(parser().attribute(XLNT_ATTRIBUTE_QN("applyProtection")));
                 }
 
-                record.first.pivot_button_ = parser().attribute_present("pivotButton")
-                    && is_true(parser().attribute("pivotButton"));
-                record.first.quote_prefix_ = parser().attribute_present("quotePrefix")
-                    && is_true(parser().attribute("quotePrefix"));
+                record.first.pivot_button_ = parser().attribute_present(XLNT_ATTRIBUTE_QN("pivotButton"))
+                    && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("pivotButton")));
+                record.first.quote_prefix_ = parser().attribute_present(XLNT_ATTRIBUTE_QN("quotePrefix"))
+                    && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("quotePrefix")));
 
-                if (parser().attribute_present("xfId"))
+                if (parser().attribute_present(XLNT_ATTRIBUTE_QN("xfId")))
                 {
-                    record.second = parser().attribute<std::size_t>("xfId");
+                    record.second = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("xfId"));
                 }
 
-                while (in_element(qn("spreadsheetml", "xf")))
+                while (in_element(XLNT_QN("spreadsheetml", "xf")))
                 {
                     auto xf_child_element = expect_start_element(xml::content::simple);
 
-                    if (xf_child_element == qn("spreadsheetml", "alignment"))
+                    if (xf_child_element == XLNT_QN("spreadsheetml", "alignment"))
                     {
                         record.first.alignment_id = stylesheet.alignments.size();
                         auto &alignment = *stylesheet.alignments.emplace(stylesheet.alignments.end());
 
-                        if (parser().attribute_present("wrapText"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("wrapText")))
                         {
-                            alignment.wrap(is_true(parser().attribute("wrapText")));
+                            alignment.wrap(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("wrapText"))));
                         }
 
-                        if (parser().attribute_present("shrinkToFit"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("shrinkToFit")))
                         {
-                            alignment.shrink(is_true(parser().attribute("shrinkToFit")));
+                            alignment.shrink(is_true(parser().attribute(XLNT_ATTRIBUTE_QN("shrinkToFit"))));
                         }
 
-                        if (parser().attribute_present("indent"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("indent")))
                         {
-                            alignment.indent(parser().attribute<int>("indent"));
+                            alignment.indent(parser().attribute<int>(XLNT_ATTRIBUTE_QN("indent")));
                         }
 
-                        if (parser().attribute_present("textRotation"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("textRotation")))
                         {
-                            alignment.rotation(parser().attribute<int>("textRotation"));
+                            alignment.rotation(parser().attribute<int>(XLNT_ATTRIBUTE_QN("textRotation")));
                         }
 
-                        if (parser().attribute_present("vertical"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("vertical")))
                         {
-                            alignment.vertical(parser().attribute<xlnt::vertical_alignment>("vertical"));
+                            alignment.vertical(parser().attribute<xlnt::vertical_alignment>(XLNT_ATTRIBUTE_QN("vertical")));
                         }
 
-                        if (parser().attribute_present("horizontal"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("horizontal")))
                         {
-                            alignment.horizontal(parser().attribute<xlnt::horizontal_alignment>("horizontal"));
+                            alignment.horizontal(parser().attribute<xlnt::horizontal_alignment>(XLNT_ATTRIBUTE_QN("horizontal")));
                         }
 
-                        if (parser().attribute_present("readingOrder"))
+                        if (parser().attribute_present(XLNT_ATTRIBUTE_QN("readingOrder")))
                         {
-                            parser().attribute<int>("readingOrder");
+                            parser().attribute<int>(XLNT_ATTRIBUTE_QN("readingOrder"));
                         }
                     }
-                    else if (xf_child_element == qn("spreadsheetml", "protection"))
+                    else if (xf_child_element == XLNT_QN("spreadsheetml", "protection"))
                     {
                         record.first.protection_id = stylesheet.protections.size();
                         auto &protection = *stylesheet.protections.emplace(stylesheet.protections.end());
 
-                        protection.locked(parser().attribute_present("locked")
-                            && is_true(parser().attribute("locked")));
-                        protection.hidden(parser().attribute_present("hidden")
-                            && is_true(parser().attribute("hidden")));
+                        protection.locked(parser().attribute_present(XLNT_ATTRIBUTE_QN("locked"))
+                            && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("locked"))));
+                        protection.hidden(parser().attribute_present(XLNT_ATTRIBUTE_QN("hidden"))
+                            && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("hidden"))));
                     }
                     else
                     {
@@ -2800,7 +3508,7 @@ void xlsx_consumer::read_stylesheet()
                     expect_end_element(xf_child_element);
                 }
 
-                expect_end_element(qn("spreadsheetml", "xf"));
+                expect_end_element(XLNT_QN("spreadsheetml", "xf"));
             }
 
             if ((in_style_records && count != style_records.size())
@@ -2809,9 +3517,9 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "dxfs"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "dxfs"))
         {
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
             std::size_t processed = 0;
 
             while (in_element(current_style_element))
@@ -2827,15 +3535,15 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "tableStyles"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "tableStyles"))
         {
-            skip_attribute("defaultTableStyle");
-            skip_attribute("defaultPivotStyle");
+            skip_attribute(XLNT_ATTRIBUTE_QN("defaultTableStyle"));
+            skip_attribute(XLNT_ATTRIBUTE_QN("defaultPivotStyle"));
 
-            auto count = parser().attribute<std::size_t>("count");
+            auto count = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("count"));
             std::size_t processed = 0;
 
-            while (in_element(qn("spreadsheetml", "tableStyles")))
+            while (in_element(XLNT_QN("spreadsheetml", "tableStyles")))
             {
                 auto current_element = expect_start_element(xml::content::complex);
                 skip_remaining_content(current_element);
@@ -2848,44 +3556,44 @@ void xlsx_consumer::read_stylesheet()
                 throw xlnt::exception("counts don't match");
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "extLst"))
+        else if (current_style_element == XLNT_QN("spreadsheetml", "extLst"))
         {
-            while (in_element(qn("spreadsheetml", "extLst")))
+            while (in_element(XLNT_QN("spreadsheetml", "extLst")))
             {
-                expect_start_element(qn("spreadsheetml", "ext"), xml::content::complex);
+                expect_start_element(XLNT_QN("spreadsheetml", "ext"), xml::content::complex);
 
-                const auto uri = parser().attribute("uri");
+                const auto uri = parser().attribute(XLNT_ATTRIBUTE_QN("uri"));
 
                 if (uri == "{EB79DEF2-80B8-43e5-95BD-54CBDDF9020C}") // slicerStyles
                 {
-                    expect_start_element(qn("x14", "slicerStyles"), xml::content::simple);
-                    stylesheet.default_slicer_style = parser().attribute("defaultSlicerStyle");
-                    expect_end_element(qn("x14", "slicerStyles"));
+                    expect_start_element(XLNT_QN("x14", "slicerStyles"), xml::content::simple);
+                    stylesheet.default_slicer_style = parser().attribute(XLNT_ATTRIBUTE_QN("defaultSlicerStyle"));
+                    expect_end_element(XLNT_QN("x14", "slicerStyles"));
                 }
                 else
                 {
-                    skip_remaining_content(qn("spreadsheetml", "ext"));
+                    skip_remaining_content(XLNT_QN("spreadsheetml", "ext"));
                 }
 
-                expect_end_element(qn("spreadsheetml", "ext"));
+                expect_end_element(XLNT_QN("spreadsheetml", "ext"));
             }
         }
-        else if (current_style_element == qn("spreadsheetml", "colors")) // CT_Colors 0-1
+        else if (current_style_element == XLNT_QN("spreadsheetml", "colors")) // CT_Colors 0-1
         {
-            while (in_element(qn("spreadsheetml", "colors")))
+            while (in_element(XLNT_QN("spreadsheetml", "colors")))
             {
                 auto colors_child_element = expect_start_element(xml::content::complex);
 
-                if (colors_child_element == qn("spreadsheetml", "indexedColors")) // CT_IndexedColors 0-1
+                if (colors_child_element == XLNT_QN("spreadsheetml", "indexedColors")) // CT_IndexedColors 0-1
                 {
                     while (in_element(colors_child_element))
                     {
-                        expect_start_element(qn("spreadsheetml", "rgbColor"), xml::content::simple);
+                        expect_start_element(XLNT_QN("spreadsheetml", "rgbColor"), xml::content::simple);
                         stylesheet.colors.push_back(read_color());
-                        expect_end_element(qn("spreadsheetml", "rgbColor"));
+                        expect_end_element(XLNT_QN("spreadsheetml", "rgbColor"));
                     }
                 }
-                else if (colors_child_element == qn("spreadsheetml", "mruColors")) // CT_MRUColors
+                else if (colors_child_element == XLNT_QN("spreadsheetml", "mruColors")) // CT_MRUColors
                 {
                     skip_remaining_content(colors_child_element);
                 }
@@ -2905,7 +3613,7 @@ void xlsx_consumer::read_stylesheet()
         expect_end_element(current_style_element);
     }
 
-    expect_end_element(qn("spreadsheetml", "styleSheet"));
+    expect_end_element(XLNT_QN("spreadsheetml", "styleSheet"));
 
     std::size_t xf_id = 0;
 
@@ -2979,7 +3687,7 @@ void xlsx_consumer::read_theme()
         relationship_type::theme);
     auto theme_path = manifest().canonicalize({workbook_rel, theme_rel});
 
-    target_.theme(theme());
+    target_->theme(theme());
 
     if (manifest().has_relationship(theme_path, relationship_type::image))
     {
@@ -3003,47 +3711,47 @@ void xlsx_consumer::read_comments(worksheet ws)
 {
     std::vector<std::string> authors;
 
-    expect_start_element(qn("spreadsheetml", "comments"), xml::content::complex);
+    expect_start_element(XLNT_QN("spreadsheetml", "comments"), xml::content::complex);
     // name space can be ignored
-    skip_attribute(qn("mc", "Ignorable"));
-    expect_start_element(qn("spreadsheetml", "authors"), xml::content::complex);
+    skip_attribute(XLNT_QN("mc", "Ignorable"));
+    expect_start_element(XLNT_QN("spreadsheetml", "authors"), xml::content::complex);
 
-    while (in_element(qn("spreadsheetml", "authors")))
+    while (in_element(XLNT_QN("spreadsheetml", "authors")))
     {
-        expect_start_element(qn("spreadsheetml", "author"), xml::content::simple);
+        expect_start_element(XLNT_QN("spreadsheetml", "author"), xml::content::simple);
         authors.push_back(read_text());
-        expect_end_element(qn("spreadsheetml", "author"));
+        expect_end_element(XLNT_QN("spreadsheetml", "author"));
     }
 
-    expect_end_element(qn("spreadsheetml", "authors"));
-    expect_start_element(qn("spreadsheetml", "commentList"), xml::content::complex);
+    expect_end_element(XLNT_QN("spreadsheetml", "authors"));
+    expect_start_element(XLNT_QN("spreadsheetml", "commentList"), xml::content::complex);
 
-    while (in_element(xml::qname(qn("spreadsheetml", "commentList"))))
+    while (in_element(XLNT_QN("spreadsheetml", "commentList")))
     {
-        expect_start_element(qn("spreadsheetml", "comment"), xml::content::complex);
+        expect_start_element(XLNT_QN("spreadsheetml", "comment"), xml::content::complex);
 
-        skip_attribute("shapeId");
-        auto cell_ref = parser().attribute("ref");
-        auto author_id = parser().attribute<std::size_t>("authorId");
+        skip_attribute(XLNT_ATTRIBUTE_QN("shapeId"));
+        auto cell_ref = parser().attribute(XLNT_ATTRIBUTE_QN("ref"));
+        auto author_id = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("authorId"));
 
-        expect_start_element(qn("spreadsheetml", "text"), xml::content::complex);
+        expect_start_element(XLNT_QN("spreadsheetml", "text"), xml::content::complex);
 
-        ws.cell(cell_ref).comment(comment(read_rich_text(qn("spreadsheetml", "text")), authors.at(author_id)));
+        ws.cell(cell_ref).comment(comment(read_rich_text(XLNT_QN("spreadsheetml", "text")), authors.at(author_id)));
 
-        expect_end_element(qn("spreadsheetml", "text"));
+        expect_end_element(XLNT_QN("spreadsheetml", "text"));
 
-        if (in_element(xml::qname(qn("spreadsheetml", "comment"))))
+        if (in_element(XLNT_QN("spreadsheetml", "comment")))
         {
-            expect_start_element(qn("mc", "AlternateContent"), xml::content::complex);
-            skip_remaining_content(qn("mc", "AlternateContent"));
-            expect_end_element(qn("mc", "AlternateContent"));
+            expect_start_element(XLNT_QN("mc", "AlternateContent"), xml::content::complex);
+            skip_remaining_content(XLNT_QN("mc", "AlternateContent"));
+            expect_end_element(XLNT_QN("mc", "AlternateContent"));
         }
 
-        expect_end_element(qn("spreadsheetml", "comment"));
+        expect_end_element(XLNT_QN("spreadsheetml", "comment"));
     }
 
-    expect_end_element(qn("spreadsheetml", "commentList"));
-    expect_end_element(qn("spreadsheetml", "comments"));
+    expect_end_element(XLNT_QN("spreadsheetml", "commentList"));
+    expect_end_element(XLNT_QN("spreadsheetml", "comments"));
 }
 
 void xlsx_consumer::read_drawings(worksheet ws, const path &part)
@@ -3080,16 +3788,28 @@ void xlsx_consumer::read_unknown_relationships()
 
 void xlsx_consumer::read_image(const xlnt::path &image_path)
 {
+    if (options_.skip_images)
+    {
+        target_->d_->skipped_parts_ = true;
+        return;
+    }
+
     auto image_streambuf = archive_->open(image_path);
-    vector_ostreambuf buffer(target_.d_->images_[image_path.string()]);
+    vector_ostreambuf buffer(target_->d_->images_[image_path.string()]);
     std::ostream out_stream(&buffer);
     out_stream << image_streambuf.get();
 }
 
 void xlsx_consumer::read_binary(const xlnt::path &binary_path)
 {
+    if (options_.skip_binaries)
+    {
+        target_->d_->skipped_parts_ = true;
+        return;
+    }
+
     auto binary_streambuf = archive_->open(binary_path);
-    vector_ostreambuf buffer(target_.d_->binaries_[binary_path.string()]);
+    vector_ostreambuf buffer(target_->d_->binaries_[binary_path.string()]);
     std::ostream out_stream(&buffer);
     out_stream << binary_streambuf.get();
 }
@@ -3097,14 +3817,20 @@ void xlsx_consumer::read_binary(const xlnt::path &binary_path)
 std::string xlsx_consumer::read_text()
 {
     auto text = std::string();
+    read_text(text);
+
+    return text;
+}
+
+void xlsx_consumer::read_text(std::string &text)
+{
+    text.clear();
 
     while (parser().peek() == xml::parser::event_type::characters)
     {
         parser().next_expect(xml::parser::event_type::characters);
         text.append(parser().value());
     }
-
-    return text;
 }
 
 variant xlsx_consumer::read_variant()
@@ -3116,22 +3842,22 @@ variant xlsx_consumer::read_variant()
         auto element = expect_start_element(xml::content::mixed);
         auto text = read_text();
 
-        if (element == qn("vt", "lpwstr") || element == qn("vt", "lpstr"))
+        if (element == XLNT_QN("vt", "lpwstr") || element == XLNT_QN("vt", "lpstr"))
         {
             value = variant(text);
         }
-        if (element == qn("vt", "i4"))
+        if (element == XLNT_QN("vt", "i4"))
         {
             value = variant(std::stoi(text));
         }
-        if (element == qn("vt", "bool"))
+        if (element == XLNT_QN("vt", "bool"))
         {
             value = variant(is_true(text));
         }
-        else if (element == qn("vt", "vector"))
+        else if (element == XLNT_QN("vt", "vector"))
         {
-            auto size = parser().attribute<std::size_t>("size");
-            auto base_type = parser().attribute("baseType");
+            auto size = parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("size"));
+            auto base_type = parser().attribute(XLNT_ATTRIBUTE_QN("baseType"));
 
             std::vector<variant> vector;
 
@@ -3139,14 +3865,14 @@ variant xlsx_consumer::read_variant()
             {
                 if (base_type == "variant")
                 {
-                    expect_start_element(qn("vt", "variant"), xml::content::complex);
+                    expect_start_element(XLNT_QN("vt", "variant"), xml::content::complex);
                 }
 
                 vector.push_back(read_variant());
 
                 if (base_type == "variant")
                 {
-                    expect_end_element(qn("vt", "variant"));
+                    expect_end_element(XLNT_QN("vt", "variant"));
                     read_text();
                 }
             }
@@ -3161,17 +3887,6 @@ variant xlsx_consumer::read_variant()
     return value;
 }
 
-void xlsx_consumer::skip_attributes(const std::vector<std::string> &names)
-{
-    for (const auto &name : names)
-    {
-        if (parser().attribute_present(name))
-        {
-            parser().attribute(name);
-        }
-    }
-}
-
 void xlsx_consumer::skip_attributes(const std::vector<xml::qname> &names)
 {
     for (const auto &name : names)
@@ -3196,14 +3911,6 @@ void xlsx_consumer::skip_attribute(const xml::qname &name)
     }
 }
 
-void xlsx_consumer::skip_attribute(const std::string &name)
-{
-    if (parser().attribute_present(name))
-    {
-        parser().attribute(name);
-    }
-}
-
 void xlsx_consumer::skip_remaining_content(const xml::qname &name)
 {
     // start by assuming we've already parsed the opening tag
@@ -3233,7 +3940,7 @@ xml::qname xlsx_consumer::expect_start_element(xml::content content)
     parser().content(content);
     stack_.push_back(parser().qname());
 
-    const auto xml_space = qn("xml", "space");
+    const auto &xml_space = XLNT_QN("xml", "space");
     preserve_space_ = parser().attribute_present(xml_space) ? parser().attribute(xml_space) == "preserve" : false;
 
     return stack_.back();
@@ -3245,7 +3952,7 @@ void xlsx_consumer::expect_start_element(const xml::qname &name, xml::content co
     parser().content(content);
     stack_.push_back(name);
 
-    const auto xml_space = qn("xml", "space");
+    const auto &xml_space = XLNT_QN("xml", "space");
     preserve_space_ = parser().attribute_present(xml_space) ? parser().attribute(xml_space) == "preserve" : false;
 }
 
@@ -3273,86 +3980,86 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
     while (in_element(parent))
     {
         auto text_element = expect_start_element(xml::content::mixed);
-        const auto xml_space = qn("xml", "space");
+        const auto &xml_space = XLNT_QN("xml", "space");
         const auto preserve_space = parser().attribute_present(xml_space)
             ? parser().attribute(xml_space) == "preserve"
             : false;
         skip_attributes();
         auto text = read_text();
 
-        if (text_element == xml::qname(xmlns, "t"))
+        if (is_name(text_element, xmlns, "t"))
         {
             t.plain_text(text, preserve_space);
         }
-        else if (text_element == xml::qname(xmlns, "r"))
+        else if (is_name(text_element, xmlns, "r"))
         {
             rich_text_run run;
             run.preserve_space = preserve_space;
 
-            while (in_element(xml::qname(xmlns, "r")))
+            while (in_element(text_element))
             {
                 auto run_element = expect_start_element(xml::content::mixed);
                 auto run_text = read_text();
 
-                if (run_element == xml::qname(xmlns, "rPr"))
+                if (is_name(run_element, xmlns, "rPr"))
                 {
                     run.second = xlnt::font();
 
-                    while (in_element(xml::qname(xmlns, "rPr")))
+                    while (in_element(run_element))
                     {
                         auto current_run_property_element = expect_start_element(xml::content::simple);
 
-                        if (current_run_property_element == xml::qname(xmlns, "sz"))
+                        if (is_name(current_run_property_element, xmlns, "sz"))
                         {
-                            run.second.get().size(converter_.deserialise(parser().attribute("val")));
+                            run.second.get().size(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("val"))));
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "rFont"))
+                        else if (is_name(current_run_property_element, xmlns, "rFont"))
                         {
-                            run.second.get().name(parser().attribute("val"));
+                            run.second.get().name(parser().attribute(XLNT_ATTRIBUTE_QN("val")));
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "color"))
+                        else if (is_name(current_run_property_element, xmlns, "color"))
                         {
                             run.second.get().color(read_color());
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "family"))
+                        else if (is_name(current_run_property_element, xmlns, "family"))
                         {
-                            run.second.get().family(parser().attribute<std::size_t>("val"));
+                            run.second.get().family(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("val")));
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "charset"))
+                        else if (is_name(current_run_property_element, xmlns, "charset"))
                         {
-                            run.second.get().charset(parser().attribute<std::size_t>("val"));
+                            run.second.get().charset(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("val")));
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "scheme"))
+                        else if (is_name(current_run_property_element, xmlns, "scheme"))
                         {
-                            run.second.get().scheme(parser().attribute("val"));
+                            run.second.get().scheme(parser().attribute(XLNT_ATTRIBUTE_QN("val")));
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "b"))
+                        else if (is_name(current_run_property_element, xmlns, "b"))
                         {
-                            run.second.get().bold(parser().attribute_present("val")
-                                    ? is_true(parser().attribute("val"))
+                            run.second.get().bold(parser().attribute_present(XLNT_ATTRIBUTE_QN("val"))
+                                    ? is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val")))
                                     : true);
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "i"))
+                        else if (is_name(current_run_property_element, xmlns, "i"))
                         {
-                            run.second.get().italic(parser().attribute_present("val")
-                                    ? is_true(parser().attribute("val"))
+                            run.second.get().italic(parser().attribute_present(XLNT_ATTRIBUTE_QN("val"))
+                                    ? is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val")))
                                     : true);
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "u"))
+                        else if (is_name(current_run_property_element, xmlns, "u"))
                         {
-                            if (parser().attribute_present("val"))
+                            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("val")))
                             {
-                                run.second.get().underline(parser().attribute<font::underline_style>("val"));
+                                run.second.get().underline(parser().attribute<font::underline_style>(XLNT_ATTRIBUTE_QN("val")));
                             }
                             else
                             {
                                 run.second.get().underline(font::underline_style::single);
                             }
                         }
-                        else if (current_run_property_element == xml::qname(xmlns, "strike"))
+                        else if (is_name(current_run_property_element, xmlns, "strike"))
                         {
-                            run.second.get().strikethrough(parser().attribute_present("val")
-                                    ? is_true(parser().attribute("val"))
+                            run.second.get().strikethrough(parser().attribute_present(XLNT_ATTRIBUTE_QN("val"))
+                                    ? is_true(parser().attribute(XLNT_ATTRIBUTE_QN("val")))
                                     : true);
                         }
                         else
@@ -3364,7 +4071,7 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
                         read_text();
                     }
                 }
-                else if (run_element == xml::qname(xmlns, "t"))
+                else if (is_name(run_element, xmlns, "t"))
                 {
                     run.first = run_text;
                 }
@@ -3380,11 +4087,11 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
 
             t.add_run(run);
         }
-        else if (text_element == xml::qname(xmlns, "rPh"))
+        else if (is_name(text_element, xmlns, "rPh"))
         {
             phonetic_run pr;
-            pr.start = parser().attribute<std::uint32_t>("sb");
-            pr.end = parser().attribute<std::uint32_t>("eb");
+            pr.start = parser().attribute<std::uint32_t>(XLNT_ATTRIBUTE_QN("sb"));
+            pr.end = parser().attribute<std::uint32_t>(XLNT_ATTRIBUTE_QN("eb"));
 
             expect_start_element(xml::qname(xmlns, "t"), xml::content::simple);
             pr.text = read_text();
@@ -3398,16 +4105,16 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
 
             t.add_phonetic_run(pr);
         }
-        else if (text_element == xml::qname(xmlns, "phoneticPr"))
+        else if (is_name(text_element, xmlns, "phoneticPr"))
         {
-            phonetic_pr ph(parser().attribute<phonetic_pr::font_id_t>("fontId"));
-            if (parser().attribute_present("type"))
+            phonetic_pr ph(parser().attribute<phonetic_pr::font_id_t>(XLNT_ATTRIBUTE_QN("fontId")));
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("type")))
             {
-                ph.type(phonetic_pr::type_from_string(parser().attribute("type")));
+                ph.type(phonetic_pr::type_from_string(parser().attribute(XLNT_ATTRIBUTE_QN("type"))));
             }
-            if (parser().attribute_present("alignment"))
+            if (parser().attribute_present(XLNT_ATTRIBUTE_QN("alignment")))
             {
-                ph.alignment(phonetic_pr::alignment_from_string(parser().attribute("alignment")));
+                ph.alignment(phonetic_pr::alignment_from_string(parser().attribute(XLNT_ATTRIBUTE_QN("alignment"))));
             }
             t.phonetic_properties(ph);
         }
@@ -3427,28 +4134,28 @@ xlnt::color xlsx_consumer::read_color()
 {
     xlnt::color result;
 
-    if (parser().attribute_present("auto") && is_true(parser().attribute("auto")))
+    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("auto")) && is_true(parser().attribute(XLNT_ATTRIBUTE_QN("auto"))))
     {
         result.auto_(true);
         return result;
     }
 
-    if (parser().attribute_present("rgb"))
+    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("rgb")))
     {
-        result = xlnt::rgb_color(parser().attribute("rgb"));
+        result = xlnt::rgb_color(parser().attribute(XLNT_ATTRIBUTE_QN("rgb")));
     }
-    else if (parser().attribute_present("theme"))
+    else if (parser().attribute_present(XLNT_ATTRIBUTE_QN("theme")))
     {
-        result = xlnt::theme_color(parser().attribute<std::size_t>("theme"));
+        result = xlnt::theme_color(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("theme")));
     }
-    else if (parser().attribute_present("indexed"))
+    else if (parser().attribute_present(XLNT_ATTRIBUTE_QN("indexed")))
     {
-        result = xlnt::indexed_color(parser().attribute<std::size_t>("indexed"));
+        result = xlnt::indexed_color(parser().attribute<std::size_t>(XLNT_ATTRIBUTE_QN("indexed")));
     }
 
-    if (parser().attribute_present("tint"))
+    if (parser().attribute_present(XLNT_ATTRIBUTE_QN("tint")))
     {
-        result.tint(converter_.deserialise(parser().attribute("tint")));
+        result.tint(converter_.deserialise(parser().attribute(XLNT_ATTRIBUTE_QN("tint"))));
     }
 
     return result;
@@ -3456,7 +4163,7 @@ xlnt::color xlsx_consumer::read_color()
 
 manifest &xlsx_consumer::manifest()
 {
-    return target_.manifest();
+    return target_->manifest();
 }
 
 } // namespace detail
@@ -34,7 +34,9 @@
 
 #include <detail/external/include_libstudxml.hpp>
 #include <detail/serialization/zstream.hpp>
+#include <xlnt/cell/index_types.hpp>
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/workbook/load_options.hpp>
 
 namespace xlnt {
 
@@ -55,14 +57,31 @@ class worksheet;
 namespace detail {
 
 class izstream;
+class sheet_data_reader;
+class sheet_data_scanner;
+struct Cell;
 struct cell_impl;
+struct sheet_data_batch;
 struct defined_name;
+struct prepared_worksheet;
 struct worksheet_impl;
 
+/// <summary>
+/// Whether <sheetData> is scanned on a thread of its own while the cells are
+/// added to the worksheet. Automatically, this is the case when the part spans
+/// more than one window and there's a second core.
+/// </summary>
+enum class sheet_data_threading
+{
+    automatic,
+    always,
+    never
+};
+
 /// <summary>
 /// Handles writing a workbook into an XLSX file.
 /// </summary>
-class xlsx_consumer
+class XLNT_API xlsx_consumer
 {
 public:
 	xlsx_consumer(workbook &destination);
@@ -73,6 +92,36 @@ public:
 
 	void read(std::istream &source, const std::string &password);
 
+	void read(std::istream &source, const load_options &options);
+
+	/// <summary>
+	/// Returns true if a lazy load left worksheets unread.
+	/// </summary>
+	bool has_deferred_worksheets() const;
+
+	/// <summary>
+	/// Reads ws from the package if a lazy load left it unread.
+	/// </summary>
+	void read_deferred_worksheet(worksheet_impl *ws);
+
+	/// <summary>
+	/// Reads every worksheet a lazy load left unread.
+	/// </summary>
+	void read_deferred_worksheets();
+
+	/// <summary>
+	/// Sets the workbook deferred worksheets are read into after the one
+	/// this was constructed with has been moved or swapped.
+	/// </summary>
+	void destination(workbook &destination);
+
+	/// <summary>
+	/// Reads <sheetData> in windows of window_size bytes with the given threading
+	/// from now on. The defaults suit real workbooks, this lets tests take every
+	/// path with small parts on any machine.
+	/// </summary>
+	void sheet_data_reading(std::size_t window_size, sheet_data_threading threading);
+
 private:
     friend class xlnt::streaming_workbook_reader;
 
@@ -215,11 +264,66 @@ private:
     /// </summary>
     void read_worksheet_sheetdata();
 
+    /// <summary>
+    /// Reads the content of <sheetData> a window at a time from reader with
+    /// sheet_data_scanner instead of the XML parser. Returns false if the content
+    /// uses markup the scanner doesn't handle, in which case cells and rows which
+    /// were already added must be discarded by the caller. x14ac_prefix is the
+    /// prefix the part declares for the x14ac namespace, if any.
+    /// </summary>
+    bool read_worksheet_sheetdata(sheet_data_reader &reader,
+        const std::string &prefix, const std::string &x14ac_prefix);
+
+    /// <summary>
+    /// Fills batch with the next rows and cells from scanner. row is the
+    /// number of the row being scanned and is carried between batches.
+    /// Returns false if the scanner gave up.
+    /// </summary>
+    bool scan_sheet_data(sheet_data_scanner &scanner, row_t &row, sheet_data_batch &batch, bool &end_of_data);
+
+    /// <summary>
+    /// Adds the rows and cells of a batch filled by scan_sheet_data to the current worksheet.
+    /// </summary>
+    void add_sheet_data(sheet_data_batch &batch);
+
+    /// <summary>
+    /// Adds a cell parsed from <sheetData> to the current worksheet.
+    /// </summary>
+    void add_cell(Cell &cell);
+
+    /// <summary>
+    /// Reserves room in the current worksheet for the cells and rows of the range
+    /// declared by its <dimension> element. Invalid references are ignored.
+    /// </summary>
+    void reserve_worksheet(const std::string &dimension);
+
     /// <summary>
     /// xl/sheets/*.xml
     /// </summary>
     worksheet read_worksheet_end(const std::string &rel_id);
 
+    /// <summary>
+    /// Reads the worksheet part in part_stream into part_data. Cells are added to the
+    /// current worksheet and left out of part_data where the sheetData scanner can
+    /// read them, leaving the rest of the part for the XML parser. If the scanner
+    /// gives up part of the way through, the part is read again from reopen_part.
+    /// </summary>
+    void read_worksheet_data(std::istream &part_stream, std::string &part_data,
+        const std::function<std::unique_ptr<std::streambuf>()> &reopen_part);
+
+    /// <summary>
+    /// Runs read_worksheet_data for each pair of part path and worksheet on up to
+    /// options_.worksheet_threads threads. The results are kept in prepared_worksheets_
+    /// until read_part reads the rest of each part.
+    /// </summary>
+    void prepare_worksheets(const std::vector<std::pair<path, worksheet_impl *>> &worksheets);
+
+    /// <summary>
+    /// Removes worksheets which load_options::sheets left out, keeping the
+    /// hidden flags and active sheet of the rest in place.
+    /// </summary>
+    void remove_worksheets(const std::vector<worksheet_impl *> &worksheets);
+
 	// Sheet Relationship Target Parts
 
 	/// <summary>
@@ -295,6 +399,11 @@ private:
     /// </summary>
     std::string read_text();
 
+    /// <summary>
+    /// As above, but replaces the contents of text so that its capacity can be reused.
+    /// </summary>
+    void read_text(std::string &text);
+
     variant read_variant();
 
     /// <summary>
@@ -311,12 +420,6 @@ private:
     /// </summary>
     void skip_attributes();
 
-    /// <summary>
-    /// Skip attribute name if it exists on the currently parsed element in the XML
-    /// parser.
-    /// </summary>
-    void skip_attribute(const std::string &name);
-
     /// <summary>
     /// Skip attribute name if it exists on the currently parsed element in the XML
     /// parser.
@@ -328,11 +431,6 @@ private:
     /// </summary>
     void skip_attributes(const std::vector<xml::qname> &names);
 
-    /// <summary>
-    /// Call skip_attribute on every name in names.
-    /// </summary>
-    void skip_attributes(const std::vector<std::string> &names);
-
     /// <summary>
     /// Read all content in name until the closing tag is reached.
     /// The closing tag will not be handled after this is called.
@@ -401,9 +499,10 @@ private:
 	std::unordered_map<std::string, std::size_t> sheet_title_index_map_;
 
 	/// <summary>
-	/// A reference to the workbook which is being read.
+	/// The workbook which is being read. This is a pointer so that it can be
+	/// updated when a workbook with deferred worksheets is moved.
 	/// </summary>
-	workbook &target_;
+	workbook *target_;
 
 	/// <summary>
 	/// This pointer is generally set by instantiating an xml::parser in a function
@@ -419,6 +518,14 @@ private:
     bool streaming_ = false;
 
     std::unique_ptr<detail::cell_impl> streaming_cell_;
+
+    /// <summary>
+    /// The row being streamed and buffers for the text of the current cell,
+    /// kept between calls to has_cell so their capacity is reused.
+    /// </summary>
+    row_t streaming_row_ = 0;
+    std::string streaming_value_;
+    std::string streaming_formula_;
     
     std::unordered_map<int, std::string> shared_formulae_;
     std::unordered_map<std::string, std::string> array_formulae_;
@@ -427,6 +534,22 @@ private:
     number_serialiser converter_;
     
     std::vector<defined_name> defined_names_;
+
+    load_options options_;
+
+    /// <summary>
+    /// See sheet_data_reading. The consumers used by prepare_worksheets never
+    /// start a thread of their own to scan sheetData.
+    /// </summary>
+    std::size_t sheet_data_window_size_;
+    sheet_data_threading sheet_data_threading_ = sheet_data_threading::automatic;
+
+    std::unordered_map<const worksheet_impl *, std::unique_ptr<prepared_worksheet>> prepared_worksheets_;
+
+    /// <summary>
+    /// Worksheets which a lazy load left to be read when they're first accessed.
+    /// </summary>
+    std::vector<worksheet_impl *> deferred_worksheets_;
 };
 
 } // namespace detail
@@ -21,9 +21,15 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <iterator>
+#include <limits>
 #include <numeric> // for std::accumulate
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_set>
 
@@ -42,6 +48,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
 #include <detail/serialization/defined_name.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -75,6 +82,30 @@ std::vector<std::pair<std::string, std::string>> core_property_namespace(xlnt::c
     return {{constants::ns("core-properties"), "cp"}};
 }
 
+/// <summary>
+/// Returns the compression options asks for part, looking it up by name and
+/// then by extension in save_options::part_compression.
+/// </summary>
+const xlnt::compression_settings &part_compression(const xlnt::save_options &options, const xlnt::path &part)
+{
+    if (!options.part_compression.empty())
+    {
+        auto match = options.part_compression.find(part.string());
+
+        if (match == options.part_compression.end())
+        {
+            match = options.part_compression.find("." + part.extension());
+        }
+
+        if (match != options.part_compression.end())
+        {
+            return match->second;
+        }
+    }
+
+    return options.compression;
+}
+
 } // namespace
 
 namespace xlnt {
@@ -100,6 +131,65 @@ void xlsx_producer::write(std::ostream &destination)
     populate_archive(false);
 }
 
+void xlsx_producer::validate(const save_options &options)
+{
+    auto valid = [](const compression_settings &compression) {
+        return compression.level >= -1 && compression.level <= 9;
+    };
+
+    if (!valid(options.compression))
+    {
+        throw invalid_parameter();
+    }
+
+    for (const auto &part : options.part_compression)
+    {
+        if (!valid(part.second))
+        {
+            throw invalid_parameter();
+        }
+    }
+}
+
+void xlsx_producer::write(std::ostream &destination, const save_options &options)
+{
+    validate(options);
+    options_ = options;
+    write(destination);
+}
+
+std::size_t xlsx_producer::size_bound(const save_options &options)
+{
+    // with every part stored, the archive has the same headers as the real one
+    // and is as large as the parts, so only deflate's worst case has to be added
+    validate(options);
+    options_ = options;
+    options_.compression.level = 0;
+    options_.part_compression.clear();
+
+    buffer_ostreambuf counter(nullptr, std::numeric_limits<std::size_t>::max());
+    std::ostream counter_stream(&counter);
+    archive_.reset(new ozstream(counter_stream));
+    populate_archive(false);
+    end_part();
+
+    auto bound = std::size_t(0);
+
+    for (const auto &header : archive_->headers())
+    {
+        if (part_compression(options, path(header.filename)).level == 0) continue;
+
+        // as deflateBound in zlib: deflate stores blocks which don't get smaller
+        const std::size_t size = header.uncompressed_size;
+        bound += (size >> 12) + (size >> 14) + (size >> 25) + 7;
+    }
+
+    archive_.reset();
+    options_ = options;
+
+    return counter.size() + bound;
+}
+
 void xlsx_producer::open(std::ostream &destination)
 {
     archive_.reset(new ozstream(destination));
@@ -178,10 +268,93 @@ void xlsx_producer::end_part()
     current_part_streambuf_.reset();
 }
 
+std::unique_ptr<std::streambuf> xlsx_producer::open_part(const path &part)
+{
+    const auto &compression = part_compression(options_, part);
+
+    if (detached_parts_ == nullptr)
+    {
+        return archive_->open(part, compression);
+    }
+
+    // only one part is open at a time, so growing the vector can't move an entry being written
+    detached_parts_->emplace_back();
+    return ozstream::open_detached(part, detached_parts_->back(), compression);
+}
+
+std::vector<std::vector<zentry>> xlsx_producer::render_worksheets(const std::vector<relationship> &worksheet_rels)
+{
+    auto thread_count = options_.worksheet_threads;
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    thread_count = thread_count < worksheet_rels.size() ? thread_count : worksheet_rels.size();
+
+    // each worksheet gets its own producer so that part streams, serializers
+    // and the number buffer aren't shared between threads
+    std::vector<std::unique_ptr<xlsx_producer>> producers;
+    std::vector<std::vector<zentry>> results(worksheet_rels.size());
+    std::vector<std::exception_ptr> errors(worksheet_rels.size());
+
+    for (auto &result : results)
+    {
+        producers.emplace_back(new xlsx_producer(source_));
+        producers.back()->options_ = options_;
+        producers.back()->detached_parts_ = &result;
+    }
+
+    std::atomic<std::size_t> next_worksheet(0);
+
+    auto write_worksheets = [&]() {
+        for (auto i = next_worksheet++; i < worksheet_rels.size(); i = next_worksheet++)
+        {
+            try
+            {
+                const auto &rel = worksheet_rels[i];
+                producers[i]->begin_part(rel.source().path().parent().append(rel.target().path()));
+                producers[i]->write_worksheet(rel);
+                producers[i]->end_part();
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(write_worksheets);
+    }
+
+    write_worksheets();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // report the error a serial save would have hit first
+    for (auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return results;
+}
+
 void xlsx_producer::begin_part(const path &part)
 {
     end_part();
-    current_part_streambuf_ = archive_->open(part);
+    current_part_streambuf_ = open_part(part);
     current_part_stream_.rdbuf(current_part_streambuf_.get());
 
     auto xml_serializer = new xml::serializer(current_part_stream_, part.string(), 0);
@@ -720,6 +893,20 @@ void xlsx_producer::write_workbook(const relationship &rel)
     auto workbook_rels = source_.manifest().relationships(rel.target().path());
     write_relationships(workbook_rels, rel.target().path());
 
+    // worksheets are written first when there are threads to spare,
+    // then added below in the same order as in a serial save
+    std::vector<relationship> worksheet_rels;
+    std::vector<std::vector<zentry>> rendered_worksheets;
+
+    if (options_.worksheet_threads != 1 && !streaming_)
+    {
+        std::copy_if(workbook_rels.begin(), workbook_rels.end(), std::back_inserter(worksheet_rels),
+            [](const relationship &r) { return r.type() == relationship_type::worksheet; });
+        rendered_worksheets = render_worksheets(worksheet_rels);
+    }
+
+    auto rendered_worksheet = rendered_worksheets.begin();
+
     for (const auto &child_rel : workbook_rels)
     {
         if (child_rel.type() == relationship_type::calculation_chain)
@@ -742,6 +929,22 @@ void xlsx_producer::write_workbook(const relationship &rel)
             continue;
         }
 
+        if (child_rel.type() == relationship_type::worksheet && rendered_worksheet != rendered_worksheets.end())
+        {
+            end_part();
+
+            for (const auto &part : *rendered_worksheet)
+            {
+                archive_->write(part);
+            }
+
+            // the entries are no longer needed once they're in the archive
+            rendered_worksheet->clear();
+            rendered_worksheet->shrink_to_fit();
+            ++rendered_worksheet;
+            continue;
+        }
+
         // write xml
         begin_part(archive_path);
 
@@ -991,29 +1194,17 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
+    // count every reference to a shared string, which is one per cell of that type
     std::size_t string_count = 0;
 
     for (const auto ws : source_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
-
-        while (current_cell.row() <= dimension.bottom_right().row())
+        for (const auto &cell : ws.d_->cells_)
         {
-            while (current_cell.column() <= dimension.bottom_right().column())
+            if (cell.type_ == cell_type::shared_string)
             {
-                auto c_iter = ws.d_->cell_map_.find(current_cell);
-                if (c_iter != ws.d_->cell_map_.end() && c_iter->second.type_ == cell_type::shared_string)
-                {
-                    ++string_count;
-                }
-
-                current_cell.column_index(current_cell.column_index() + 1);
+                ++string_count;
             }
-
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
         }
     }
 
@@ -2293,7 +2484,9 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         return false;
     };
 
-    if (using_namespace("x14ac"))
+    const auto x14ac_declared = using_namespace("x14ac");
+
+    if (x14ac_declared)
     {
         write_namespace(xmlns_mc, "mc");
         write_namespace(xmlns_x14ac, "x14ac");
@@ -2498,7 +2691,7 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         if (props.width.is_set())
         {
             double width = (props.width.get() * 7 + 5) / 7;
-            write_attribute("width", converter_.serialise(width));
+            write_attribute("width", format_number(width));
         }
 
         if (props.best_fit)
@@ -2533,108 +2726,165 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     std::vector<cell_reference> cells_with_comments;
 
     write_start_element(xmlns, "sheetData");
-    auto first_row = ws.lowest_row_or_props();
-    auto last_row = ws.highest_row_or_props();
+
+    // rows and cells are written past the serializer, see sheet_data_writer
+    detail::sheet_data_writer writer(current_part_stream_, *current_part_serializer_);
+    auto sheet_data_started = false;
+
+    // Only rows with cells or properties are written, so walk the populated
+    // rows of the cell store merged with the rows that have properties rather
+    // than every row and column of the dimension.
+    const auto &cell_rows = ws.d_->cells_.rows();
+    std::vector<row_t> rows_to_write;
+    rows_to_write.reserve(cell_rows.size() + ws.d_->row_properties_.size());
+
+    for (const auto &cell_row : cell_rows)
+    {
+        rows_to_write.push_back(cell_row.index_);
+    }
+
+    for (const auto &props : ws.d_->row_properties_)
+    {
+        rows_to_write.push_back(props.first);
+    }
+
+    std::sort(rows_to_write.begin(), rows_to_write.end());
+    rows_to_write.erase(std::unique(rows_to_write.begin(), rows_to_write.end()), rows_to_write.end());
+
+    const auto first_row = ws.lowest_row_or_props();
+    auto block_start = row_t(0);
     auto first_block_column = constants::max_column();
     auto last_block_column = constants::min_column();
 
-    for (auto row = first_row; row <= last_row; ++row)
+    for (auto row : rows_to_write)
     {
-        bool any_non_null = false;
-        auto first_check_row = row;
-        auto last_check_row = row;
-        auto first_row_in_block = row == first_row || row % 16 == 1;
+        // See note for CT_Row, span attribute about block optimization.
+        // Rows share the span of their 16 row block, the first of which
+        // begins at the first row of the sheet.
+        const auto row_block_start = std::max(first_row, row - (row - 1) % 16);
 
-        // See note for CT_Row, span attribute about block optimization
-        if (first_row_in_block)
+        if (row_block_start != block_start)
         {
+            block_start = row_block_start;
+            // round up to the next multiple of 16
+            const auto block_end = ((block_start / 16) + 1) * 16;
+
             // reset block column range
             first_block_column = constants::max_column();
             last_block_column = constants::min_column();
 
-            first_check_row = row;
-            // round up to the next multiple of 16
-            last_check_row = ((row / 16) + 1) * 16;
-        }
+            auto block_row = std::lower_bound(cell_rows.begin(), cell_rows.end(), block_start,
+                [](const detail::cell_row &cell_row, row_t index) { return cell_row.index_ < index; });
 
-        for (auto check_row = first_check_row; check_row <= last_check_row; ++check_row)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
+            for (; block_row != cell_rows.end() && block_row->index_ <= block_end; ++block_row)
             {
-                auto ref = cell_reference(column, check_row);
-                auto cell = ws.d_->cell_map_.find(ref);
-                if (cell == ws.d_->cell_map_.end())
-                {
-                    continue;
-                }
-                if (cell->second.is_garbage_collectible())
+                for (auto cell : block_row->cells_)
                 {
-                    continue;
-                }
-
-                first_block_column = std::min(first_block_column, cell->second.column_);
-                last_block_column = std::max(last_block_column, cell->second.column_);
+                    if (cell->is_garbage_collectible())
+                    {
+                        continue;
+                    }
 
-                if (row == check_row)
-                {
-                    any_non_null = true;
+                    first_block_column = std::min(first_block_column, cell->column_);
+                    last_block_column = std::max(last_block_column, cell->column_);
                 }
             }
         }
 
+        const auto cell_row = ws.d_->cells_.find_row(row);
+        const auto any_non_null = cell_row != nullptr
+            && std::any_of(cell_row->cells_.begin(), cell_row->cells_.end(),
+                [](const detail::cell_impl *cell) { return !cell->is_garbage_collectible(); });
+
         if (!any_non_null && !ws.has_row_properties(row)) continue;
 
-        write_start_element(xmlns, "row");
-        write_attribute("r", row);
+        if (!sheet_data_started)
+        {
+            // completes the start tag of sheetData, which stays <sheetData/> without rows
+            write_characters(std::string());
+            sheet_data_started = true;
+        }
 
-        auto span_string = std::to_string(first_block_column.index) + ":"
-            + std::to_string(last_block_column.index);
-        write_attribute("spans", span_string);
+        const auto props = ws.has_row_properties(row) ? &ws.row_properties(row) : nullptr;
 
-        if (ws.has_row_properties(row))
+        if (props != nullptr && props->dy_descent.is_set() && !x14ac_declared)
         {
-            const auto &props = ws.row_properties(row);
+            // the serializer declares a namespace for dyDescent on the row itself
+            writer.flush();
+            write_start_element(xmlns, "row");
+            write_attribute("r", row);
+            write_attribute("spans", std::to_string(first_block_column.index) + ":" + std::to_string(last_block_column.index));
 
-            if (props.style.is_set())
+            if (props->style.is_set())
             {
-                write_attribute("s", props.style.get());
+                write_attribute("s", props->style.get());
             }
-            if (props.custom_format.is_set())
+            if (props->custom_format.is_set())
             {
-                write_attribute("customFormat", write_bool(props.custom_format.get()));
+                write_attribute("customFormat", write_bool(props->custom_format.get()));
             }
-
-            if (props.height.is_set())
+            if (props->height.is_set())
             {
-                auto height = props.height.get();
-                write_attribute("ht", converter_.serialise(height));
+                write_attribute("ht", format_number(props->height.get()));
             }
-
-            if (props.hidden)
+            if (props->hidden)
             {
                 write_attribute("hidden", write_bool(true));
             }
-
-            if (props.custom_height)
+            if (props->custom_height)
             {
                 write_attribute("customHeight", write_bool(true));
             }
 
-            if (props.dy_descent.is_set())
+            write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props->dy_descent.get());
+
+            if (any_non_null)
             {
-                write_attribute<double>(xml::qname(xmlns_x14ac, "dyDescent"), props.dy_descent.get());
+                write_characters(std::string());
+            }
+        }
+        else
+        {
+            writer.start_element("row");
+            writer.attribute("r", std::size_t(row));
+            writer.attribute("spans", std::size_t(first_block_column.index), std::size_t(last_block_column.index));
+
+            if (props != nullptr)
+            {
+                if (props->style.is_set())
+                {
+                    writer.attribute("s", props->style.get());
+                }
+                if (props->custom_format.is_set())
+                {
+                    writer.attribute("customFormat", props->custom_format.get() ? "1" : "0");
+                }
+                if (props->height.is_set())
+                {
+                    writer.attribute("ht", props->height.get());
+                }
+                if (props->hidden)
+                {
+                    writer.attribute("hidden", "1");
+                }
+                if (props->custom_height)
+                {
+                    writer.attribute("customHeight", "1");
+                }
+                if (props->dy_descent.is_set())
+                {
+                    writer.attribute("x14ac:dyDescent", props->dy_descent.get());
+                }
             }
         }
 
         if (any_non_null)
         {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
+            for (auto cell_impl : cell_row->cells_)
             {
-                if (!ws.has_cell(cell_reference(column, row))) continue;
+                if (cell_impl->is_garbage_collectible()) continue;
 
-                auto cell = ws.cell(cell_reference(column, row));
-
-                if (cell.garbage_collectible()) continue;
+                auto cell = xlnt::cell(cell_impl);
 
                 // record data about the cell needed later
 
@@ -2648,20 +2898,20 @@ void xlsx_producer::write_worksheet(const relationship &rel)
                     hyperlinks.push_back(std::make_pair(cell.reference().to_string(), cell.hyperlink()));
                 }
 
-                write_start_element(xmlns, "c");
+                writer.start_element("c");
 
                 // begin cell attributes
 
-                write_attribute("r", cell.reference().to_string());
+                writer.attribute("r", cell_impl->column_, cell_impl->row_);
 
                 if (cell.phonetics_visible())
                 {
-                    write_attribute("ph", write_bool(true));
+                    writer.attribute("ph", "1");
                 }
 
                 if (cell.has_format())
                 {
-                    write_attribute("s", cell.format().d_->id);
+                    writer.attribute("s", cell.format().d_->id);
                 }
 
                 switch (cell.data_type())
@@ -2670,43 +2920,45 @@ void xlsx_producer::write_worksheet(const relationship &rel)
                     break;
 
                 case cell::type::boolean:
-                    write_attribute("t", "b");
+                    writer.attribute("t", "b");
                     break;
 
                 case cell::type::date:
-                    write_attribute("t", "d");
+                    writer.attribute("t", "d");
                     break;
 
                 case cell::type::error:
-                    write_attribute("t", "e");
+                    writer.attribute("t", "e");
                     break;
 
                 case cell::type::inline_string:
-                    write_attribute("t", "inlineStr");
+                    writer.attribute("t", "inlineStr");
                     break;
 
                 case cell::type::number: // default, don't write it
-                    //write_attribute("t", "n");
+                    //writer.attribute("t", "n");
                     break;
 
                 case cell::type::shared_string:
-                    write_attribute("t", "s");
+                    writer.attribute("t", "s");
                     break;
 
                 case cell::type::formula_string:
-                    write_attribute("t", "str");
+                    writer.attribute("t", "str");
                     break;
                 }
 
-                //write_attribute("cm", "");
-                //write_attribute("vm", "");
-                //write_attribute("ph", "");
+                //writer.attribute("cm", "");
+                //writer.attribute("vm", "");
+                //writer.attribute("ph", "");
 
                 // begin child elements
 
                 if (cell.has_formula())
                 {
-                    write_element(xmlns, "f", cell.formula());
+                    writer.start_element("f");
+                    writer.characters(cell.formula());
+                    writer.end_element("f");
                 }
 
                 switch (cell.data_type())
@@ -2715,45 +2967,55 @@ void xlsx_producer::write_worksheet(const relationship &rel)
                     break;
 
                 case cell::type::boolean:
-                    write_element(xmlns, "v", write_bool(cell.value<bool>()));
+                    writer.start_element("v");
+                    writer.characters(cell.value<bool>() ? std::size_t(1) : std::size_t(0));
+                    writer.end_element("v");
                     break;
 
                 case cell::type::date:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
                 case cell::type::error:
-                    write_element(xmlns, "v", cell.value<std::string>());
+                case cell::type::formula_string:
+                    writer.start_element("v");
+                    writer.characters(cell.value<std::string>());
+                    writer.end_element("v");
                     break;
 
                 case cell::type::inline_string:
+                    writer.flush();
                     write_start_element(xmlns, "is");
                     write_rich_text(xmlns, cell.value<xlnt::rich_text>());
                     write_end_element(xmlns, "is");
                     break;
 
                 case cell::type::number:
-                    write_start_element(xmlns, "v");
-                    write_characters(converter_.serialise(cell.value<double>()));
-                    write_end_element(xmlns, "v");
+                    writer.start_element("v");
+                    writer.characters(cell.value<double>());
+                    writer.end_element("v");
                     break;
 
                 case cell::type::shared_string:
-                    write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                    break;
-
-                case cell::type::formula_string:
-                    write_element(xmlns, "v", cell.value<std::string>());
+                    writer.start_element("v");
+                    writer.characters(static_cast<std::size_t>(cell.d_->value_numeric_));
+                    writer.end_element("v");
                     break;
                 }
 
-                write_end_element(xmlns, "c");
+                writer.end_element("c");
             }
         }
 
-        write_end_element(xmlns, "row");
+        if (props != nullptr && props->dy_descent.is_set() && !x14ac_declared)
+        {
+            writer.flush();
+            write_end_element(xmlns, "row");
+        }
+        else
+        {
+            writer.end_element("row");
+        }
     }
 
+    writer.flush();
     write_end_element(xmlns, "sheetData");
 
     if (ws.has_auto_filter())
@@ -3398,7 +3660,7 @@ void xlsx_producer::write_image(const path &image_path)
     end_part();
 
     vector_istreambuf buffer(source_.d_->images_.at(image_path.string()));
-    auto image_streambuf = archive_->open(image_path);
+    auto image_streambuf = open_part(image_path);
     std::ostream(image_streambuf.get()) << &buffer;
 }
 
@@ -3407,7 +3669,7 @@ void xlsx_producer::write_binary(const path &binary_path)
     end_part();
 
     vector_istreambuf buffer(source_.d_->binaries_.at(binary_path.string()));
-    auto image_streambuf = archive_->open(binary_path);
+    auto image_streambuf = open_part(binary_path);
     std::ostream(image_streambuf.get()) << &buffer;
 }
 
@@ -3479,7 +3741,7 @@ void xlsx_producer::write_color(const xlnt::color &color)
     }
     if (color.has_tint())
     {
-        write_attribute("tint", converter_.serialise(color.tint()));
+        write_attribute("tint", format_number(color.tint()));
     }
 }
 
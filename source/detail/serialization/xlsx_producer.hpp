@@ -30,6 +30,7 @@
 #include <vector>
 
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
 
@@ -56,6 +57,7 @@ class worksheet;
 namespace detail {
 
 class ozstream;
+struct zentry;
 struct cell_impl;
 struct worksheet_impl;
 
@@ -73,6 +75,21 @@ public:
 
     void write(std::ostream &destination, const std::string &password);
 
+    void write(std::ostream &destination, const save_options &options);
+
+    /// <summary>
+    /// Throws invalid_parameter if options has a compression level out of range,
+    /// for every part or for any of them. This is done before anything is opened
+    /// so that a bad entry can't fail a save half way through.
+    /// </summary>
+    static void validate(const save_options &options);
+
+    /// <summary>
+    /// Returns the largest size the file written by write with the given options
+    /// can have. This serializes the whole workbook without compressing it.
+    /// </summary>
+    std::size_t size_bound(const save_options &options);
+
 private:
     friend class xlnt::streaming_workbook_writer;
 
@@ -91,6 +108,20 @@ private:
     void begin_part(const path &part);
     void end_part();
 
+    /// <summary>
+    /// Returns a streambuf which compresses a part into the archive, or into a
+    /// new entry of detached_parts_ when this producer writes a worksheet for
+    /// another one.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_part(const path &part);
+
+    /// <summary>
+    /// Writes the given worksheets and the parts they own into memory on
+    /// options_.worksheet_threads threads, one vector of entries per worksheet.
+    /// write_workbook then adds them to the archive in the usual order.
+    /// </summary>
+    std::vector<std::vector<zentry>> render_worksheets(const std::vector<relationship> &worksheet_rels);
+
 	// Package Parts
 
 	void write_content_types();
@@ -182,7 +213,7 @@ private:
     template <typename T, typename std::enable_if<std::is_floating_point<T>::value, T>::type* = nullptr>
     void write_attribute(const std::string &name, T value)
     {
-        current_part_serializer_->attribute(name, converter_.serialise(value));
+        current_part_serializer_->attribute(name, format_number(value));
     }
 
     template <typename T, typename std::enable_if<std::is_integral<T>::value, T>::type* = nullptr>
@@ -202,7 +233,7 @@ private:
     template <typename T, typename std::enable_if<std::is_floating_point<T>::value, T>::type* = nullptr>
     void write_attribute(const xml::qname &name, T value)
     {
-        current_part_serializer_->attribute(name, converter_.serialise(value));
+        current_part_serializer_->attribute(name, format_number(value));
     }
 
     template <typename T, typename std::enable_if<std::is_integral<T>::value, T>::type* = nullptr>
@@ -212,8 +243,19 @@ private:
     }
 
 
+    /// <summary>
+    /// Formats value as Excel would into a buffer that is reused between calls,
+    /// so writing numbers doesn't allocate a string each time.
+    /// </summary>
+    const std::string &format_number(double value)
+    {
+        char buffer[32];
+        number_buffer_.assign(buffer, converter_.serialise(value, buffer));
+        return number_buffer_;
+    }
+
     template <typename T>
-    void write_characters(T characters, bool preserve_whitespace = false)
+    void write_characters(const T &characters, bool preserve_whitespace = false)
     {
         if (preserve_whitespace)
         {
@@ -235,12 +277,20 @@ private:
 
     bool streaming_ = false;
 
+    save_options options_;
+
+    /// <summary>
+    /// Receives the parts written by this producer instead of archive_, see open_part.
+    /// </summary>
+    std::vector<zentry> *detached_parts_ = nullptr;
+
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
     detail::cell_impl *current_cell_;
 
     detail::worksheet_impl *current_worksheet_;
     detail::number_serialiser converter_;
+    std::string number_buffer_;
 };
 
 } // namespace detail
@@ -171,6 +171,43 @@ namespace detail {
 
 static const std::size_t buffer_size = 512;
 
+int deflate_strategy(compression_strategy strategy)
+{
+    switch (strategy)
+    {
+    case compression_strategy::filtered:
+        return Z_FILTERED;
+    case compression_strategy::huffman_only:
+        return Z_HUFFMAN_ONLY;
+    case compression_strategy::run_length:
+        return Z_RLE;
+    case compression_strategy::fixed:
+        return Z_FIXED;
+    case compression_strategy::standard:
+        break;
+    }
+
+    return Z_DEFAULT_STRATEGY;
+}
+
+/// <summary>
+/// Returns the local header of a new archive entry named filename which is
+/// compressed according to compression.
+/// </summary>
+zheader new_header(const path &filename, const compression_settings &compression)
+{
+    if (compression.level < -1 || compression.level > 9)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    zheader header;
+    header.filename = filename.string();
+    header.compression_type = compression.level == 0 ? 0 : 8;
+
+    return header;
+}
+
 class zip_streambuf_decompress : public std::streambuf
 {
     std::istream &istream;
@@ -311,6 +348,35 @@ int zip_streambuf_decompress::overflow(int)
     throw xlnt::exception("writing to read-only buffer");
 }
 
+/// <summary>
+/// Owns the in-memory copy of a ZIP entry returned by izstream::open_detached.
+/// This is a base of detached_zip_streambuf_decompress so that it's constructed
+/// before the zip_streambuf_decompress which reads from it.
+/// </summary>
+struct detached_zip_entry
+{
+    explicit detached_zip_entry(std::vector<std::uint8_t> &&entry_data)
+        : data(std::move(entry_data)),
+          buffer(data),
+          stream(&buffer)
+    {
+    }
+
+    std::vector<std::uint8_t> data;
+    vector_istreambuf buffer;
+    std::istream stream;
+};
+
+class detached_zip_streambuf_decompress : private detached_zip_entry, public zip_streambuf_decompress
+{
+public:
+    detached_zip_streambuf_decompress(std::vector<std::uint8_t> &&entry_data, const zheader &central_header)
+        : detached_zip_entry(std::move(entry_data)),
+          zip_streambuf_decompress(detached_zip_entry::stream, central_header)
+    {
+    }
+};
+
 class zip_streambuf_compress : public std::streambuf
 {
     std::ostream &ostream; // owned when header==0 (when not part of zip file)
@@ -324,32 +390,40 @@ class zip_streambuf_compress : public std::streambuf
     std::uint32_t crc;
 
     bool valid;
+    bool local_header;
+    bool stored; // copied as it is, see compression_settings::level
 
 public:
-    zip_streambuf_compress(zheader *central_header, std::ostream &stream)
-        : ostream(stream), header(central_header), valid(true)
+    zip_streambuf_compress(zheader *central_header, std::ostream &stream,
+        const compression_settings &compression, bool write_local_header = true)
+        : ostream(stream), header(central_header), valid(true), local_header(write_local_header),
+          stored(compression.level == 0)
     {
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
 
+        if (!stored)
+        {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wold-style-cast"
-        int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            int ret = deflateInit2(&strm, compression.level, Z_DEFLATED, -MAX_WBITS, 8,
+                deflate_strategy(compression.strategy));
 #pragma clang diagnostic pop
 
-        if (ret != Z_OK)
-        {
-            std::cerr << "libz: failed to deflateInit" << std::endl;
-            valid = false;
-            return;
+            if (ret != Z_OK)
+            {
+                std::cerr << "libz: failed to deflateInit" << std::endl;
+                valid = false;
+                return;
+            }
         }
 
         setg(nullptr, nullptr, nullptr);
         setp(in.data(), in.data() + buffer_size - 4); // we want to be 4 aligned
 
         // Write appropriate header
-        if (header)
+        if (header && local_header)
         {
             header->header_offset = static_cast<std::uint32_t>(stream.tellp());
             write_header(*header, ostream, false);
@@ -363,15 +437,19 @@ public:
         if (valid)
         {
             process(true);
-            deflateEnd(&strm);
+            if (!stored) deflateEnd(&strm);
             if (header)
             {
-                auto final_position = ostream.tellp();
                 header->uncompressed_size = uncompressed_size;
                 header->crc = crc;
-                ostream.seekp(header->header_offset);
-                write_header(*header, ostream, false);
-                ostream.seekp(final_position);
+
+                if (local_header)
+                {
+                    auto final_position = ostream.tellp();
+                    ostream.seekp(header->header_offset);
+                    write_header(*header, ostream, false);
+                    ostream.seekp(final_position);
+                }
             }
             else
             {
@@ -390,7 +468,14 @@ protected:
         strm.next_in = reinterpret_cast<Bytef *>(pbase());
         strm.avail_in = static_cast<unsigned int>(pptr() - pbase());
 
-        while (strm.avail_in != 0 || flush)
+        if (stored)
+        {
+            ostream.write(pbase(), pptr() - pbase());
+            if (header) header->compressed_size += strm.avail_in;
+            strm.avail_in = 0;
+        }
+
+        while (strm.avail_in != 0 || (flush && !stored))
         {
             strm.avail_out = buffer_size;
             strm.next_out = reinterpret_cast<Bytef *>(out.data());
@@ -433,6 +518,33 @@ protected:
     virtual int overflow(int c = EOF) override;
 };
 
+/// <summary>
+/// Holds the destination of a stream buffer returned by ozstream::open_detached.
+/// This is a base of detached_zip_streambuf_compress so that it's destroyed
+/// after the zip_streambuf_compress which writes the last of the data to it.
+/// </summary>
+struct detached_zip_destination
+{
+    explicit detached_zip_destination(std::vector<std::uint8_t> &data)
+        : buffer(data),
+          stream(&buffer)
+    {
+    }
+
+    vector_ostreambuf buffer;
+    std::ostream stream;
+};
+
+class detached_zip_streambuf_compress : private detached_zip_destination, public zip_streambuf_compress
+{
+public:
+    detached_zip_streambuf_compress(zentry &entry, const compression_settings &compression)
+        : detached_zip_destination(entry.data),
+          zip_streambuf_compress(&entry.header, detached_zip_destination::stream, compression, false)
+    {
+    }
+};
+
 int zip_streambuf_compress::overflow(int c)
 {
     if (c != EOF)
@@ -478,14 +590,42 @@ ozstream::~ozstream()
 
 std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
 {
-    zheader header;
-    header.filename = filename.string();
-    file_headers_.push_back(header);
-    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_);
+    return open(filename, compression_settings());
+}
+
+std::unique_ptr<std::streambuf> ozstream::open(const path &filename, const compression_settings &compression)
+{
+    file_headers_.push_back(new_header(filename, compression));
+    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_, compression);
 
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
+std::unique_ptr<std::streambuf> ozstream::open_detached(
+    const path &filename, zentry &entry, const compression_settings &compression)
+{
+    entry.header = new_header(filename, compression);
+    entry.data.clear();
+
+    return std::unique_ptr<std::streambuf>(new detached_zip_streambuf_compress(entry, compression));
+}
+
+void ozstream::write(const zentry &entry)
+{
+    file_headers_.push_back(entry.header);
+    auto &header = file_headers_.back();
+    header.header_offset = static_cast<std::uint32_t>(destination_stream_.tellp());
+
+    write_header(header, destination_stream_, false);
+    destination_stream_.write(reinterpret_cast<const char *>(entry.data.data()),
+        static_cast<std::streamsize>(entry.data.size()));
+}
+
+const std::vector<zheader> &ozstream::headers() const
+{
+    return file_headers_;
+}
+
 izstream::izstream(std::istream &stream)
     : source_stream_(stream)
 {
@@ -604,6 +744,33 @@ std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
     return std::unique_ptr<zip_streambuf_decompress>(buffer);
 }
 
+std::unique_ptr<std::streambuf> izstream::open_detached(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+
+    // the local header's name and extra field lengths can differ from the central header's
+    source_stream_.seekg(header.header_offset + 26);
+    auto filename_length = read_int<std::uint16_t>(source_stream_);
+    auto extra_length = read_int<std::uint16_t>(source_stream_);
+    auto entry_size = std::size_t(30) + filename_length + extra_length + header.compressed_size;
+
+    std::vector<std::uint8_t> entry_data(entry_size);
+    source_stream_.seekg(header.header_offset);
+    source_stream_.read(reinterpret_cast<char *>(entry_data.data()), static_cast<std::streamsize>(entry_size));
+
+    if (static_cast<std::size_t>(source_stream_.gcount()) != entry_size)
+    {
+        throw xlnt::exception("couldn't read ZIP entry, possibly truncated");
+    }
+
+    return std::unique_ptr<std::streambuf>(new detached_zip_streambuf_decompress(std::move(entry_data), header));
+}
+
 std::string izstream::read(const path &filename) const
 {
     auto buffer = open(filename);
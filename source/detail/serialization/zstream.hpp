@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/save_options.hpp>
 
 //TODO: don't export these classes (some tests are using them for now)
 
@@ -68,6 +69,16 @@ struct XLNT_API zheader
     std::uint32_t header_offset = 0;
 };
 
+/// <summary>
+/// A file which was compressed into memory by ozstream::open_detached and can
+/// be added to an archive with ozstream::write.
+/// </summary>
+struct XLNT_API zentry
+{
+    zheader header;
+    std::vector<std::uint8_t> data;
+};
+
 /// <summary>
 /// Writes a series of uncompressed binary file data as ostreams into another ostream
 /// according to the ZIP format.
@@ -90,6 +101,32 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Returns a pointer to a streambuf which compresses the data it receives
+    /// according to compression. Throws invalid_parameter if the level is out of range.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open(const path &file, const compression_settings &compression);
+
+    /// <summary>
+    /// Returns a pointer to a streambuf which compresses the data it receives into
+    /// entry instead of an archive, so it can be used on another thread. entry is
+    /// complete once the streambuf is destroyed.
+    /// </summary>
+    static std::unique_ptr<std::streambuf> open_detached(
+        const path &file, zentry &entry, const compression_settings &compression);
+
+    /// <summary>
+    /// Adds a file which was compressed by open_detached. The result is the same
+    /// as if the data had been written to the streambuf returned by open().
+    /// </summary>
+    void write(const zentry &entry);
+
+    /// <summary>
+    /// Returns the headers of the files added so far. Sizes are only known
+    /// once a file's streambuf has been destroyed.
+    /// </summary>
+    const std::vector<zheader> &headers() const;
+
 private:
     std::vector<zheader> file_headers_;
     std::ostream &destination_stream_;
@@ -117,6 +154,13 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file) const;
 
+    /// <summary>
+    /// Reads the compressed data of file into memory and returns a stream buffer
+    /// which decompresses it. Unlike open(), the result doesn't share this archive's
+    /// source stream, so it can be read on another thread.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_detached(const path &file) const;
+
     /// <summary>
     ///
     /// </summary>
@@ -85,7 +85,7 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
 
     auto rel_chain = std::vector<relationship>{workbook_rel, worksheet_rel};
 
-    const auto &manifest = consumer_->target_.manifest();
+    const auto &manifest = consumer_->target_->manifest();
     const auto part_path = manifest.canonicalize(rel_chain);
     auto part_stream_buffer = consumer_->archive_->open(part_path);
     part_stream_buffer_.swap(part_stream_buffer);
@@ -27,6 +27,7 @@
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/implementations/cell_impl.hpp>
@@ -67,16 +68,12 @@ worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 
 void streaming_workbook_writer::open(std::vector<std::uint8_t> &data)
 {
-    stream_buffer_.reset(new detail::vector_ostreambuf(data));
-    stream_.reset(new std::ostream(stream_buffer_.get()));
-    open(*stream_);
+    open(data, save_options());
 }
 
 void streaming_workbook_writer::open(const std::string &filename)
 {
-    stream_.reset(new std::ofstream());
-    xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename);
-    open(*stream_);
+    open(filename, save_options());
 }
 
 #ifdef _MSC_VER
@@ -90,15 +87,43 @@ void streaming_workbook_writer::open(const std::wstring &filename)
 
 void streaming_workbook_writer::open(const xlnt::path &filename)
 {
+    open(filename, save_options());
+}
+
+void streaming_workbook_writer::open(std::ostream &stream)
+{
+    open(stream, save_options());
+}
+
+void streaming_workbook_writer::open(std::vector<std::uint8_t> &data, const save_options &options)
+{
+    stream_buffer_.reset(new detail::vector_ostreambuf(data));
+    stream_.reset(new std::ostream(stream_buffer_.get()));
+    open(*stream_, options);
+}
+
+void streaming_workbook_writer::open(const std::string &filename, const save_options &options)
+{
+    detail::xlsx_producer::validate(options);
+    stream_.reset(new std::ofstream());
+    xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename);
+    open(*stream_, options);
+}
+
+void streaming_workbook_writer::open(const xlnt::path &filename, const save_options &options)
+{
+    detail::xlsx_producer::validate(options);
     stream_.reset(new std::ofstream());
     xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename.string());
-    open(*stream_);
+    open(*stream_, options);
 }
 
-void streaming_workbook_writer::open(std::ostream &stream)
+void streaming_workbook_writer::open(std::ostream &stream, const save_options &options)
 {
+    detail::xlsx_producer::validate(options);
     workbook_.reset(new workbook());
     producer_.reset(new detail::xlsx_producer(*workbook_));
+    producer_->options_ = options;
     producer_->open(stream);
     producer_->current_worksheet_ = new detail::worksheet_impl(workbook_.get(), 1, "Sheet1");
     producer_->current_cell_ = new detail::cell_impl();
@@ -27,6 +27,7 @@
 #include <fstream>
 #include <functional>
 #include <set>
+#include <sstream>
 
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
@@ -42,8 +43,11 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/cell_allocation.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
@@ -57,6 +61,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
@@ -257,6 +262,67 @@ std::string content_type(xlnt::relationship_type type)
     default_case("application/xml");
 }
 
+/// <summary>
+/// Reads ws if a lazy load left it unread, releasing the package once every
+/// worksheet has been read.
+/// </summary>
+void read_if_deferred(xlnt::detail::workbook_impl &wb, xlnt::detail::worksheet_impl &ws)
+{
+    if (!wb.deferred_consumer_) return;
+
+    wb.deferred_consumer_->read_deferred_worksheet(&ws);
+
+    if (!wb.deferred_consumer_->has_deferred_worksheets())
+    {
+        wb.deferred_consumer_.reset();
+        wb.deferred_source_.reset();
+    }
+}
+
+/// <summary>
+/// Returns the worksheet with a named range called name or nullptr if there's
+/// none. Named ranges are never read from a file, so the worksheets a lazy load
+/// left unread can't have one and aren't read to find out.
+/// </summary>
+xlnt::detail::worksheet_impl *named_range_owner(xlnt::detail::workbook_impl &wb, const std::string &name)
+{
+    for (auto &impl : wb.worksheets_)
+    {
+        if (impl.named_ranges_.find(name) != impl.named_ranges_.end())
+        {
+            return &impl;
+        }
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Reads every worksheet a lazy load left unread.
+/// </summary>
+void read_deferred(xlnt::detail::workbook_impl &wb)
+{
+    if (!wb.deferred_consumer_) return;
+
+    wb.deferred_consumer_->read_deferred_worksheets();
+    wb.deferred_consumer_.reset();
+    wb.deferred_source_.reset();
+}
+
+/// <summary>
+/// Reads every worksheet a lazy load left unread and throws if the workbook
+/// is missing parts it would need to be saved.
+/// </summary>
+void prepare_save(xlnt::detail::workbook_impl &wb)
+{
+    read_deferred(wb);
+
+    if (wb.skipped_parts_)
+    {
+        throw xlnt::exception("workbook was loaded without some of its parts and can't be saved");
+    }
+}
+
 } // namespace
 
 namespace xlnt {
@@ -508,6 +574,17 @@ workbook::workbook()
     swap(wb_template);
 }
 
+workbook::workbook(xlnt::cell_allocation allocation)
+    : workbook()
+{
+    d_->cell_allocation_ = allocation;
+
+    for (auto &ws : d_->worksheets_)
+    {
+        ws.cells_.allocation(allocation);
+    }
+}
+
 workbook::workbook(const xlnt::path &file)
 {
     *this = empty();
@@ -650,6 +727,7 @@ const worksheet workbook::sheet_by_title(const std::string &title) const
     {
         if (impl.title_ == title)
         {
+            read_if_deferred(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -663,6 +741,7 @@ worksheet workbook::sheet_by_title(const std::string &title)
     {
         if (impl.title_ == title)
         {
+            read_if_deferred(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -684,6 +763,7 @@ worksheet workbook::sheet_by_index(std::size_t index)
         ++iter;
     }
 
+    read_if_deferred(*d_, *iter);
     return worksheet(&*iter);
 }
 
@@ -700,6 +780,7 @@ const worksheet workbook::sheet_by_index(std::size_t index) const
     {
     }
 
+    read_if_deferred(*d_, *iter);
     return worksheet(&*iter);
 }
 
@@ -709,6 +790,7 @@ worksheet workbook::sheet_by_id(std::size_t id)
     {
         if (impl.id_ == id)
         {
+            read_if_deferred(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -722,6 +804,7 @@ const worksheet workbook::sheet_by_id(std::size_t id) const
     {
         if (impl.id_ == id)
         {
+            read_if_deferred(*d_, impl);
             return worksheet(&impl);
         }
     }
@@ -751,14 +834,7 @@ void workbook::active_sheet(std::size_t index)
 
 bool workbook::has_named_range(const std::string &name) const
 {
-    for (auto worksheet : *this)
-    {
-        if (worksheet.has_named_range(name))
-        {
-            return true;
-        }
-    }
-    return false;
+    return named_range_owner(*d_, name) != nullptr;
 }
 
 worksheet workbook::create_sheet()
@@ -773,11 +849,12 @@ worksheet workbook::create_sheet()
     }
     // unique sheet id
     size_t sheet_id = 1;
-    for (const auto ws : *this)
+    for (const auto &ws : d_->worksheets_)
     {
-        sheet_id = std::max(sheet_id, ws.id() + 1);
+        sheet_id = std::max(sheet_id, ws.id_ + 1);
     }
     d_->worksheets_.push_back(detail::worksheet_impl(this, sheet_id, title));
+    d_->worksheets_.back().cells_.allocation(d_->cell_allocation_);
     // unique sheet file name
     auto workbook_rel = d_->manifest_.relationship(path("/"), relationship_type::office_document);
     auto workbook_files = d_->manifest_.relationships(workbook_rel.target().path());
@@ -864,82 +941,123 @@ void workbook::create_named_range(const std::string &name, worksheet range_owner
 
 void workbook::remove_named_range(const std::string &name)
 {
-    for (auto ws : *this)
+    auto owner = named_range_owner(*d_, name);
+
+    if (owner == nullptr)
     {
-        if (ws.has_named_range(name))
-        {
-            ws.remove_named_range(name);
-            return;
-        }
+        throw key_not_found();
     }
 
-    throw key_not_found();
+    worksheet(owner).remove_named_range(name);
 }
 
 range workbook::named_range(const std::string &name)
 {
-    for (auto ws : *this)
+    auto owner = named_range_owner(*d_, name);
+
+    if (owner == nullptr)
     {
-        if (ws.has_named_range(name))
-        {
-            return ws.named_range(name);
-        }
+        throw key_not_found();
     }
 
-    throw key_not_found();
+    return worksheet(owner).named_range(name);
 }
 
 void workbook::load(std::istream &stream)
+{
+    load(stream, load_options());
+}
+
+void workbook::load(const std::vector<std::uint8_t> &data)
+{
+    load(data, load_options());
+}
+
+void workbook::load(const std::string &filename)
+{
+    return load(path(filename));
+}
+
+void workbook::load(const path &filename)
+{
+    load(filename, load_options());
+}
+
+void workbook::load(std::istream &stream, const load_options &options)
 {
     clear();
-    detail::xlsx_consumer consumer(*this);
+    auto consumer = std::make_shared<detail::xlsx_consumer>(*this);
 
     try
     {
-        consumer.read(stream);
+        consumer->read(stream, options);
     }
     catch (xlnt::exception &e)
     {
         if (e.what() == std::string("xlnt::exception : encrypted xlsx, password required"))
         {
             stream.seekg(0, std::ios::beg);
-            consumer.read(stream, "VelvetSweatshop");
+            consumer->read(stream, "VelvetSweatshop");
         }
         else
         {
             throw;
         }
     }
+
+    if (consumer->has_deferred_worksheets())
+    {
+        d_->deferred_consumer_ = consumer;
+    }
 }
 
-void workbook::load(const std::vector<std::uint8_t> &data)
+void workbook::load(const std::vector<std::uint8_t> &data, const load_options &options)
 {
     if (data.size() < 22) // the shortest ZIP file is 22 bytes
     {
         throw xlnt::exception("file is empty or malformed");
     }
 
+    if (options.lazy)
+    {
+        // worksheets are read after this returns, so the workbook keeps its own copy
+        std::unique_ptr<std::istream> data_stream(new std::istringstream(std::string(data.begin(), data.end())));
+        load(*data_stream, options);
+
+        if (d_->deferred_consumer_)
+        {
+            d_->deferred_source_ = std::move(data_stream);
+        }
+
+        return;
+    }
+
     xlnt::detail::vector_istreambuf data_buffer(data);
     std::istream data_stream(&data_buffer);
-    load(data_stream);
+    load(data_stream, options);
 }
 
-void workbook::load(const std::string &filename)
+void workbook::load(const std::string &filename, const load_options &options)
 {
-    return load(path(filename));
+    return load(path(filename), options);
 }
 
-void workbook::load(const path &filename)
+void workbook::load(const path &filename, const load_options &options)
 {
-    std::ifstream file_stream;
-    open_stream(file_stream, filename.string());
+    std::unique_ptr<std::ifstream> file_stream(new std::ifstream());
+    open_stream(*file_stream, filename.string());
 
-    if (!file_stream.good())
+    if (!file_stream->good())
     {
         throw xlnt::exception("file not found " + filename.string());
     }
 
-    load(file_stream);
+    load(*file_stream, options);
+
+    if (d_->deferred_consumer_)
+    {
+        d_->deferred_source_ = std::move(file_stream);
+    }
 }
 
 void workbook::load(const std::string &filename, const std::string &password)
@@ -981,9 +1099,7 @@ void workbook::load(std::istream &stream, const std::string &password)
 
 void workbook::save(std::vector<std::uint8_t> &data) const
 {
-    xlnt::detail::vector_ostreambuf data_buffer(data);
-    std::ostream data_stream(&data_buffer);
-    save(data_stream);
+    save(data, save_options());
 }
 
 void workbook::save(std::vector<std::uint8_t> &data, const std::string &password) const
@@ -1005,9 +1121,7 @@ void workbook::save(const std::string &filename, const std::string &password) co
 
 void workbook::save(const path &filename) const
 {
-    std::ofstream file_stream;
-    open_stream(file_stream, filename.string());
-    save(file_stream);
+    save(filename, save_options());
 }
 
 void workbook::save(const path &filename, const std::string &password) const
@@ -1019,16 +1133,76 @@ void workbook::save(const path &filename, const std::string &password) const
 
 void workbook::save(std::ostream &stream) const
 {
-    detail::xlsx_producer producer(*this);
-    producer.write(stream);
+    save(stream, save_options());
 }
 
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
+    prepare_save(*d_);
+
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
 
+void workbook::save(std::vector<std::uint8_t> &data, const save_options &options) const
+{
+    xlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, options);
+}
+
+void workbook::save(const std::string &filename, const save_options &options) const
+{
+    save(path(filename), options);
+}
+
+void workbook::save(const path &filename, const save_options &options) const
+{
+    // an existing file is only replaced by a save which can succeed
+    detail::xlsx_producer::validate(options);
+
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save(file_stream, options);
+}
+
+void workbook::save(std::ostream &stream, const save_options &options) const
+{
+    prepare_save(*d_);
+
+    detail::xlsx_producer producer(*this);
+    producer.write(stream, options);
+}
+
+std::size_t workbook::save_size_bound(const save_options &options) const
+{
+    prepare_save(*d_);
+
+    detail::xlsx_producer producer(*this);
+    return producer.size_bound(options);
+}
+
+std::size_t workbook::save(std::uint8_t *data, std::size_t size, const save_options &options) const
+{
+    xlnt::detail::buffer_ostreambuf data_buffer(data, size);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, options);
+
+    if (!data_stream)
+    {
+        throw xlnt::exception("workbook doesn't fit in a buffer of " + std::to_string(size) + " bytes");
+    }
+
+    return data_buffer.size();
+}
+
+void workbook::save_mapped(const path &filename, const save_options &options) const
+{
+    detail::mapped_file file(filename, save_size_bound(options));
+    const auto size = save(file.data(), file.size(), options);
+    file.close(size);
+}
+
 #ifdef _MSC_VER
 void workbook::save(const std::wstring &filename) const
 {
@@ -1112,6 +1286,7 @@ worksheet workbook::create_sheet_with_rel(const std::string &title, const relati
 {
     auto sheet_id = d_->worksheets_.size() + 1;
     d_->worksheets_.push_back(detail::worksheet_impl(this, sheet_id, title));
+    d_->worksheets_.back().cells_.allocation(d_->cell_allocation_);
 
     auto workbook_rel = d_->manifest_.relationship(path("/"), relationship_type::office_document);
     auto sheet_absoulute_path = workbook_rel.target().path().parent().append(rel.target().path());
@@ -1160,9 +1335,9 @@ std::vector<std::string> workbook::sheet_titles() const
 {
     std::vector<std::string> names;
 
-    for (auto ws : *this)
+    for (const auto &ws : d_->worksheets_)
     {
-        names.push_back(ws.title());
+        names.push_back(ws.title_);
     }
 
     return names;
@@ -1185,12 +1360,19 @@ worksheet workbook::operator[](std::size_t index)
 
 void workbook::clear()
 {
+    auto allocation = d_->cell_allocation_;
+    d_->deferred_consumer_.reset();
+    d_->deferred_source_.reset();
     *d_ = detail::workbook_impl();
     d_->stylesheet_.clear();
+    d_->cell_allocation_ = allocation;
 }
 
 bool workbook::operator==(const workbook &rhs) const
 {
+    read_deferred(*d_);
+    read_deferred(*rhs.d_);
+
     return *d_ == *rhs.d_;
 }
 
@@ -1208,9 +1390,14 @@ void workbook::swap(workbook &right)
 
     if (left.d_ != nullptr)
     {
-        for (auto ws : left)
+        for (auto &ws : left.d_->worksheets_)
         {
-            ws.parent(left);
+            ws.parent_ = &left;
+        }
+
+        if (left.d_->deferred_consumer_)
+        {
+            left.d_->deferred_consumer_->destination(left);
         }
 
         if (left.d_->stylesheet_.is_set())
@@ -1221,9 +1408,14 @@ void workbook::swap(workbook &right)
 
     if (right.d_ != nullptr)
     {
-        for (auto ws : right)
+        for (auto &ws : right.d_->worksheets_)
+        {
+            ws.parent_ = &right;
+        }
+
+        if (right.d_->deferred_consumer_)
         {
-            ws.parent(right);
+            right.d_->deferred_consumer_->destination(right);
         }
 
         if (right.d_->stylesheet_.is_set())
@@ -1236,7 +1428,11 @@ void workbook::swap(workbook &right)
 workbook &workbook::operator=(workbook other)
 {
     swap(other);
-    d_->stylesheet_.get().parent = this;
+
+    if (d_->stylesheet_.is_set())
+    {
+        d_->stylesheet_.get().parent = this;
+    }
 
     return *this;
 }
@@ -1250,6 +1446,7 @@ workbook::workbook(workbook &&other)
 workbook::workbook(const workbook &other)
     : workbook()
 {
+    read_deferred(*other.d_);
     *d_.get() = *other.d_.get();
 
     for (auto ws : *this)
@@ -1257,7 +1454,10 @@ workbook::workbook(const workbook &other)
         ws.parent(*this);
     }
 
-    d_->stylesheet_.get().parent = this;
+    if (d_->stylesheet_.is_set())
+    {
+        d_->stylesheet_.get().parent = this;
+    }
 }
 
 workbook::~workbook() = default;
@@ -1420,9 +1620,9 @@ std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_dupl
 
 bool workbook::contains(const std::string &sheet_title) const
 {
-    for (auto ws : *this)
+    for (const auto &ws : d_->worksheets_)
     {
-        if (ws.title() == sheet_title) return true;
+        if (ws.title_ == sheet_title) return true;
     }
 
     return false;
@@ -1483,6 +1683,11 @@ void workbook::base_date(calendar base_date)
     d_->base_date_ = base_date;
 }
 
+xlnt::cell_allocation workbook::cell_allocation() const
+{
+    return d_->cell_allocation_;
+}
+
 bool workbook::has_title() const
 {
     return d_->title_.is_set();
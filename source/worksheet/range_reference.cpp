@@ -23,6 +23,7 @@
 #include <locale>
 
 #include <xlnt/worksheet/range_reference.hpp>
+#include <detail/reference_format.hpp>
 
 namespace xlnt {
 
@@ -112,7 +113,12 @@ bool range_reference::is_single_cell() const
 
 std::string range_reference::to_string() const
 {
-    return top_left_.to_string() + ":" + bottom_right_.to_string();
+    char buffer[2 * detail::max_reference_size + 1];
+    auto last = detail::format_reference(top_left_, buffer);
+    *last++ = ':';
+    last = detail::format_reference(bottom_right_, last);
+
+    return std::string(buffer, last);
 }
 
 bool range_reference::operator==(const range_reference &comparand) const
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <stdexcept>
 
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/cell_reference.hpp>
@@ -34,6 +35,7 @@
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/worksheet_iterator.hpp>
@@ -59,6 +61,144 @@ int points_to_pixels(double points, double dpi)
     return static_cast<int>(std::ceil(points * dpi / 72));
 }
 
+void check_block_bounds(const xlnt::cell_reference &top_left, std::size_t rows, std::size_t columns)
+{
+    if (rows - 1 > xlnt::constants::max_row() - top_left.row()
+        || columns - 1 > xlnt::constants::max_column().index - top_left.column_index())
+    {
+        throw xlnt::invalid_parameter();
+    }
+}
+
+// Creates the cells of a rows by columns block one row at a time and passes
+// each of them to assign along with its value.
+template <typename T, typename Assign>
+void write_cell_block(xlnt::detail::worksheet_impl *ws, const xlnt::cell_reference &top_left,
+    std::size_t rows, std::size_t columns, const T *values, Assign assign)
+{
+    if (rows == 0 || columns == 0)
+    {
+        return;
+    }
+
+    check_block_bounds(top_left, rows, columns);
+    ws->cells_.reserve(ws->cells_.size() + rows * columns);
+
+    std::vector<xlnt::detail::cell_impl *> row_cells(columns);
+
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        ws->cells_.emplace_range(top_left.column_index(), static_cast<xlnt::row_t>(top_left.row() + row),
+            columns, row_cells.data());
+
+        for (std::size_t column = 0; column < columns; ++column)
+        {
+            row_cells[column]->parent_ = ws;
+            assign(row_cells[column], values[row * columns + column]);
+        }
+    }
+}
+
+// Stores the value of impl in out if it holds a T and returns whether it did.
+bool read_cell_value(const xlnt::detail::worksheet_impl *, const xlnt::detail::cell_impl *impl, double &out)
+{
+    if (impl->type_ != xlnt::cell::type::number)
+    {
+        return false;
+    }
+
+    out = impl->value_numeric_;
+    return true;
+}
+
+bool read_cell_value(const xlnt::detail::worksheet_impl *, const xlnt::detail::cell_impl *impl, int &out)
+{
+    if (impl->type_ != xlnt::cell::type::number)
+    {
+        return false;
+    }
+
+    out = static_cast<int>(impl->value_numeric_);
+    return true;
+}
+
+bool read_cell_value(const xlnt::detail::worksheet_impl *, const xlnt::detail::cell_impl *impl, bool &out)
+{
+    if (impl->type_ != xlnt::cell::type::boolean)
+    {
+        return false;
+    }
+
+    out = impl->value_numeric_ != 0.0;
+    return true;
+}
+
+bool read_cell_value(const xlnt::detail::worksheet_impl *ws, const xlnt::detail::cell_impl *impl, std::string &out)
+{
+    switch (impl->type_)
+    {
+    case xlnt::cell::type::shared_string:
+        out = ws->parent_->shared_strings(static_cast<std::size_t>(impl->value_numeric_)).plain_text();
+        return true;
+    case xlnt::cell::type::inline_string:
+    case xlnt::cell::type::formula_string:
+        out = impl->value_text().plain_text();
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Copies the values of the cells in the given bounds to out in row-major order,
+// walking only the populated cells of each row.
+template <typename T>
+std::size_t read_cell_block(const xlnt::detail::worksheet_impl *ws,
+    xlnt::column_t::index_t first_column, xlnt::column_t::index_t last_column,
+    xlnt::row_t first_row, xlnt::row_t last_row, T *out, const T &missing_value, std::uint8_t *valid)
+{
+    if (first_row > last_row || first_column > last_column)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    const auto width = static_cast<std::size_t>(last_column - first_column) + 1;
+    const auto count = width * (static_cast<std::size_t>(last_row - first_row) + 1);
+
+    std::fill(out, out + count, missing_value);
+
+    if (valid != nullptr)
+    {
+        std::fill(valid, valid + (count + 7) / 8, std::uint8_t(0));
+    }
+
+    std::size_t read = 0;
+    const auto &rows = ws->cells_.rows();
+
+    for (auto row = ws->cells_.row_lower_bound(first_row); row != rows.end() && row->index_ <= last_row; ++row)
+    {
+        const auto offset = static_cast<std::size_t>(row->index_ - first_row) * width;
+
+        for (auto i = row->lower_bound(first_column); i < row->size() && row->columns_[i] <= last_column; ++i)
+        {
+            const auto index = offset + (row->columns_[i] - first_column);
+
+            if (!read_cell_value(ws, row->cells_[i], out[index]))
+            {
+                continue;
+            }
+
+            if (valid != nullptr)
+            {
+                valid[index / 8] = static_cast<std::uint8_t>(valid[index / 8] | (1u << (index % 8)));
+            }
+
+            ++read;
+        }
+    }
+
+    return read;
+}
+
 } // namespace
 
 namespace xlnt {
@@ -201,21 +341,26 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_iter = d_->cell_map_.begin();
+    d_->cells_.erase_if([](const detail::cell_impl &impl) {
+        return impl.is_garbage_collectible();
+    });
+}
 
-    while (cell_iter != d_->cell_map_.end())
+void worksheet::auto_garbage_collect(bool enabled)
+{
+    d_->auto_garbage_collect_ = enabled;
+
+    if (enabled)
     {
-        if (xlnt::cell(&cell_iter->second).garbage_collectible())
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else
-        {
-            ++cell_iter;
-        }
+        garbage_collect();
     }
 }
 
+bool worksheet::auto_garbage_collect() const
+{
+    return d_->auto_garbage_collect_;
+}
+
 void worksheet::id(std::size_t id)
 {
     d_->id_ = id;
@@ -226,6 +371,11 @@ std::size_t worksheet::id() const
     return d_->id_;
 }
 
+xlnt::cell_allocation worksheet::cell_allocation() const
+{
+    return d_->cells_.allocation();
+}
+
 std::string worksheet::title() const
 {
     return d_->title_;
@@ -382,22 +532,22 @@ cell_reference worksheet::active_cell() const
 
 cell worksheet::cell(const cell_reference &reference)
 {
-    auto match = d_->cell_map_.find(reference);
-    if (match == d_->cell_map_.end())
+    auto match = d_->cells_.emplace(reference.column_index(), reference.row());
+    if (match.second)
     {
-        auto impl = detail::cell_impl();
-        impl.parent_ = d_;
-        impl.column_ = reference.column_index();
-        impl.row_ = reference.row();
-
-        match = d_->cell_map_.emplace(reference, impl).first;
+        match.first->parent_ = d_;
     }
-    return xlnt::cell(&match->second);
+    return xlnt::cell(match.first);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
-    return xlnt::cell(&d_->cell_map_.at(reference));
+    auto match = d_->cells_.find(reference.column_index(), reference.row());
+    if (match == nullptr)
+    {
+        throw std::out_of_range("cell " + reference.to_string() + " does not exist");
+    }
+    return xlnt::cell(const_cast<detail::cell_impl *>(match));
 }
 
 cell worksheet::cell(xlnt::column_t column, row_t row)
@@ -412,8 +562,20 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto cell = d_->cell_map_.find(reference);
-    return cell != d_->cell_map_.cend();
+    return d_->cells_.find(reference.column_index(), reference.row()) != nullptr;
+}
+
+optional<cell> worksheet::find_cell(const cell_reference &reference)
+{
+    auto match = d_->cells_.find(reference.column_index(), reference.row());
+    return match != nullptr ? optional<class cell>(xlnt::cell(match)) : optional<class cell>();
+}
+
+optional<const cell> worksheet::find_cell(const cell_reference &reference) const
+{
+    auto match = d_->cells_.find(reference.column_index(), reference.row());
+    return match != nullptr ? optional<const class cell>(xlnt::cell(const_cast<detail::cell_impl *>(match)))
+                            : optional<const class cell>();
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -453,26 +615,19 @@ const range worksheet::named_range(const std::string &name) const
 
 column_t worksheet::lowest_column() const
 {
-    if (d_->cell_map_.empty())
+    if (d_->cells_.empty())
     {
         return constants::min_column();
     }
 
-    auto lowest = constants::max_column();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.column());
-    }
-
-    return lowest;
+    return d_->cells_.min_column();
 }
 
 column_t worksheet::lowest_column_or_props() const
 {
     auto lowest = lowest_column();
 
-    if (d_->cell_map_.empty() && !d_->column_properties_.empty())
+    if (d_->cells_.empty() && !d_->column_properties_.empty())
     {
         lowest = d_->column_properties_.begin()->first;
     }
@@ -487,33 +642,22 @@ column_t worksheet::lowest_column_or_props() const
 
 row_t worksheet::lowest_row() const
 {
-    if (d_->cell_map_.empty())
+    if (d_->cells_.empty())
     {
         return constants::min_row();
     }
 
-    auto lowest = constants::max_row();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.row());
-    }
-
-    return lowest;
+    return d_->cells_.rows().front().index_;
 }
 
 row_t worksheet::lowest_row_or_props() const
 {
     auto lowest = lowest_row();
 
-    if (d_->cell_map_.empty() && !d_->row_properties_.empty())
+    if (!d_->row_properties_.empty())
     {
-        lowest = d_->row_properties_.begin()->first;
-    }
-
-    for (auto &props : d_->row_properties_)
-    {
-        lowest = std::min(lowest, props.first);
+        const auto props_lowest = d_->row_properties_bounds().first;
+        lowest = d_->cells_.empty() ? props_lowest : std::min(lowest, props_lowest);
     }
 
     return lowest;
@@ -521,28 +665,22 @@ row_t worksheet::lowest_row_or_props() const
 
 row_t worksheet::highest_row() const
 {
-    auto highest = constants::min_row();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cells_.empty())
     {
-        highest = std::max(highest, cell.first.row());
+        return constants::min_row();
     }
 
-    return highest;
+    return d_->cells_.rows().back().index_;
 }
 
 row_t worksheet::highest_row_or_props() const
 {
     auto highest = highest_row();
 
-    if (d_->cell_map_.empty() && !d_->row_properties_.empty())
+    if (!d_->row_properties_.empty())
     {
-        highest = d_->row_properties_.begin()->first;
-    }
-
-    for (auto &props : d_->row_properties_)
-    {
-        highest = std::max(highest, props.first);
+        const auto props_highest = d_->row_properties_bounds().second;
+        highest = d_->cells_.empty() ? props_highest : std::max(highest, props_highest);
     }
 
     return highest;
@@ -550,21 +688,19 @@ row_t worksheet::highest_row_or_props() const
 
 column_t worksheet::highest_column() const
 {
-    auto highest = constants::min_column();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cells_.empty())
     {
-        highest = std::max(highest, cell.first.column());
+        return constants::min_column();
     }
 
-    return highest;
+    return d_->cells_.max_column();
 }
 
 column_t worksheet::highest_column_or_props() const
 {
     auto highest = highest_column();
 
-    if (d_->cell_map_.empty() && !d_->column_properties_.empty())
+    if (d_->cells_.empty() && !d_->column_properties_.empty())
     {
         highest = d_->column_properties_.begin()->first;
     }
@@ -583,7 +719,7 @@ range_reference worksheet::calculate_dimension(bool skip_null) const
     // return range_reference(lowest_column(), lowest_row_or_props(),
     //                        highest_column(), highest_row_or_props());
     //
-    if (d_->cell_map_.empty() && d_->row_properties_.empty())
+    if (d_->cells_.empty() && d_->row_properties_.empty())
     {
         return range_reference(constants::min_column(), constants::min_row(),
             constants::min_column(), constants::min_row());
@@ -593,14 +729,15 @@ range_reference worksheet::calculate_dimension(bool skip_null) const
     // in order to include first empty rows and columns
     row_t min_row_prop = skip_null? constants::max_row() : constants::min_row();
     row_t max_row_prop = constants::min_row();
-    for (const auto &row_prop : d_->row_properties_)
+    if (!d_->row_properties_.empty())
     {
+        const auto &bounds = d_->row_properties_bounds();
         if(skip_null){
-            min_row_prop = std::min(min_row_prop, row_prop.first);
+            min_row_prop = bounds.first;
         }
-        max_row_prop = std::max(max_row_prop, row_prop.first);
+        max_row_prop = std::max(max_row_prop, bounds.second);
     }
-    if (d_->cell_map_.empty())
+    if (d_->cells_.empty())
     {
         return range_reference(constants::min_column(), min_row_prop,
             constants::min_column(), max_row_prop);
@@ -610,15 +747,15 @@ range_reference worksheet::calculate_dimension(bool skip_null) const
     column_t max_col = constants::min_column();
     row_t min_row = min_row_prop;
     row_t max_row = max_row_prop;
-    for (auto &c : d_->cell_map_)
-    {
-        if(skip_null){
-            min_col = std::min(min_col, c.second.column_);
-            min_row = std::min(min_row, c.second.row_);
-        }
-        max_col = std::max(max_col, c.second.column_);
-        max_row = std::max(max_row, c.second.row_);
+    if(skip_null){
+        min_col = d_->cells_.min_column();
+    }
+    max_col = std::max(max_col, column_t(d_->cells_.max_column()));
+    const auto &rows = d_->cells_.rows();
+    if(skip_null){
+        min_row = std::min(min_row, rows.front().index_);
     }
+    max_row = std::max(max_row, rows.back().index_);
     return range_reference(min_col, min_row, max_col, max_row);
 }
 
@@ -714,7 +851,7 @@ row_t worksheet::next_row() const
 {
     auto row = highest_row() + 1;
 
-    if (row == 2 && d_->cell_map_.size() == 0)
+    if (row == 2 && d_->cells_.empty())
     {
         row = 1;
     }
@@ -760,24 +897,17 @@ const cell_vector worksheet::cells(bool skip_null) const
 
 void worksheet::clear_cell(const cell_reference &ref)
 {
-    d_->cell_map_.erase(ref);
+    d_->cells_.erase(ref.column_index(), ref.row());
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
 void worksheet::clear_row(row_t row)
 {
-    for (auto it = d_->cell_map_.begin(); it != d_->cell_map_.end();)
+    d_->cells_.erase_row(row);
+    if (d_->row_properties_.erase(row) > 0)
     {
-        if (it->first.row() == row)
-        {
-            it = d_->cell_map_.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        d_->row_properties_removed();
     }
-    d_->row_properties_.erase(row);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
@@ -801,78 +931,197 @@ void worksheet::delete_columns(column_t column, std::uint32_t amount)
     move_cells(column.index + amount, amount, row_or_col_t::column, true);
 }
 
-void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or_col_t row_or_col, bool reverse)
+row_t worksheet::append_row(const std::vector<double> &values)
 {
-    if (reverse && amount > min_index)
-    {
-        throw xlnt::invalid_parameter();
-    }
+    const auto row = next_row();
+    write_block(cell_reference(1, row), 1, values.size(), values.data());
 
-    if ((!reverse && row_or_col == row_or_col_t::row && min_index > constants::max_row() - amount) || (!reverse && row_or_col == row_or_col_t::column && min_index > constants::max_column() - amount))
+    return row;
+}
+
+row_t worksheet::append_row(const std::vector<std::string> &values)
+{
+    const auto row = next_row();
+    write_block(cell_reference(1, row), 1, values.size(), values.data());
+
+    return row;
+}
+
+row_t worksheet::append_row(const std::vector<variant> &values)
+{
+    const auto row = next_row();
+    write_block(cell_reference(1, row), 1, values.size(), values.data());
+
+    return row;
+}
+
+void worksheet::write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns, const double *values)
+{
+    write_cell_block(d_, top_left, rows, columns, values, [](detail::cell_impl *impl, double value) {
+        impl->type_ = cell_type::number;
+        impl->value_numeric_ = value;
+    });
+}
+
+void worksheet::write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns, const std::string *values)
+{
+    write_cell_block(d_, top_left, rows, columns, values, [](detail::cell_impl *impl, const std::string &value) {
+        xlnt::cell(impl).value(value);
+    });
+}
+
+void worksheet::write_block(const cell_reference &top_left, std::size_t rows, std::size_t columns, const variant *values)
+{
+    if (rows == 0 || columns == 0)
     {
-        throw xlnt::exception("Cannot move cells as they would be outside the maximum bounds of the spreadsheet");
+        return;
     }
 
-    std::vector<detail::cell_impl> cells_to_move;
+    check_block_bounds(top_left, rows, columns);
+    d_->cells_.reserve(d_->cells_.size() + rows * columns);
 
-    auto cell_iter = d_->cell_map_.cbegin();
-    while (cell_iter != d_->cell_map_.cend())
+    for (std::size_t row = 0; row < rows; ++row)
     {
-        std::uint32_t current_index;
-        switch (row_or_col)
+        for (std::size_t column = 0; column < columns; ++column)
         {
-        case row_or_col_t::row:
-            current_index = cell_iter->first.row();
-            break;
-        case row_or_col_t::column:
-            current_index = cell_iter->first.column().index;
-            break;
-        default:
-            throw xlnt::unhandled_switch_case();
-        }
+            const auto &value = values[row * columns + column];
 
-        if (current_index >= min_index) // extract cells to be moved
-        {
-            auto cell = cell_iter->second;
-            if (row_or_col == row_or_col_t::row)
+            if (value.is(variant::type::null))
             {
-                cell.row_ = reverse ? cell.row_ - amount : cell.row_ + amount;
+                continue;
             }
-            else if (row_or_col == row_or_col_t::column)
+
+            if (value.is(variant::type::vector))
             {
-                cell.column_ = reverse ? cell.column_.index - amount : cell.column_.index + amount;
+                throw xlnt::invalid_parameter();
             }
 
-            cells_to_move.push_back(cell);
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else if (reverse && current_index >= min_index - amount) // delete destination cells
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else // skip other cells
-        {
-            ++cell_iter;
+            auto cell = this->cell(cell_reference(
+                static_cast<column_t::index_t>(top_left.column_index() + column),
+                static_cast<row_t>(top_left.row() + row)));
+
+            switch (value.value_type())
+            {
+            case variant::type::null:
+            case variant::type::vector:
+                break;
+            case variant::type::i4:
+                cell.value(value.get<std::int32_t>());
+                break;
+            case variant::type::lpstr:
+                cell.value(value.get<std::string>());
+                break;
+            case variant::type::date:
+                cell.value(value.get<datetime>());
+                break;
+            case variant::type::boolean:
+                cell.value(value.get<bool>());
+                break;
+            }
         }
     }
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_column(column_t column, row_t first_row, row_t last_row,
+    double *out, const double &missing_value, std::uint8_t *valid) const
+{
+    return read_cell_block(d_, column.index, column.index, first_row, last_row, out, missing_value, valid);
+}
 
-    for (auto &cell : cells_to_move)
+template <>
+XLNT_API std::size_t worksheet::read_column(column_t column, row_t first_row, row_t last_row,
+    int *out, const int &missing_value, std::uint8_t *valid) const
+{
+    return read_cell_block(d_, column.index, column.index, first_row, last_row, out, missing_value, valid);
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_column(column_t column, row_t first_row, row_t last_row,
+    bool *out, const bool &missing_value, std::uint8_t *valid) const
+{
+    return read_cell_block(d_, column.index, column.index, first_row, last_row, out, missing_value, valid);
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_column(column_t column, row_t first_row, row_t last_row,
+    std::string *out, const std::string &missing_value, std::uint8_t *valid) const
+{
+    return read_cell_block(d_, column.index, column.index, first_row, last_row, out, missing_value, valid);
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_block(const range_reference &range, double *out, const double &missing_value,
+    std::uint8_t *valid) const
+{
+    return read_cell_block(d_, range.top_left().column_index(), range.bottom_right().column_index(),
+        range.top_left().row(), range.bottom_right().row(), out, missing_value, valid);
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_block(const range_reference &range, int *out, const int &missing_value,
+    std::uint8_t *valid) const
+{
+    return read_cell_block(d_, range.top_left().column_index(), range.bottom_right().column_index(),
+        range.top_left().row(), range.bottom_right().row(), out, missing_value, valid);
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_block(const range_reference &range, bool *out, const bool &missing_value,
+    std::uint8_t *valid) const
+{
+    return read_cell_block(d_, range.top_left().column_index(), range.bottom_right().column_index(),
+        range.top_left().row(), range.bottom_right().row(), out, missing_value, valid);
+}
+
+template <>
+XLNT_API std::size_t worksheet::read_block(const range_reference &range, std::string *out, const std::string &missing_value,
+    std::uint8_t *valid) const
+{
+    return read_cell_block(d_, range.top_left().column_index(), range.bottom_right().column_index(),
+        range.top_left().row(), range.bottom_right().row(), out, missing_value, valid);
+}
+
+void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or_col_t row_or_col, bool reverse)
+{
+    if (reverse && amount > min_index)
     {
-        d_->cell_map_[cell_reference(cell.column_, cell.row_)] = cell;
+        throw xlnt::invalid_parameter();
     }
 
-    if (row_or_col == row_or_col_t::row)
+    if ((!reverse && row_or_col == row_or_col_t::row && min_index > constants::max_row() - amount) || (!reverse && row_or_col == row_or_col_t::column && min_index > constants::max_column() - amount))
+    {
+        throw xlnt::exception("Cannot move cells as they would be outside the maximum bounds of the spreadsheet");
+    }
+
+    switch (row_or_col)
+    {
+    case row_or_col_t::row:
+        d_->cells_.shift_rows(min_index, amount, reverse);
+        break;
+    case row_or_col_t::column:
+        d_->cells_.shift_columns(min_index, amount, reverse);
+        break;
+    default:
+        throw xlnt::unhandled_switch_case();
+    }
+
+    // the cached bounds let edits below the last row with properties skip them
+    const auto first_affected = reverse ? min_index - amount : min_index;
+
+    if (row_or_col == row_or_col_t::row && !d_->row_properties_.empty()
+        && d_->row_properties_bounds().second >= first_affected)
     {
         std::vector<std::pair<row_t, xlnt::row_properties>> properties_to_move;
 
-        auto row_prop_iter = d_->row_properties_.cbegin();
-        while (row_prop_iter != d_->row_properties_.cend())
+        auto row_prop_iter = d_->row_properties_.begin();
+        while (row_prop_iter != d_->row_properties_.end())
         {
             auto current_row = row_prop_iter->first;
             if (current_row >= min_index) // extract properties that need to be moved
             {
                 auto tmp_row = reverse ? current_row - amount : current_row + amount;
-                properties_to_move.push_back({tmp_row, row_prop_iter->second});
+                properties_to_move.emplace_back(tmp_row, std::move(row_prop_iter->second));
                 row_prop_iter = d_->row_properties_.erase(row_prop_iter);
             }
             else if (reverse && current_row >= min_index - amount) // clear properties of destination when in reverse
@@ -885,23 +1134,26 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
             }
         }
 
-        for (const auto &prop : properties_to_move)
+        d_->row_properties_removed();
+
+        for (auto &prop : properties_to_move)
         {
-            add_row_properties(prop.first, prop.second);
+            d_->row_properties_[prop.first] = std::move(prop.second);
+            d_->row_properties_added(prop.first);
         }
     }
     else if (row_or_col == row_or_col_t::column)
     {
         std::vector<std::pair<column_t, xlnt::column_properties>> properties_to_move;
 
-        auto col_prop_iter = d_->column_properties_.cbegin();
-        while (col_prop_iter != d_->column_properties_.cend())
+        auto col_prop_iter = d_->column_properties_.begin();
+        while (col_prop_iter != d_->column_properties_.end())
         {
             auto current_col = col_prop_iter->first.index;
             if (current_col >= min_index) // extract properties that need to be moved
             {
                 auto tmp_column = column_t(reverse ? current_col - amount : current_col + amount);
-                properties_to_move.push_back({tmp_column, col_prop_iter->second});
+                properties_to_move.emplace_back(tmp_column, std::move(col_prop_iter->second));
                 col_prop_iter = d_->column_properties_.erase(col_prop_iter);
             }
             else if (reverse && current_col >= min_index - amount) // clear properties of destination when in reverse
@@ -967,15 +1219,16 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     if (d_->parent_ != other.d_->parent_) return false;
 
-    for (auto &cell : d_->cell_map_)
+    for (auto &cell : d_->cells_)
     {
-        if (other.d_->cell_map_.find(cell.first) == other.d_->cell_map_.end())
+        auto other_impl = other.d_->cells_.find(cell.column_.index, cell.row_);
+        if (other_impl == nullptr)
         {
             return false;
         }
 
-        xlnt::cell this_cell(&cell.second);
-        xlnt::cell other_cell(&other.d_->cell_map_[cell.first]);
+        xlnt::cell this_cell(&cell);
+        xlnt::cell other_cell(other_impl);
 
         if (this_cell.data_type() != other_cell.data_type())
         {
@@ -1042,7 +1295,7 @@ void worksheet::remove_named_range(const std::string &name)
 
 void worksheet::reserve(std::size_t n)
 {
-    d_->cell_map_.reserve(n);
+    d_->cells_.reserve(n);
 }
 
 class header_footer worksheet::header_footer() const
@@ -1103,7 +1356,12 @@ const column_properties &worksheet::column_properties(column_t column) const
 
 row_properties &worksheet::row_properties(row_t row)
 {
-    return d_->row_properties_[row];
+    auto match = d_->row_properties_.emplace(row, xlnt::row_properties());
+    if (match.second)
+    {
+        d_->row_properties_added(row);
+    }
+    return match.first->second;
 }
 
 const row_properties &worksheet::row_properties(row_t row) const
@@ -1114,6 +1372,7 @@ const row_properties &worksheet::row_properties(row_t row) const
 void worksheet::add_row_properties(row_t row, const xlnt::row_properties &props)
 {
     d_->row_properties_[row] = props;
+    d_->row_properties_added(row);
 }
 
 worksheet::iterator worksheet::begin()
@@ -1349,7 +1608,7 @@ bool worksheet::has_drawing() const
 
 bool worksheet::is_empty() const
 {
-    return d_->cell_map_.empty();
+    return d_->cells_.empty();
 }
 
 } // namespace xlnt
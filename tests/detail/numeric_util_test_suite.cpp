@@ -21,6 +21,10 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
 #include <xlnt/utils/numeric.hpp>
 #include <helpers/test_suite.hpp>
 
@@ -30,6 +34,9 @@ public:
     numeric_test_suite()
     {
         register_test(test_serialise_number);
+        register_test(test_serialise_matches_printf);
+        register_test(test_deserialise_number);
+        register_test(test_deserialise_matches_strtod);
         register_test(test_float_equals_zero);
         register_test(test_float_equals_large);
         register_test(test_float_equals_fairness);
@@ -52,6 +59,112 @@ public:
         xlnt_assert(serialiser.serialise(123456.789012345) == "123456.789012345");
         xlnt_assert(serialiser.serialise(1.23456789012345e+67) == "1.23456789012345e+67");
         xlnt_assert(serialiser.serialise(1.23456789012345e-67) == "1.23456789012345e-67");
+        // integers, signs and the switch to scientific notation follow printf("%.15g")
+        xlnt_assert(serialiser.serialise(0.0) == "0");
+        xlnt_assert(serialiser.serialise(-0.0) == "-0");
+        xlnt_assert(serialiser.serialise(-42) == "-42");
+        xlnt_assert(serialiser.serialise(999999999999999.0) == "999999999999999");
+        xlnt_assert(serialiser.serialise(1e15) == "1e+15");
+        xlnt_assert(serialiser.serialise(0.0001) == "0.0001");
+        xlnt_assert(serialiser.serialise(0.00001) == "1e-05");
+        xlnt_assert(serialiser.serialise(0.1 + 0.2) == "0.3");
+        xlnt_assert(serialiser.serialise(9.9999999999999999e22) == "1e+23");
+        // writing into a buffer
+        char buffer[32];
+        xlnt_assert(std::string(buffer, serialiser.serialise(-1.5, buffer)) == "-1.5");
+    }
+
+    void test_serialise_matches_printf()
+    {
+        xlnt::detail::number_serialiser serialiser;
+        std::mt19937_64 generator(20211018);
+        std::uniform_real_distribution<double> spreadsheet_values(-1000000, 1000000);
+        char expected[64];
+
+        const auto check = [&](double value) {
+            snprintf(expected, sizeof(expected), "%.15g", value);
+            xlnt_assert_equals(serialiser.serialise(value), std::string(expected));
+        };
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            // any bit pattern, including subnormals, infinities and nans
+            double value;
+            auto bits = generator();
+            std::memcpy(&value, &bits, sizeof(value));
+            check(value);
+
+            check(spreadsheet_values(generator));
+            // values written with 15 digits, which sit exactly on rounding boundaries when printed again
+            check(serialiser.deserialise(serialiser.serialise(spreadsheet_values(generator))));
+            check(static_cast<double>(static_cast<long long>(spreadsheet_values(generator))) / 100);
+        }
+    }
+
+    void test_deserialise_number()
+    {
+        xlnt::detail::number_serialiser serialiser;
+        xlnt_assert_equals(serialiser.deserialise("0"), 0.0);
+        xlnt_assert_equals(serialiser.deserialise("42"), 42.0);
+        xlnt_assert_equals(serialiser.deserialise("-17"), -17.0);
+        xlnt_assert_equals(serialiser.deserialise("+2.5"), 2.5);
+        xlnt_assert_equals(serialiser.deserialise(".5"), 0.5);
+        xlnt_assert_equals(serialiser.deserialise("5."), 5.0);
+        xlnt_assert_equals(serialiser.deserialise("1.5E3"), 1500.0);
+        xlnt_assert_equals(serialiser.deserialise("1.23456789012345e+67"), 1.23456789012345e+67);
+        xlnt_assert_equals(serialiser.deserialise("1.23456789012345e-67"), 1.23456789012345e-67);
+        xlnt_assert_equals(serialiser.deserialise("0.30000000000000004"), 0.30000000000000004);
+        xlnt_assert_equals(serialiser.deserialise("1.7976931348623157e308"), 1.7976931348623157e308);
+        xlnt_assert_equals(serialiser.deserialise("4.9406564584124654e-324"), 4.9406564584124654e-324);
+        xlnt_assert_equals(serialiser.deserialise("123456789012345678901234567890"), 123456789012345678901234567890.0);
+        xlnt_assert(std::signbit(serialiser.deserialise("-0")));
+
+        // views into a larger buffer stop at the given length
+        const char buffer[] = "12.5</v>";
+        xlnt_assert_equals(serialiser.deserialise(buffer, 4), 12.5);
+
+        // partial conversions report how much was read, like strtod
+        ptrdiff_t converted = 0;
+        xlnt_assert_equals(serialiser.deserialise("12abc", &converted), 12.0);
+        xlnt_assert_equals(converted, 2);
+        xlnt_assert_equals(serialiser.deserialise("1e", &converted), 1.0);
+        xlnt_assert_equals(converted, 1);
+        serialiser.deserialise("abc", &converted);
+        xlnt_assert_equals(converted, 0);
+
+        double result = -1.0;
+        const char text[] = "-.e5";
+        xlnt_assert(xlnt::detail::parse_number(text, text + 4, result) == text);
+        xlnt_assert_equals(result, -1.0);
+    }
+
+    void test_deserialise_matches_strtod()
+    {
+        xlnt::detail::number_serialiser serialiser;
+        std::mt19937_64 generator(20211017);
+        std::uniform_int_distribution<int> exponents(-330, 310);
+        char buffer[64];
+
+        for (int i = 0; i < 100000; ++i)
+        {
+            // any bit pattern that isn't nan or infinity, printed with every digit needed to round trip it
+            double value;
+            auto bits = generator();
+            std::memcpy(&value, &bits, sizeof(value));
+
+            if (std::isnan(value) || std::isinf(value))
+            {
+                continue;
+            }
+
+            snprintf(buffer, sizeof(buffer), "%.17g", value);
+            xlnt_assert_equals(serialiser.deserialise(buffer), std::strtod(buffer, nullptr));
+
+            // and the 15 significant digit values Excel writes, across the whole exponent range
+            snprintf(buffer, sizeof(buffer), "%.14e", static_cast<double>(bits % 1000000000000000) / 1e14);
+            snprintf(buffer + std::strlen(buffer) - 4, 8, "e%d", exponents(generator));
+            xlnt_assert_equals(serialiser.deserialise(buffer), std::strtod(buffer, nullptr));
+        }
     }
 
     void test_float_equals_zero()
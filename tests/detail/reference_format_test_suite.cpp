@@ -0,0 +1,86 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <string>
+
+#include <detail/reference_format.hpp>
+#include <helpers/test_suite.hpp>
+#include <xlnt/xlnt.hpp>
+
+class reference_format_test_suite : public test_suite
+{
+public:
+    reference_format_test_suite()
+    {
+        register_test(test_format_column);
+        register_test(test_format_reference);
+    }
+
+    void test_format_column()
+    {
+        auto format = [](xlnt::column_t column) {
+            char letters[xlnt::detail::max_column_letters];
+            return std::string(letters, xlnt::detail::format_column(column, letters));
+        };
+
+        xlnt_assert_equals(format(1), "A");
+        xlnt_assert_equals(format(26), "Z");
+        xlnt_assert_equals(format(27), "AA");
+        xlnt_assert_equals(format(702), "ZZ");
+        xlnt_assert_equals(format(703), "AAA");
+        xlnt_assert_equals(format(16384), "XFD");
+        xlnt_assert_equals(format(16385), "XFE");
+        xlnt_assert_equals(format(xlnt::column_t(4294967295u)), "MWLQKWU");
+        xlnt_assert_throws(format(xlnt::column_t(0u)), xlnt::invalid_column_index);
+
+        for (xlnt::column_t::index_t index = 1; index <= 18278; ++index)
+        {
+            xlnt_assert_equals(xlnt::column_t::column_index_from_string(format(index)), index);
+        }
+    }
+
+    void test_format_reference()
+    {
+        char buffer[xlnt::detail::max_reference_size];
+
+        xlnt::cell_reference reference("XFD", 1048576);
+        xlnt_assert_equals(std::string(buffer, xlnt::detail::format_reference(reference, buffer)), "XFD1048576");
+
+        reference.make_absolute();
+        xlnt_assert_equals(std::string(buffer, xlnt::detail::format_reference(reference, buffer)), "$XFD$1048576");
+
+        reference.make_absolute(false, true);
+        xlnt_assert_equals(std::string(buffer, xlnt::detail::format_reference(reference, buffer)), "XFD$1048576");
+
+        xlnt::cell_reference largest(xlnt::column_t(4294967295u), 4294967295u);
+        largest.make_absolute();
+        const auto written = xlnt::detail::format_reference(largest, buffer) - buffer;
+        xlnt_assert_equals(std::string(buffer, static_cast<std::size_t>(written)), "$MWLQKWU$4294967295");
+        xlnt_assert_equals(static_cast<std::size_t>(written), xlnt::detail::max_reference_size);
+
+        xlnt_assert_equals(xlnt::range_reference("$A$1:XFD1048576").to_string(), "$A$1:XFD1048576");
+    }
+};
+
+static reference_format_test_suite x;
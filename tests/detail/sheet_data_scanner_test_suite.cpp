@@ -0,0 +1,436 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <sstream>
+
+#include <detail/serialization/sheet_data_scanner.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/xlsx_consumer.hpp>
+#include <detail/serialization/zstream.hpp>
+#include <helpers/test_suite.hpp>
+#include <xlnt/xlnt.hpp>
+
+class sheet_data_scanner_test_suite : public test_suite
+{
+public:
+    sheet_data_scanner_test_suite()
+    {
+        register_test(test_find_sheet_data);
+        register_test(test_find_dimension);
+        register_test(test_find_namespace_prefix);
+        register_test(test_scan);
+        register_test(test_unsupported);
+        register_test(test_scan_dy_descent);
+        register_test(test_read_windows);
+        register_test(test_load);
+        register_test(test_load_fallback);
+        register_test(test_load_missing_reference);
+        register_test(test_load_unbound_prefix);
+        register_test(test_load_large);
+        register_test(test_load_threaded);
+    }
+
+    void test_find_sheet_data()
+    {
+        using xlnt::detail::sheet_data_scanner;
+
+        const char *first = nullptr;
+        const char *last = nullptr;
+        std::string prefix;
+
+        const std::string prefixed = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<x:worksheet xmlns:x=\"ns\"><x:dimension ref=\"A1\"/><x:sheetData><x:row r=\"1\"/></x:sheetData></x:worksheet>";
+        xlnt_assert(sheet_data_scanner::find_sheet_data(prefixed.data(), prefixed.data() + prefixed.size(), first, last, prefix));
+        xlnt_assert_equals(prefix, "x");
+        xlnt_assert_equals(std::string(first, last), "<x:row r=\"1\"/>");
+
+        const std::string empty = "<worksheet xmlns=\"ns\"><sheetData/></worksheet>";
+        xlnt_assert(!sheet_data_scanner::find_sheet_data(empty.data(), empty.data() + empty.size(), first, last, prefix));
+
+        const std::string latin1 = "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?><worksheet><sheetData></sheetData></worksheet>";
+        xlnt_assert(!sheet_data_scanner::find_sheet_data(latin1.data(), latin1.data() + latin1.size(), first, last, prefix));
+    }
+
+    void test_find_dimension()
+    {
+        using xlnt::detail::sheet_data_scanner;
+
+        std::string ref;
+
+        const std::string prefixed = "<x:worksheet xmlns:x=\"ns\"><x:sheetPr/><x:dimension xmlns:y=\"ns\" y:ref=\"B2\" ref='A1:C3'/>";
+        xlnt_assert(sheet_data_scanner::find_dimension(prefixed.data(), prefixed.data() + prefixed.size(), "x", ref));
+        xlnt_assert_equals(ref, "A1:C3");
+
+        const std::string other_prefix = "<worksheet><y:dimension ref=\"A1\"/>";
+        xlnt_assert(!sheet_data_scanner::find_dimension(other_prefix.data(), other_prefix.data() + other_prefix.size(), "", ref));
+
+        const std::string missing = "<worksheet><dimension/><sheetViews/>";
+        xlnt_assert(!sheet_data_scanner::find_dimension(missing.data(), missing.data() + missing.size(), "", ref));
+    }
+
+    void test_find_namespace_prefix()
+    {
+        using xlnt::detail::sheet_data_scanner;
+
+        std::string prefix;
+
+        const std::string declared = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<worksheet xmlns=\"main\" xmlns:a=\"other\" xmlns:b='ac'><sheetData>";
+        xlnt_assert(sheet_data_scanner::find_namespace_prefix(declared.data(), declared.data() + declared.size(), "ac", prefix));
+        xlnt_assert_equals(prefix, "b");
+
+        const std::string not_root = "<worksheet xmlns=\"main\"><sheetPr xmlns:b=\"ac\"/><sheetData>";
+        xlnt_assert(!sheet_data_scanner::find_namespace_prefix(not_root.data(), not_root.data() + not_root.size(), "ac", prefix));
+    }
+
+    void test_scan()
+    {
+        using event = xlnt::detail::sheet_data_scanner::event;
+
+        const std::string content = "<row r=\"2\" spans=\"1:3\" ht=\"15\" customHeight=\"1\">"
+                                    "<c r=\"A2\" s=\"3\"><v>1.5</v></c>"
+                                    "<c r=\"B2\" t=\"inlineStr\"><is><t>a &amp; b&#x41;</t></is></c>"
+                                    "<c r=\"C2\"><f t=\"shared\" ref=\"C2:C3\" si=\"0\">A2*2</f><v>3</v></c>"
+                                    "<c r=\"D2\"/></row>\n<row r=\"3\"/>";
+        xlnt::detail::sheet_data_scanner scanner(content.data(), content.data() + content.size(), "");
+
+        xlnt_assert(scanner.next() == event::row);
+        xlnt_assert_equals(scanner.row().r.str(), "2");
+        xlnt_assert_equals(scanner.row().spans.str(), "1:3");
+        xlnt_assert(scanner.row().custom_height.equals("1"));
+        xlnt_assert(!scanner.row().hidden.present());
+
+        xlnt_assert(scanner.next() == event::cell);
+        xlnt_assert_equals(scanner.cell().r.str(), "A2");
+        xlnt_assert_equals(scanner.cell().s.str(), "3");
+        xlnt_assert(!scanner.cell().t.present());
+        xlnt_assert_equals(scanner.cell().value.str(), "1.5");
+
+        xlnt_assert(scanner.next() == event::cell);
+        xlnt_assert(scanner.cell().t.equals("inlineStr"));
+        xlnt_assert_equals(scanner.cell().value.str(), "a & bA");
+
+        xlnt_assert(scanner.next() == event::cell);
+        xlnt_assert_equals(scanner.cell().formula.str(), "A2*2");
+        xlnt_assert(scanner.cell().formula_type.equals("shared"));
+        xlnt_assert_equals(scanner.cell().formula_ref.str(), "C2:C3");
+        xlnt_assert_equals(scanner.cell().formula_shared_index.str(), "0");
+        xlnt_assert_equals(scanner.cell().value.str(), "3");
+
+        xlnt_assert(scanner.next() == event::cell);
+        xlnt_assert_equals(scanner.cell().r.str(), "D2");
+        xlnt_assert(scanner.cell().value.empty());
+
+        xlnt_assert(scanner.next() == event::row);
+        xlnt_assert_equals(scanner.row().r.str(), "3");
+        xlnt_assert(scanner.next() == event::end_of_data);
+    }
+
+    void test_unsupported()
+    {
+        using event = xlnt::detail::sheet_data_scanner::event;
+
+        const std::vector<std::string> contents = {
+            "<row r=\"1\"><!-- comment --></row>",
+            "<row r=\"1\"><c r=\"A1\" t=\"inlineStr\"><is><r><t>rich</t></r></is></c></row>",
+            "<row r=\"1\"><c r=\"A1\"><v><![CDATA[1]]></v></c></row>",
+            "<row r=\"1\" xmlns:y=\"ns\"></row>",
+            "<row r=\"1\"><c r=\"A1\"><v>&nbsp;</v></c></row>",
+            "<row r=\"1\"><c><v>1</v></c></row>",
+            "<row r=\"1\"><c r=\"A1\"><v>1</f></c></row>",
+            "<y:row r=\"1\"></y:row>",
+            "<row r=\"1\"><c r=\"A1\"><v>1</v></c>",
+            "<row r=\"1\" x14ac:dyDescent=\"0.25\"></row>",
+            "<row r=\"1\"><c r=\"A1\" y:t=\"s\"><v>0</v></c></row>",
+            "<row r=\"1\"><c r=\"A1\"><f y:t=\"shared\">1</f></c></row>",
+        };
+
+        for (const auto &content : contents)
+        {
+            xlnt::detail::sheet_data_scanner scanner(content.data(), content.data() + content.size(), "");
+            auto e = scanner.next();
+
+            while (e == event::row || e == event::cell)
+            {
+                e = scanner.next();
+            }
+
+            xlnt_assert(e == event::unsupported);
+        }
+    }
+
+    void test_scan_dy_descent()
+    {
+        using event = xlnt::detail::sheet_data_scanner::event;
+
+        const std::string content = "<row r=\"1\" a:dyDescent=\"0.25\" dyDescent=\"1\"/>"
+                                    "<row r=\"2\" b:dyDescent=\"0.25\"/>";
+        xlnt::detail::sheet_data_scanner scanner(content.data(), content.data() + content.size(), "", "a");
+
+        xlnt_assert(scanner.next() == event::row);
+        xlnt_assert_equals(scanner.row().dy_descent.str(), "0.25");
+        xlnt_assert(scanner.next() == event::unsupported);
+    }
+
+    void test_load()
+    {
+        auto wb = load_with_sheet_data("<row r=\"1\" ht=\"20\" customHeight=\"1\">"
+                                       "<c r=\"A1\"><v>2.5</v></c>"
+                                       "<c r=\"B1\" t=\"inlineStr\"><is><t>x &lt; y</t></is></c>"
+                                       "<c r=\"C1\"><f t=\"shared\" ref=\"C1:C2\" si=\"0\">A1*2</f><v>5</v></c>"
+                                       "<c r=\"D1\" t=\"b\"><v>1</v></c></row>"
+                                       "<row r=\"2\"><c r=\"C2\"><f t=\"shared\" si=\"0\"/><v>5</v></c></row>");
+        auto ws = wb.active_sheet();
+
+        xlnt_assert_equals(ws.cell("A1").value<double>(), 2.5);
+        xlnt_assert_equals(ws.cell("B1").value<std::string>(), "x < y");
+        xlnt_assert_equals(ws.cell("C1").formula(), "A1*2");
+        xlnt_assert_equals(ws.cell("C2").formula(), "A1*2");
+        xlnt_assert(ws.cell("D1").value<bool>());
+        xlnt_assert_equals(ws.row_properties(1).height.get(), 20.0);
+        xlnt_assert(!ws.has_cell("A2"));
+    }
+
+    void test_read_windows()
+    {
+        const std::string head = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<x:worksheet xmlns:x=\"ns\"><x:dimension ref=\"A1\"/><x:sheetData>";
+        const std::string tail = "</x:sheetData><x:pageMargins left=\"1\"/></x:worksheet>";
+        std::string sheet_data;
+
+        for (int row = 1; row <= 20000; ++row)
+        {
+            auto r = std::to_string(row);
+            sheet_data += "<x:row r=\"" + r + "\"><x:c r=\"A" + r + "\"><x:v>" + r + "</x:v></x:c></x:row>";
+        }
+
+        std::istringstream stream(head + sheet_data + tail);
+        std::string part_data;
+        std::string prefix;
+        xlnt::detail::sheet_data_reader reader(stream, part_data);
+        xlnt_assert(reader.open(prefix));
+        xlnt_assert_equals(prefix, "x");
+
+        // every window ends with a complete row and together they are all of sheetData
+        const char *first = nullptr;
+        const char *last = nullptr;
+        std::string windows;
+        auto window_count = 0;
+
+        while (reader.next(first, last))
+        {
+            const auto window = std::string(first, last);
+            xlnt_assert(window.empty() || window.compare(window.size() - 8, 8, "</x:row>") == 0);
+            windows += window;
+            ++window_count;
+        }
+
+        xlnt_assert(reader.finished());
+        xlnt_assert(!reader.failed());
+        xlnt_assert(window_count > 1);
+        xlnt_assert(windows == sheet_data);
+        xlnt_assert(part_data == head + tail);
+
+        // without an end tag the part can't be read this way
+        std::istringstream truncated(head + sheet_data);
+        part_data.clear();
+        xlnt::detail::sheet_data_reader truncated_reader(truncated, part_data);
+        xlnt_assert(truncated_reader.open(prefix));
+
+        while (truncated_reader.next(first, last))
+        {
+        }
+
+        xlnt_assert(truncated_reader.failed());
+    }
+
+    void test_load_fallback()
+    {
+        // the comment makes the scanner give up after having read the first row
+        auto wb = load_with_sheet_data("<row r=\"1\"><c r=\"A1\"><v>1</v></c></row>"
+                                       "<!-- comment --><row r=\"2\"><c r=\"A2\"><v>2</v></c></row>");
+        auto ws = wb.active_sheet();
+
+        xlnt_assert_equals(ws.cell("A1").value<int>(), 1);
+        xlnt_assert_equals(ws.cell("A2").value<int>(), 2);
+        xlnt_assert_equals(ws.calculate_dimension().to_string(), "A1:A2");
+    }
+
+    void test_load_missing_reference()
+    {
+        // a row or cell without a usable reference would end up at row or column 0
+        xlnt_assert_throws(load_with_sheet_data("<row r=\"0\"><c r=\"A1\"><v>1</v></c></row>"),
+            xlnt::invalid_cell_reference);
+        xlnt_assert_throws(load_with_sheet_data("<!-- comment --><row><c r=\"A1\"><v>1</v></c></row>"),
+            xlnt::invalid_cell_reference);
+        xlnt_assert_throws(load_with_sheet_data("<row r=\"1\"><c><v>1</v></c></row>"),
+            xlnt::invalid_cell_reference);
+        xlnt_assert_throws(load_with_sheet_data("<!-- comment --><row r=\"1\"><c><v>1</v></c></row>"),
+            xlnt::invalid_cell_reference);
+    }
+
+    void test_load_unbound_prefix()
+    {
+        // the saved part doesn't declare x14ac
+        xlnt_assert_throws(load_with_sheet_data("<row r=\"1\" x14ac:dyDescent=\"0.25\"><c r=\"A1\"><v>1</v></c></row>"),
+            std::exception);
+    }
+
+    void test_load_large()
+    {
+        // large enough for cells to be scanned and added on separate threads
+        std::string sheet_data;
+        std::string fallback_sheet_data;
+
+        for (int row = 1; row <= 5000; ++row)
+        {
+            auto r = std::to_string(row);
+            sheet_data += "<row r=\"" + r + "\"><c r=\"A" + r + "\"><v>" + r + "</v></c>"
+                + "<c r=\"B" + r + "\" t=\"inlineStr\"><is><t>text " + r + "</t></is></c>"
+                + "<c r=\"C" + r + "\"><f>A" + r + "*2</f><v>" + std::to_string(row * 2) + "</v></c></row>";
+
+            if (row == 4900)
+            {
+                fallback_sheet_data = sheet_data + "<!-- comment -->";
+            }
+        }
+
+        fallback_sheet_data += sheet_data.substr(fallback_sheet_data.size() - 16);
+
+        for (const auto &content : {sheet_data, fallback_sheet_data})
+        {
+            auto wb = load_with_sheet_data(content);
+            auto ws = wb.active_sheet();
+
+            xlnt_assert_equals(ws.calculate_dimension().to_string(), "A1:C5000");
+            xlnt_assert_equals(ws.cell("A4999").value<int>(), 4999);
+            xlnt_assert_equals(ws.cell("B123").value<std::string>(), "text 123");
+            xlnt_assert_equals(ws.cell("C5000").formula(), "A5000*2");
+            xlnt_assert_equals(ws.cell("C5000").value<int>(), 10000);
+        }
+    }
+
+    void test_load_threaded()
+    {
+        using xlnt::detail::sheet_data_threading;
+
+        // with 1 KB windows, every few rows are scanned into a batch of their own,
+        // so the scanner thread keeps having to wait for the pipeline to drain
+        std::string sheet_data;
+        std::string fallback_sheet_data;
+        std::string bad_style_sheet_data;
+
+        for (int row = 1; row <= 300; ++row)
+        {
+            auto r = std::to_string(row);
+            auto style = row == 250 ? std::string(" s=\"99\"") : std::string();
+            auto cells = "<c r=\"A" + r + "\"><v>" + r + "</v></c>"
+                + "<c r=\"B" + r + "\" t=\"inlineStr\"><is><t>text " + r + "</t></is></c>"
+                + "<c r=\"C" + r + "\"><f>A" + r + "*2</f><v>" + std::to_string(row * 2) + "</v></c>";
+
+            sheet_data += "<row r=\"" + r + "\">" + cells + "</row>";
+            bad_style_sheet_data += "<row r=\"" + r + "\"><c r=\"D" + r + "\"" + style + "><v>1</v></c>" + cells + "</row>";
+
+            if (row == 200)
+            {
+                fallback_sheet_data = sheet_data + "<!-- comment -->";
+            }
+        }
+
+        fallback_sheet_data += sheet_data.substr(fallback_sheet_data.size() - 16);
+
+        for (auto threading : {sheet_data_threading::always, sheet_data_threading::never})
+        {
+            for (const auto &content : {sheet_data, fallback_sheet_data})
+            {
+                auto wb = load_with_sheet_data(content, 1024, threading);
+                auto ws = wb.active_sheet();
+
+                xlnt_assert_equals(ws.calculate_dimension().to_string(), "A1:C300");
+                xlnt_assert_equals(ws.cell("A299").value<int>(), 299);
+                xlnt_assert_equals(ws.cell("B123").value<std::string>(), "text 123");
+                xlnt_assert_equals(ws.cell("C300").formula(), "A300*2");
+                xlnt_assert_equals(ws.cell("C300").value<int>(), 600);
+            }
+
+            // the workbook has no style 99, so adding that cell throws while
+            // the scanner is still working on later windows
+            xlnt_assert_throws(load_with_sheet_data(bad_style_sheet_data, 1024, threading),
+                xlnt::invalid_parameter);
+        }
+    }
+
+private:
+    /// <summary>
+    /// Saves a one sheet workbook, replaces the content of <sheetData> with sheet_data
+    /// and loads the result, reading sheetData in windows of window_size bytes.
+    /// </summary>
+    xlnt::workbook load_with_sheet_data(const std::string &sheet_data,
+        std::size_t window_size = xlnt::detail::sheet_data_reader::default_window_size,
+        xlnt::detail::sheet_data_threading threading = xlnt::detail::sheet_data_threading::automatic)
+    {
+        xlnt::workbook source;
+        source.active_sheet().cell("A1").value(1);
+        std::vector<std::uint8_t> saved;
+        source.save(saved);
+
+        const auto sheet_path = xlnt::path("xl/worksheets/sheet1.xml");
+        xlnt::detail::vector_istreambuf source_buffer(saved);
+        std::istream source_stream(&source_buffer);
+        xlnt::detail::izstream source_archive(source_stream);
+
+        std::vector<std::uint8_t> modified;
+        {
+            xlnt::detail::vector_ostreambuf modified_buffer(modified);
+            std::ostream modified_stream(&modified_buffer);
+            xlnt::detail::ozstream modified_archive(modified_stream);
+
+            for (const auto &file : source_archive.files())
+            {
+                auto content = source_archive.read(file);
+
+                if (file.string() == sheet_path.string())
+                {
+                    auto first = content.find("<sheetData>") + 11;
+                    content.replace(first, content.find("</sheetData>") - first, sheet_data);
+                }
+
+                auto part_buffer = modified_archive.open(file);
+                std::ostream part_stream(part_buffer.get());
+                part_stream << content;
+            }
+        }
+
+        xlnt::workbook loaded;
+        xlnt::detail::xlsx_consumer consumer(loaded);
+        consumer.sheet_data_reading(window_size, threading);
+
+        xlnt::detail::vector_istreambuf modified_buffer(modified);
+        std::istream modified_stream(&modified_buffer);
+        consumer.read(modified_stream);
+
+        return loaded;
+    }
+};
+
+static sheet_data_scanner_test_suite x;
@@ -0,0 +1,117 @@
+// Copyright (c) 2014-2021 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <sstream>
+
+#include <detail/external/include_libstudxml.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+#include <helpers/test_suite.hpp>
+#include <xlnt/xlnt.hpp>
+
+class sheet_data_writer_test_suite : public test_suite
+{
+public:
+    sheet_data_writer_test_suite()
+    {
+        register_test(test_write);
+        register_test(test_same_as_serializer);
+    }
+
+    void test_write()
+    {
+        std::ostringstream stream;
+        xml::serializer serializer(stream, "sheet", 0);
+        serializer.start_element("sheetData");
+        serializer.characters(std::string());
+
+        xlnt::detail::sheet_data_writer writer(stream, serializer);
+        writer.start_element("row");
+        writer.attribute("r", std::size_t(7));
+        writer.attribute("spans", std::size_t(1), std::size_t(16385));
+        writer.attribute("ht", 12.75);
+        writer.start_element("c");
+        writer.attribute("r", xlnt::column_t("XFD"), xlnt::row_t(7));
+        writer.attribute("t", "s");
+        writer.start_element("v");
+        writer.characters(std::size_t(3));
+        writer.end_element("v");
+        writer.end_element("c");
+        writer.start_element("c");
+        writer.attribute("r", xlnt::column_t("XFE"), xlnt::row_t(7));
+        writer.end_element("c");
+        writer.end_element("row");
+        writer.flush();
+        serializer.end_element();
+
+        xlnt_assert_equals(stream.str(), "<sheetData><row r=\"7\" spans=\"1:16385\" ht=\"12.75\">"
+                                         "<c r=\"XFD7\" t=\"s\"><v>3</v></c><c r=\"XFE7\"/></row></sheetData>");
+    }
+
+    void test_same_as_serializer()
+    {
+        const std::vector<std::string> texts = {"SUM(A1:A3)", "IF(A1<2,\"a&b\",\"c\")", "x > y",
+            "line\nbreak\ttab", "carriage\rreturn", "\xce\x9b unicode", ""};
+
+        std::ostringstream expected_stream;
+        xml::serializer expected(expected_stream, "sheet", 0);
+        expected.start_element("sheetData");
+
+        std::ostringstream written_stream;
+        xml::serializer serializer(written_stream, "sheet", 0);
+        serializer.start_element("sheetData");
+        serializer.characters(std::string());
+        xlnt::detail::sheet_data_writer writer(written_stream, serializer);
+
+        for (const auto &text : texts)
+        {
+            expected.start_element("c");
+            expected.attribute("r", "A1");
+            expected.start_element("f");
+            expected.characters(text);
+            expected.end_element();
+            expected.start_element("v");
+            expected.characters("0.1");
+            expected.end_element();
+            expected.end_element();
+
+            writer.start_element("c");
+            writer.attribute("r", xlnt::column_t(1), xlnt::row_t(1));
+            writer.start_element("f");
+            writer.characters(text);
+            writer.end_element("f");
+            writer.start_element("v");
+            writer.characters(0.1);
+            writer.end_element("v");
+            writer.end_element("c");
+        }
+
+        expected.end_element();
+        writer.flush();
+        serializer.end_element();
+
+        xlnt_assert_equals(written_stream.str(), expected_stream.str());
+    }
+};
+
+static sheet_data_writer_test_suite x;
@@ -21,9 +21,15 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 #include <xlnt/xlnt.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <helpers/path_helper.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
@@ -65,7 +71,15 @@ public:
         register_test(test_round_trip_rw_encrypted_standard);
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
+        register_test(test_streaming_read_values);
         register_test(test_streaming_write);
+        register_test(test_load_parallel);
+        register_test(test_save_parallel);
+        register_test(test_save_compression);
+        register_test(test_save_buffer);
+        register_test(test_load_selected_sheets);
+        register_test(test_load_skipped_parts);
+        register_test(test_load_lazy);
         register_test(test_load_save_german_locale);
         register_test(test_Issue445_inline_str_load);
         register_test(test_Issue445_inline_str_streaming_read);
@@ -73,6 +87,7 @@ public:
         register_test(test_Issue503_external_link_load);
         register_test(test_formatting);
         register_test(test_active_sheet);
+        register_test(test_write_sparse_extremes);
     }
 
     bool workbook_matches_file(xlnt::workbook &wb, const xlnt::path &file)
@@ -695,6 +710,44 @@ public:
         }
     }
 
+    void test_streaming_read_values()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("text");
+        ws.cell("B1").formula("=A1");
+        ws.cell("C1").value(3.5);
+        ws.cell("A2").value(42);
+        ws.cell("AB2").value(true);
+        ws.cell("C3").value("more text");
+        ws.cell("D3").value(-1.25);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::workbook expected;
+        expected.load(data);
+        auto expected_ws = expected.active_sheet();
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet(reader.sheet_titles().front());
+        std::size_t count = 0;
+
+        // the same cell slot is reused for every cell, nothing may carry over from the one before
+        while (reader.has_cell())
+        {
+            auto cell = reader.read_cell();
+            auto expected_cell = expected_ws.cell(cell.reference());
+            xlnt_assert_equals(cell.data_type(), expected_cell.data_type());
+            xlnt_assert_equals(cell.has_formula(), expected_cell.has_formula());
+            xlnt_assert_equals(cell.to_string(), expected_cell.to_string());
+            ++count;
+        }
+
+        reader.end_worksheet();
+        xlnt_assert_equals(count, 7);
+    }
+
     void test_streaming_write()
     {
         const auto path = std::string("stream-out.xlsx");
@@ -754,6 +807,300 @@ public:
         xlnt_assert(!wbr.has_cell());
     }
 
+    void test_load_parallel()
+    {
+        const auto files = {
+            "10_comments_hyperlinks_formulae.xlsx",
+            "16_hidden_sheet.xlsx",
+            "Issue279_workbook_delete_rename.xlsx",
+        };
+
+        for (const auto file : files)
+        {
+            const auto path = path_helper::test_file(file);
+
+            xlnt::workbook serial;
+            serial.load(path);
+            std::vector<std::uint8_t> serial_data;
+            serial.save(serial_data);
+
+            for (auto threads : {std::size_t(0), std::size_t(4)})
+            {
+                xlnt::load_options options;
+                options.worksheet_threads = threads;
+
+                xlnt::workbook parallel;
+                parallel.load(path, options);
+                std::vector<std::uint8_t> parallel_data;
+                parallel.save(parallel_data);
+
+                xlnt_assert_equals(parallel.sheet_titles(), serial.sheet_titles());
+                xlnt_assert(xml_helper::xlsx_archives_match(serial_data, parallel_data));
+            }
+        }
+
+        xlnt::workbook wb;
+        xlnt::load_options options;
+        options.worksheet_threads = 4;
+        wb.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), options);
+        xlnt_assert_equals(wb[1].cell("A1").value<std::string>(), "Sheet2!A1");
+        xlnt_assert_equals(wb[1].cell("A1").comment().plain_text(), "Sheet2 comment");
+        xlnt_assert_equals(wb[0].cell("C1").formula(), "CONCATENATE(C2,C3)");
+    }
+
+    void test_load_selected_sheets()
+    {
+        xlnt::load_options options;
+        options.sheets = {"Sheet2", "Missing"};
+
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), options);
+        xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>{"Sheet2"});
+        xlnt_assert_equals(wb.active_sheet().cell("A1").value<std::string>(), "Sheet2!A1");
+        xlnt_assert_equals(wb.active_sheet().cell("A1").comment().plain_text(), "Sheet2 comment");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::workbook reloaded;
+        reloaded.load(data);
+        xlnt_assert_equals(reloaded.sheet_titles(), std::vector<std::string>{"Sheet2"});
+        xlnt_assert_equals(reloaded[0].cell("A1").value<std::string>(), "Sheet2!A1");
+
+        xlnt::workbook hidden;
+        hidden.load(path_helper::test_file("16_hidden_sheet.xlsx"), options);
+        xlnt_assert_equals(hidden.sheet_count(), 1);
+        xlnt_assert(hidden.sheet_hidden_by_index(0));
+    }
+
+    void test_load_skipped_parts()
+    {
+        xlnt::load_options options;
+        options.skip_comments = true;
+        options.values_only = true;
+
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), options);
+        auto ws = wb[0];
+        xlnt_assert_equals(ws.cell("A1").value<std::string>(), "Sheet1!A1");
+        xlnt_assert(!ws.cell("A1").has_comment());
+        xlnt_assert(!ws.cell("C1").has_formula());
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::load_options skip_images;
+        skip_images.skip_images = true;
+        xlnt::workbook images;
+        images.load(path_helper::test_file("14_images.xlsx"), skip_images);
+        xlnt_assert_throws(images.save(data), xlnt::exception);
+
+        xlnt::load_options skip_styles;
+        skip_styles.skip_styles = true;
+        xlnt::workbook styles;
+        styles.load(path_helper::test_file("4_every_style.xlsx"), skip_styles);
+        xlnt_assert(!styles.active_sheet().cell("A1").has_format());
+        xlnt_assert_throws(styles.save(data), xlnt::exception);
+
+        // a workbook which had nothing to skip can still be saved
+        xlnt::workbook minimal;
+        minimal.load(path_helper::test_file("2_minimal.xlsx"), skip_images);
+        minimal.save(data);
+    }
+
+    void test_load_lazy()
+    {
+        const auto path = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+
+        xlnt::workbook eager;
+        eager.load(path);
+        std::vector<std::uint8_t> eager_data;
+        eager.save(eager_data);
+
+        xlnt::load_options options;
+        options.lazy = true;
+
+        xlnt::workbook lazy;
+        lazy.load(path, options);
+        xlnt_assert_equals(lazy.sheet_titles(), eager.sheet_titles());
+        xlnt_assert_equals(lazy.sheet_by_title("Sheet2").cell("A1").comment().plain_text(), "Sheet2 comment");
+
+        // the workbook is moved before the remaining worksheet is read
+        xlnt::workbook moved(std::move(lazy));
+        xlnt_assert_equals(moved[0].cell("C1").formula(), "CONCATENATE(C2,C3)");
+
+        std::vector<std::uint8_t> lazy_data;
+        moved.save(lazy_data);
+        xlnt_assert(xml_helper::xlsx_archives_match(eager_data, lazy_data));
+
+        xlnt::workbook from_data;
+        from_data.load(eager_data, options);
+        xlnt::workbook copy(from_data);
+        xlnt_assert_equals(copy[1].cell("A1").value<std::string>(), "Sheet2!A1");
+        xlnt_assert_equals(from_data[1].cell("A1").value<std::string>(), "Sheet2!A1");
+
+        // named ranges aren't read from files, so looking for one doesn't read
+        // the worksheets, which would fail with the stream gone bad
+        std::istringstream unread_stream(std::string(eager_data.begin(), eager_data.end()));
+        xlnt::workbook unread;
+        unread.load(unread_stream, options);
+        unread_stream.setstate(std::ios::badbit);
+        xlnt_assert(!unread.has_named_range("missing"));
+        xlnt_assert_throws(unread.named_range("missing"), xlnt::key_not_found);
+        xlnt_assert_throws(unread.remove_named_range("missing"), xlnt::key_not_found);
+    }
+
+    void test_save_parallel()
+    {
+        const auto files = {
+            "10_comments_hyperlinks_formulae.xlsx",
+            "11_print_settings.xlsx",
+            "14_images.xlsx",
+            "17_xlsm.xlsm",
+            "Issue279_workbook_delete_rename.xlsx",
+        };
+
+        for (const auto file : files)
+        {
+            xlnt::workbook wb;
+            wb.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> serial_data;
+            wb.save(serial_data);
+
+            for (auto threads : {std::size_t(0), std::size_t(2), std::size_t(4)})
+            {
+                xlnt::save_options options;
+                options.worksheet_threads = threads;
+
+                std::vector<std::uint8_t> parallel_data;
+                wb.save(parallel_data, options);
+
+                xlnt_assert(parallel_data == serial_data);
+            }
+        }
+    }
+
+    void test_save_compression()
+    {
+        auto contains = [](const std::vector<std::uint8_t> &data, const std::string &text) {
+            return std::search(data.begin(), data.end(), text.begin(), text.end(),
+                       [](std::uint8_t a, char b) { return a == static_cast<std::uint8_t>(b); })
+                != data.end();
+        };
+
+        xlnt::workbook wb;
+        wb.load(path_helper::test_file("14_images.xlsx"));
+        std::vector<std::uint8_t> default_data;
+        wb.save(default_data);
+
+        xlnt::detail::vector_istreambuf default_buffer(default_data);
+        std::istream default_stream(&default_buffer);
+        const auto image = xlnt::detail::izstream(default_stream).read(xlnt::path("xl/media/image1.jpg"));
+        xlnt_assert(!contains(default_data, image));
+
+        xlnt::save_options stored;
+        stored.compression.level = 0;
+        std::vector<std::uint8_t> stored_data;
+        wb.save(stored_data, stored);
+        xlnt_assert(stored_data.size() > default_data.size());
+        xlnt_assert(contains(stored_data, "<worksheet"));
+        xlnt_assert(contains(stored_data, image));
+        xlnt_assert(xml_helper::xlsx_archives_match(default_data, stored_data));
+
+        xlnt::save_options fast;
+        fast.compression.level = 1;
+        fast.compression.strategy = xlnt::compression_strategy::run_length;
+        fast.part_compression[".jpg"].level = 0;
+        std::vector<std::uint8_t> fast_data;
+        wb.save(fast_data, fast);
+        xlnt_assert(!contains(fast_data, "<worksheet"));
+        xlnt_assert(contains(fast_data, image));
+        xlnt_assert(xml_helper::xlsx_archives_match(default_data, fast_data));
+
+        fast.part_compression.clear();
+        fast.part_compression["xl/media/image1.jpg"].level = 0;
+        fast.part_compression[".jpg"].level = 9;
+        wb.save(fast_data, fast);
+        xlnt_assert(contains(fast_data, image));
+
+        xlnt::save_options invalid;
+        invalid.compression.level = 10;
+        std::vector<std::uint8_t> invalid_data;
+        xlnt_assert_throws(wb.save(invalid_data, invalid), xlnt::invalid_parameter);
+        xlnt_assert(invalid_data.empty());
+
+        // checked before the file is opened, so an existing one is left alone
+        invalid.compression.level = -1;
+        invalid.part_compression["xl/media/image1.jpg"].level = -2;
+        temporary_file existing;
+        wb.save(existing.get_path());
+        const auto existing_size = existing.get_path().read_contents().size();
+        xlnt_assert_throws(wb.save(existing.get_path(), invalid), xlnt::invalid_parameter);
+        xlnt_assert_equals(existing.get_path().read_contents().size(), existing_size);
+        xlnt_assert_throws(wb.save_size_bound(invalid), xlnt::invalid_parameter);
+
+        std::vector<std::uint8_t> streamed_data;
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(streamed_data, stored);
+            writer.add_worksheet("stream");
+        }
+        xlnt_assert(contains(streamed_data, "<worksheet"));
+
+        xlnt::workbook streamed;
+        streamed.load(streamed_data);
+        xlnt_assert_equals(streamed.sheet_count(), 1);
+    }
+
+    void test_save_buffer()
+    {
+        const auto files = {
+            "10_comments_hyperlinks_formulae.xlsx",
+            "14_images.xlsx",
+        };
+
+        for (const auto file : files)
+        {
+            xlnt::workbook wb;
+            wb.load(path_helper::test_file(file));
+
+            xlnt::save_options options;
+            options.part_compression[".jpg"].level = 0;
+            std::vector<std::uint8_t> expected;
+            wb.save(expected, options);
+
+            const auto bound = wb.save_size_bound(options);
+            xlnt_assert(bound >= expected.size());
+
+            std::vector<std::uint8_t> buffer(bound);
+            const auto size = wb.save(buffer.data(), buffer.size(), options);
+            xlnt_assert_equals(size, expected.size());
+            buffer.resize(size);
+            xlnt_assert(buffer == expected);
+
+            xlnt_assert_throws(wb.save(buffer.data(), size - 1, options), xlnt::exception);
+
+            temporary_file temp;
+            wb.save_mapped(temp.get_path(), options);
+            std::ifstream mapped_file(temp.get_path().string(), std::ios::binary);
+            const auto mapped = std::vector<std::uint8_t>(std::istreambuf_iterator<char>(mapped_file), {});
+            xlnt_assert(mapped == expected);
+
+            xlnt::save_options stored;
+            stored.compression.level = 0;
+            std::vector<std::uint8_t> stored_data;
+            wb.save(stored_data, stored);
+            xlnt_assert_equals(wb.save_size_bound(stored), stored_data.size());
+        }
+
+        // a mapped file which is never closed, because writing it failed, is deleted
+        temporary_file unfinished;
+        {
+            xlnt::detail::mapped_file mapped(unfinished.get_path(), 4096);
+            xlnt_assert(unfinished.get_path().exists());
+        }
+        xlnt_assert(!unfinished.get_path().exists());
+    }
+
     void test_Issue503_external_link_load()
     {
         xlnt::workbook wb;
@@ -808,6 +1155,26 @@ public:
         wb.load(path_helper::test_file("20_active_sheet.xlsx"));
         xlnt_assert_equals(wb.active_sheet(), wb[2]);
     }
+
+    void test_write_sparse_extremes()
+    {
+        // cells in opposite corners of the sheet shouldn't make saving scan the whole dimension
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1);
+        ws.cell("XFD1048576").value(2);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook wb2;
+        wb2.load(data);
+        auto ws2 = wb2.active_sheet();
+
+        xlnt_assert_equals(ws2.calculate_dimension(), "A1:XFD1048576");
+        xlnt_assert_equals(ws2.cell("A1").value<int>(), 1);
+        xlnt_assert_equals(ws2.cell("XFD1048576").value<int>(), 2);
+    }
 };
 
 static serialization_test_suite x;
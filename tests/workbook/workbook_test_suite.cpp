@@ -71,6 +71,7 @@ public:
         register_test(test_Issue279);
         register_test(test_Issue353);
         register_test(test_Issue494);
+        register_test(test_arena_allocation);
     }
 
     void test_active_sheet()
@@ -543,5 +544,46 @@ public:
         xlnt_assert_equals(ws.cell(2, 1).to_string(), "V1.00");
         xlnt_assert_equals(ws.cell(2, 2).to_string(), "V1.00");
     }
+
+    void test_arena_allocation()
+    {
+        xlnt::workbook wb(xlnt::cell_allocation::arena);
+        xlnt_assert_equals(wb.cell_allocation(), xlnt::cell_allocation::arena);
+
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 200; ++row)
+        {
+            ws.cell(1, row).value(static_cast<int>(row));
+            ws.cell(2, row).formula("=A" + std::to_string(row) + "*2");
+            ws.cell(3, row).value(xlnt::rich_text("text " + std::to_string(row)));
+        }
+
+        ws.cell("B7").clear_value();
+        ws.delete_rows(10, 5);
+        xlnt_assert_equals(ws.cell("B10").formula(), "A15*2");
+
+        auto copy = wb.copy_sheet(ws);
+        xlnt_assert_equals(copy.cell("C20").value<std::string>(), "text 25");
+
+        wb.save("temp.xlsx");
+        wb.load("temp.xlsx");
+        xlnt_assert_equals(wb.cell_allocation(), xlnt::cell_allocation::arena);
+
+        for (auto loaded : wb)
+        {
+            xlnt_assert_equals(loaded.cell_allocation(), xlnt::cell_allocation::arena);
+        }
+
+        xlnt_assert_equals(wb.active_sheet().cell("B195").formula(), "A200*2");
+
+        auto copied = wb;
+        xlnt_assert_equals(copied.cell_allocation(), xlnt::cell_allocation::arena);
+        xlnt_assert_equals(copied.active_sheet().cell_allocation(), xlnt::cell_allocation::arena);
+        xlnt_assert_equals(copied.active_sheet().cell("C100").value<std::string>(), "text 105");
+
+        wb.clear();
+        xlnt_assert_equals(wb.cell_allocation(), xlnt::cell_allocation::arena);
+    }
 };
 static workbook_test_suite x;
@@ -21,8 +21,11 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <limits>
+
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/hyperlink.hpp>
+#include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/header_footer.hpp>
@@ -106,11 +109,20 @@ public:
         register_test(test_insert_columns);
         register_test(test_delete_rows);
         register_test(test_delete_columns);
+        register_test(test_insert_delete_keep_handles);
+        register_test(test_find_cell);
+        register_test(test_auto_garbage_collect);
         register_test(test_insert_too_many);
         register_test(test_insert_delete_moves_merges);
         register_test(test_hidden_sheet);
         register_test(test_xlsm_read_write);
         register_test(test_issue_484);
+        register_test(test_cell_handles_survive_insertion);
+        register_test(test_dimension_after_removal);
+        register_test(test_append_row);
+        register_test(test_write_block);
+        register_test(test_read_column);
+        register_test(test_read_block);
     }
 
     void test_new_worksheet()
@@ -1491,6 +1503,118 @@ public:
         }
     }
 
+    void test_insert_delete_keep_handles()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("a");
+        ws.cell("C5").value("c");
+        ws.cell("E9").value("e");
+        auto moved = ws.cell("C5");
+
+        ws.insert_rows(3, 2);
+        xlnt_assert_equals(moved.reference(), "C7");
+        xlnt_assert_equals(ws.cell("E11").value<std::string>(), "e");
+        xlnt_assert_equals(ws.cell("A1").value<std::string>(), "a");
+
+        ws.insert_columns(2, 1);
+        xlnt_assert_equals(moved.reference(), "D7");
+        xlnt_assert_equals(ws.cell("D7").value<std::string>(), "c");
+
+        ws.delete_columns(1, 1);
+        xlnt_assert_equals(moved.reference(), "C7");
+        xlnt_assert(!ws.has_cell("A1"));
+        xlnt_assert_equals(ws.calculate_dimension(), "C7:E11");
+
+        ws.delete_rows(1, 8);
+        xlnt_assert_equals(ws.cell("E3").value<std::string>(), "e");
+        xlnt_assert_equals(ws.calculate_dimension(), "E3:E3");
+    }
+
+    void test_find_cell()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("B2").value(3);
+
+        xlnt_assert(!ws.find_cell("A1").is_set());
+        xlnt_assert(!ws.has_cell("A1"));
+        xlnt_assert_equals(ws.find_cell("B2").get().value<int>(), 3);
+
+        const auto const_ws = ws;
+        xlnt_assert(const_ws.find_cell("B2").is_set());
+        xlnt_assert(!const_ws.find_cell("C3").is_set());
+    }
+
+    void test_auto_garbage_collect()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1");
+        ws.cell("A2").value(2);
+        ws.cell("A3").formula("=A2");
+        ws.cell("A4").value(4);
+        ws.cell("A4").number_format(xlnt::number_format::percentage());
+
+        xlnt_assert(!ws.auto_garbage_collect());
+        ws.auto_garbage_collect(true);
+        xlnt_assert(ws.auto_garbage_collect());
+        xlnt_assert(!ws.has_cell("A1"));
+
+        ws.cell("A2").clear_value();
+        xlnt_assert(!ws.has_cell("A2"));
+
+        ws.cell("A3").clear_formula();
+        xlnt_assert(!ws.has_cell("A3"));
+
+        ws.cell("A4").clear_value();
+        xlnt_assert(ws.has_cell("A4"));
+        ws.cell("A4").clear_format();
+        xlnt_assert(!ws.has_cell("A4"));
+
+        // a handle kept across the removal writes to its own cell, not to
+        // whichever cell is created next
+        auto kept = ws.cell("B1");
+        kept.value(1);
+        kept.clear_value();
+        xlnt_assert(!ws.has_cell("B1"));
+        kept.value(42);
+        xlnt_assert(!ws.cell("C7").has_value());
+        xlnt_assert_equals(ws.cell("B1").value<int>(), 42);
+
+        kept.clear_value();
+        xlnt_assert(!ws.has_cell("B1"));
+        kept.value(43);
+        xlnt_assert(ws.has_cell("B1"));
+        xlnt_assert_equals(kept.value<int>(), 43);
+
+        auto formatted = ws.cell("C2");
+        formatted.value(3);
+        formatted.clear_value();
+        xlnt_assert(!ws.has_cell("C2"));
+        formatted.number_format(xlnt::number_format::percentage());
+        xlnt_assert(ws.has_cell("C2"));
+
+        auto dropped = ws.cell("B2");
+        dropped.value(2);
+        dropped.clear_value();
+        ws.garbage_collect();
+        xlnt_assert(!ws.has_cell("B2"));
+
+        ws.auto_garbage_collect(false);
+        ws.cell("A5").value(5);
+        ws.cell("A5").clear_value();
+        xlnt_assert(ws.has_cell("A5"));
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt::workbook loaded;
+        loaded.load(data);
+        xlnt_assert_equals(loaded.active_sheet().cell("B1").value<int>(), 43);
+        xlnt_assert(loaded.active_sheet().has_cell("C2"));
+        xlnt_assert(!loaded.active_sheet().has_cell("B2"));
+    }
+
     void test_delete_columns()
     {
         xlnt::workbook wb;
@@ -1674,6 +1798,159 @@ public:
         xlnt_assert_equals("B12:B12", ws.columns(true).reference());
         xlnt_assert_equals("A1:B12", ws.columns(false).reference());
     }
+
+    void test_cell_handles_survive_insertion()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        auto first = ws.cell("C3");
+        first.value(42);
+
+        // insert around the first cell, out of order, to force rows and columns to shift
+        for (xlnt::row_t row = 500; row >= 1; --row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 10; column += 3)
+            {
+                ws.cell(xlnt::cell_reference(column, row)).value(static_cast<int>(row * column));
+            }
+        }
+
+        xlnt_assert_equals(first.value<int>(), 42);
+        xlnt_assert_equals(ws.cell("C3").value<int>(), 42);
+        xlnt_assert_equals(ws.highest_row(), 500);
+        xlnt_assert_equals(ws.highest_column(), xlnt::column_t("J"));
+
+        ws.clear_cell("C3");
+        xlnt_assert(!ws.has_cell("C3"));
+        xlnt_assert(ws.has_cell("D3"));
+
+        ws.clear_row(3);
+        xlnt_assert(!ws.has_cell("D3"));
+        xlnt_assert_equals(ws.lowest_row(), 1);
+        xlnt_assert_equals(ws.cell("J500").value<int>(), 5000);
+    }
+
+    void test_dimension_after_removal()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("B2").value(1);
+        ws.cell("E3").value(2);
+        ws.cell("C7").value(3);
+        ws.row_properties(9).height = 20;
+        xlnt_assert_equals(ws.calculate_dimension(), "B2:E9");
+
+        ws.clear_cell("E3");
+        xlnt_assert_equals(ws.calculate_dimension(), "B2:C9");
+        xlnt_assert_equals(ws.highest_column(), xlnt::column_t("C"));
+
+        ws.clear_row(9);
+        xlnt_assert_equals(ws.calculate_dimension(), "B2:C7");
+
+        ws.cell("A4");
+        ws.garbage_collect();
+        xlnt_assert_equals(ws.lowest_column(), xlnt::column_t("B"));
+
+        ws.insert_rows(1, 2);
+        xlnt_assert_equals(ws.calculate_dimension(), "B4:C9");
+
+        ws.delete_columns(1, 1);
+        xlnt_assert_equals(ws.calculate_dimension(), "A4:B9");
+    }
+
+    void test_append_row()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        xlnt_assert_equals(ws.append_row(std::vector<double>{1.5, 2, 3}), 1);
+        xlnt_assert_equals(ws.append_row(std::vector<std::string>{"a", "b"}), 2);
+        xlnt_assert_equals(ws.append_row(std::vector<xlnt::variant>{xlnt::variant(4), xlnt::variant(), xlnt::variant("c"), xlnt::variant(true)}), 3);
+
+        xlnt_assert_equals(ws.cell("A1").value<double>(), 1.5);
+        xlnt_assert_equals(ws.cell("C1").value<int>(), 3);
+        xlnt_assert_equals(ws.cell("B2").value<std::string>(), "b");
+        xlnt_assert_equals(ws.cell("B2").data_type(), xlnt::cell::type::shared_string);
+        xlnt_assert_equals(ws.cell("A3").value<int>(), 4);
+        xlnt_assert(!ws.has_cell("B3"));
+        xlnt_assert_equals(ws.cell("C3").value<std::string>(), "c");
+        xlnt_assert(ws.cell("D3").value<bool>());
+        xlnt_assert_equals(ws.calculate_dimension(), "A1:D3");
+
+        xlnt_assert_throws(ws.append_row(std::vector<xlnt::variant>{xlnt::variant({1, 2})}), xlnt::invalid_parameter);
+    }
+
+    void test_write_block()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("C2").value("existing");
+        ws.cell("F3").value(99);
+
+        const std::vector<double> values{1, 2, 3, 4, 5, 6, 7, 8, 9};
+        ws.write_block("B2", 3, 3, values.data());
+
+        // existing cells inside the block are overwritten, those outside are kept
+        xlnt_assert_equals(ws.cell("B2").value<int>(), 1);
+        xlnt_assert_equals(ws.cell("C2").value<int>(), 2);
+        xlnt_assert_equals(ws.cell("D3").value<int>(), 6);
+        xlnt_assert_equals(ws.cell("D4").value<int>(), 9);
+        xlnt_assert_equals(ws.cell("F3").value<int>(), 99);
+        xlnt_assert_equals(ws.calculate_dimension(), "B2:F4");
+
+        const std::vector<std::string> strings{"x", "y"};
+        ws.write_block("A6", 2, 1, strings.data());
+        xlnt_assert_equals(ws.cell("A7").value<std::string>(), "y");
+
+        const auto last_row = std::numeric_limits<xlnt::row_t>::max();
+        xlnt_assert_throws(ws.write_block(xlnt::cell_reference(1, last_row), 2, 1, values.data()), xlnt::invalid_parameter);
+    }
+
+    void test_read_column()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("B2").value(1.5);
+        ws.cell("B3").value("text");
+        ws.cell("B5").value(4);
+        ws.cell("C4").value(7);
+
+        std::vector<double> values(5);
+        std::uint8_t valid = 0xff;
+        xlnt_assert_equals(ws.read_column(2, 1, 5, values.data(), -1.0, &valid), 2);
+        xlnt_assert_equals(values, (std::vector<double>{-1.0, 1.5, -1.0, -1.0, 4.0}));
+        xlnt_assert_equals(valid, 0x12);
+
+        std::vector<std::string> strings(3);
+        xlnt_assert_equals(ws.read_column(2, 2, 4, strings.data(), std::string("-")), 1);
+        xlnt_assert_equals(strings, (std::vector<std::string>{"-", "text", "-"}));
+
+        xlnt_assert_throws(ws.read_column(2, 5, 4, values.data(), 0.0), xlnt::invalid_parameter);
+    }
+
+    void test_read_block()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        const std::vector<double> block{1, 2, 3, 4, 5, 6, 7, 8, 9};
+        ws.write_block("B2", 3, 3, block.data());
+        ws.cell("C3").value(true);
+        ws.cell("Z3").value(100);
+
+        std::vector<int> values(12);
+        std::vector<std::uint8_t> valid(2);
+        xlnt_assert_equals(ws.read_block(xlnt::range_reference("A2:D4"), values.data(), 0, valid.data()), 8);
+        xlnt_assert_equals(values, (std::vector<int>{0, 1, 2, 3, 0, 4, 0, 6, 0, 7, 8, 9}));
+        xlnt_assert_equals(valid[0], 0xae);
+        xlnt_assert_equals(valid[1], 0x0e);
+
+        bool flag = false;
+        xlnt_assert_equals(ws.read_block(xlnt::range_reference("C3:C3"), &flag, false), 1);
+        xlnt_assert(flag);
+    }
 };
 
 static worksheet_test_suite x;